@@ -0,0 +1,242 @@
+#ifndef EKAT_BANDED_HPP
+#define EKAT_BANDED_HPP
+
+#include "ekat_tridiag.hpp"
+
+#include <cassert>
+
+namespace ekat {
+namespace banded {
+
+/* Team-level solvers for diagonally dominant, scalar banded systems.
+
+   This file is a header-only library to solve the equation
+       A x = b,
+   where A is a scalar, banded, diagonally dominant matrix with KL diagonals
+   below and KU diagonals above the main one (e.g., KL = KU = 2 for the
+   pentadiagonal matrices of higher-order vertical schemes), within a Kokkos
+   team. KL and KU are template parameters, so the loops over the band are
+   resolved at compile time. The library follows the conventions of
+   ekat_tridiag.hpp, and supports the same three problem formats:
+       1. A x = b: 1 matrix A, one L,RHS x, b;
+       2. A X = B: 1 matrix A, multiple L,RHS X, B;
+       3. A_i x_i = b_i, i = 1..n: Multiple matrices A, each associated with 1
+          L,RHS x, b.
+
+   The nxn matrix A is stored by diagonals in the array A(KL+KU+1, n), rather
+   than in separate dl, d, du arrays. Using 0-based indexing, the entry (i,i+k),
+   -KL <= k <= KU, is in A(KL+k, i); i.e., as in the tridiag format, the
+   entries of row i are in A(:,i). In particular, for KL = KU = 1, A(0,:),
+   A(1,:), A(2,:) are dl, d, du. The entries of A outside the matrix (e.g.,
+   A(0,0)) are not used. In problem format 3, matrix p is stored in A(:,:,p).
+
+   In problem formats 2, 3, the i'th L,RHS in X, B is stored as X(:,i),
+   B(:,i). Otherwise, X(:) = x, B(:) = b.
+
+   As in ekat_tridiag.hpp, arrays must have layout LayoutRight (or LayoutLeft if
+   rank 1), the value type of X can differ from that of A, and Pack value types
+   are supported. In problem format 3, the systems are independent, and the
+   team's threads and vector lanes are split over them; to solve the systems of
+   ncol physics columns at once, interleave the columns into the lanes of an
+   ekat::Pack<scalar_type, N>, column k in lane k % N of pack k / N.
+
+   The solver is Gaussian elimination without pivoting, so there is no fill-in
+   outside the band. In all functions, X = B on input and X = A \ B on output,
+   and A is overwritten.
+
+        template <int KL, int KU, typename TeamMember, typename BandArray,
+                  typename DataArray>
+        void solve(const TeamMember& team, BandArray A, DataArray X);
+
+   To solve with the same matrices many times, factor once and solve with the
+   factors. factor overwrites A with the multipliers of the elimination, in the
+   lower band, and the reciprocals of the pivots, in the main diagonal, and ends
+   with a team barrier.
+
+        template <int KL, int KU, typename TeamMember, typename BandArray>
+        void factor(const TeamMember& team, BandArray A);
+
+        template <int KL, int KU, typename TeamMember, typename BandArray,
+                  typename DataArray>
+        void solve_factored(const TeamMember& team, BandArray A, DataArray X);
+
+   pentadiag(team, A, X) is solve<2,2>(team, A, X).
+ */
+
+namespace impl {
+
+using tridiag::impl::EnableIfCanUsePointer;
+
+// Factor the band matrix whose entry (i,i+k) is a[((KL+k)*nrow + i)*s].
+template <int KL, int KU, typename AT>
+KOKKOS_INLINE_FUNCTION
+void factor (AT* a, const int nrow, const int s) {
+  using Scalar = typename std::remove_const<AT>::type;
+  const auto e = [&] (const int i, const int k) -> AT& { return a[((KL+k)*nrow + i)*s]; };
+  for (int i = 0; i < nrow; ++i) {
+    const Scalar p = Scalar(1)/e(i,0);
+    e(i,0) = p;
+    for (int r = 1; r <= KL && i+r < nrow; ++r) {
+      const Scalar m = e(i+r,-r)*p;
+      e(i+r,-r) = m;
+      for (int c = 1; c <= KU && i+c < nrow; ++c)
+        e(i+r,c-r) -= m*e(i,c);
+    }
+  }
+}
+
+// Solve with the factors from factor. Entry i of X is at [i*sx].
+template <int KL, int KU, typename AT, typename XT>
+KOKKOS_INLINE_FUNCTION
+void solve_factored (const AT* a, const int nrow, const int s, XT* X, const int sx) {
+  using XS = typename std::remove_const<XT>::type;
+  const auto e = [&] (const int i, const int k) -> const AT& {
+    return a[((KL+k)*nrow + i)*s];
+  };
+  for (int i = 1; i < nrow; ++i) {
+    XS v = X[i*sx];
+    for (int r = 1; r <= KL && r <= i; ++r)
+      v -= e(i,-r)*X[(i-r)*sx];
+    X[i*sx] = v;
+  }
+  for (int i = nrow-1; i >= 0; --i) {
+    XS v = X[i*sx];
+    for (int c = 1; c <= KU && i+c < nrow; ++c)
+      v -= e(i,c)*X[(i+c)*sx];
+    X[i*sx] = v*e(i,0);
+  }
+}
+
+} // namespace impl
+
+template <int KL, int KU, typename TeamMember, typename BandArray>
+KOKKOS_INLINE_FUNCTION
+void factor (const TeamMember& team, BandArray A,
+             typename std::enable_if<BandArray::rank == 2>::type* = 0,
+             impl::EnableIfCanUsePointer<BandArray>* = 0) {
+  assert(A.extent_int(0) == KL+KU+1);
+  Kokkos::single(Kokkos::PerTeam(team), [&] () {
+    impl::factor<KL,KU>(A.data(), A.extent_int(1), 1);
+  });
+  team.team_barrier();
+}
+
+template <int KL, int KU, typename TeamMember, typename BandArray>
+KOKKOS_INLINE_FUNCTION
+void factor (const TeamMember& team, BandArray A,
+             typename std::enable_if<BandArray::rank == 3>::type* = 0,
+             impl::EnableIfCanUsePointer<BandArray>* = 0) {
+  assert(A.extent_int(0) == KL+KU+1);
+  const int nrow = A.extent_int(1);
+  const int nprob = A.extent_int(2);
+  const auto f = [&] (const int& j) {
+    impl::factor<KL,KU>(A.data() + j, nrow, nprob);
+  };
+  Kokkos::parallel_for(Kokkos::TeamVectorRange(team, nprob), f);
+  team.team_barrier();
+}
+
+template <int KL, int KU, typename TeamMember, typename BandArray, typename DataArray>
+KOKKOS_INLINE_FUNCTION
+void solve_factored (const TeamMember& team, BandArray A, DataArray X,
+                     typename std::enable_if<BandArray::rank == 2>::type* = 0,
+                     typename std::enable_if<DataArray::rank == 1>::type* = 0,
+                     impl::EnableIfCanUsePointer<BandArray>* = 0,
+                     impl::EnableIfCanUsePointer<DataArray>* = 0) {
+  const int nrow = A.extent_int(1);
+  assert(A.extent_int(0) == KL+KU+1);
+  assert(X.extent_int(0) == nrow);
+  Kokkos::single(Kokkos::PerTeam(team), [&] () {
+    impl::solve_factored<KL,KU>(A.data(), nrow, 1, X.data(), 1);
+  });
+}
+
+template <int KL, int KU, typename TeamMember, typename BandArray, typename DataArray>
+KOKKOS_INLINE_FUNCTION
+void solve_factored (const TeamMember& team, BandArray A, DataArray X,
+                     typename std::enable_if<BandArray::rank == 2>::type* = 0,
+                     typename std::enable_if<DataArray::rank == 2>::type* = 0,
+                     impl::EnableIfCanUsePointer<BandArray>* = 0,
+                     impl::EnableIfCanUsePointer<DataArray>* = 0) {
+  const int nrow = A.extent_int(1);
+  const int nrhs = X.extent_int(1);
+  assert(A.extent_int(0) == KL+KU+1);
+  assert(X.extent_int(0) == nrow);
+  const auto f = [&] (const int& j) {
+    impl::solve_factored<KL,KU>(A.data(), nrow, 1, X.data() + j, nrhs);
+  };
+  Kokkos::parallel_for(Kokkos::TeamVectorRange(team, nrhs), f);
+}
+
+template <int KL, int KU, typename TeamMember, typename BandArray, typename DataArray>
+KOKKOS_INLINE_FUNCTION
+void solve_factored (const TeamMember& team, BandArray A, DataArray X,
+                     typename std::enable_if<BandArray::rank == 3>::type* = 0,
+                     typename std::enable_if<DataArray::rank == 2>::type* = 0,
+                     impl::EnableIfCanUsePointer<BandArray>* = 0,
+                     impl::EnableIfCanUsePointer<DataArray>* = 0) {
+  const int nrow = A.extent_int(1);
+  const int nprob = A.extent_int(2);
+  assert(A.extent_int(0) == KL+KU+1);
+  assert(X.extent_int(0) == nrow && X.extent_int(1) == nprob);
+  const auto f = [&] (const int& j) {
+    impl::solve_factored<KL,KU>(A.data() + j, nrow, nprob, X.data() + j, nprob);
+  };
+  Kokkos::parallel_for(Kokkos::TeamVectorRange(team, nprob), f);
+}
+
+template <int KL, int KU, typename TeamMember, typename BandArray, typename DataArray>
+KOKKOS_INLINE_FUNCTION
+void solve (const TeamMember& team, BandArray A, DataArray X,
+            typename std::enable_if<BandArray::rank == 2>::type* = 0,
+            typename std::enable_if<DataArray::rank == 1>::type* = 0,
+            impl::EnableIfCanUsePointer<BandArray>* = 0,
+            impl::EnableIfCanUsePointer<DataArray>* = 0) {
+  const int nrow = A.extent_int(1);
+  assert(A.extent_int(0) == KL+KU+1);
+  assert(X.extent_int(0) == nrow);
+  Kokkos::single(Kokkos::PerTeam(team), [&] () {
+    impl::factor<KL,KU>(A.data(), nrow, 1);
+    impl::solve_factored<KL,KU>(A.data(), nrow, 1, X.data(), 1);
+  });
+}
+
+template <int KL, int KU, typename TeamMember, typename BandArray, typename DataArray>
+KOKKOS_INLINE_FUNCTION
+void solve (const TeamMember& team, BandArray A, DataArray X,
+            typename std::enable_if<BandArray::rank == 2>::type* = 0,
+            typename std::enable_if<DataArray::rank == 2>::type* = 0,
+            impl::EnableIfCanUsePointer<BandArray>* = 0,
+            impl::EnableIfCanUsePointer<DataArray>* = 0) {
+  factor<KL,KU>(team, A);
+  solve_factored<KL,KU>(team, A, X);
+}
+
+template <int KL, int KU, typename TeamMember, typename BandArray, typename DataArray>
+KOKKOS_INLINE_FUNCTION
+void solve (const TeamMember& team, BandArray A, DataArray X,
+            typename std::enable_if<BandArray::rank == 3>::type* = 0,
+            typename std::enable_if<DataArray::rank == 2>::type* = 0,
+            impl::EnableIfCanUsePointer<BandArray>* = 0,
+            impl::EnableIfCanUsePointer<DataArray>* = 0) {
+  const int nrow = A.extent_int(1);
+  const int nprob = A.extent_int(2);
+  assert(A.extent_int(0) == KL+KU+1);
+  assert(X.extent_int(0) == nrow && X.extent_int(1) == nprob);
+  const auto f = [&] (const int& j) {
+    impl::factor<KL,KU>(A.data() + j, nrow, nprob);
+    impl::solve_factored<KL,KU>(A.data() + j, nrow, nprob, X.data() + j, nprob);
+  };
+  Kokkos::parallel_for(Kokkos::TeamVectorRange(team, nprob), f);
+}
+
+template <typename TeamMember, typename BandArray, typename DataArray>
+KOKKOS_INLINE_FUNCTION
+void pentadiag (const TeamMember& team, BandArray A, DataArray X) {
+  solve<2,2>(team, A, X);
+}
+
+} // namespace banded
+} // namespace ekat
+
+#endif // EKAT_BANDED_HPP
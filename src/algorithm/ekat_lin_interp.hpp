@@ -32,6 +32,7 @@ namespace ekat {
     });
 
   Note: testing has shown that LinInterp runs better on SKX with pack_size=1.
+        Use PackSizeTuner (see ekat_pack_tuner.hpp) to pick the pack size at runtime.
 
  */
 
@@ -131,22 +131,16 @@ void LinInterp<ScalarT, PackSize, DeviceT>::lin_interp_impl(
     }
 
     // Eval x1 and y1 at k1 and k1+h
-    // NOTE: 4 separate loops seem to be a few % better. Might have something to do with loop unrolling
-    //       Also, using vector_simd deteriorates performance by >10%. That's not too surprising,
-    //       considering that we are accessing non-contiguous memory. SIMD *forces* the compiler to
-    //       vectorize, even if it would deem the vectorization inefficient
-    for (int i=0; i<N; ++i) {
-      x1_k1[i] = x1s(k1[i]);
-    }
-    for (int i=0; i<N; ++i) {
-      y1_k1[i] = y1s(k1[i]);
-    }
-    for (int i=0; i<N; ++i) {
-      x1_k1ph[i] = x1s(k1ph[i]);
-    }
-    for (int i=0; i<N; ++i) {
-      y1_k1ph[i] = y1s(k1ph[i]);
-    }
+    // NOTE: 4 separate loads seem to be a few % better. Might have something to do with loop unrolling.
+    //       ekat::index reads contiguous indices (e.g., when x1 and x2 have the same spacing)
+    //       with a single vector load. Otherwise, it gathers the values, but does NOT force
+    //       the compiler to vectorize the gather (which deteriorates performance by >10%,
+    //       considering that we are accessing non-contiguous memory), unless the explicit-SIMD
+    //       backend provides hardware gather instructions.
+    x1_k1   = ekat::index(x1s, k1);
+    y1_k1   = ekat::index(y1s, k1);
+    x1_k1ph = ekat::index(x1s, k1ph);
+    y1_k1ph = ekat::index(y1s, k1ph);
 
     // Apply linear interpolation formula. Use multiple statements with op= to minimize temporaries
     auto& y2_k2 = y2(k2);
@@ -111,11 +111,9 @@ auto view_reduction (const TeamMember& team,
     // If first pack has garbage, we will not include it in the below reduction,
     // so manually add the first pack (only the non-garbage part)
     if (has_garbage_begin) {
-      const auto temp_input = input(pack_loop_begin-1);
+      const PackType temp_input = input(pack_loop_begin-1);
       const int first_indx = begin % N;
-      for (int j=first_indx; j<N; ++j) {
-        result += temp_input[j];
-      }
+      result += ekat::reduce_sum<false>(range<PackType>(0) >= first_indx, temp_input);
     }
 
     // Complete packs to be reduced. If Serialize, reduce each pack first, then
@@ -135,9 +133,7 @@ auto view_reduction (const TeamMember& team,
     if (has_garbage_end) {
       const PackType temp_input = input(pack_loop_end);
       const int last_indx = end % N;
-      for (int j=0; j<last_indx; ++j) {
-        result += temp_input[j];
-      }
+      result += ekat::reduce_sum<false>(range<PackType>(0) < last_indx, temp_input);
     }
   }
   return result;
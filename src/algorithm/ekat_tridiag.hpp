@@ -54,6 +54,15 @@ namespace tridiag {
         void thomas(const TeamMember& team,
                     TridiagDiag dl, TridiagDiag d, TridiagDiag du, DataArray X);
 
+      In problem format 3, the systems are independent, and the team's threads
+      and vector lanes are split over them. This is the batched form of the
+      solver: to solve the systems of ncol physics columns at once, interleave
+      the columns into the lanes of an ekat::Pack<scalar_type, N>, column k
+      going to lane k % N of pack k / N, so that (dl, d, du, X) all have extents
+      (nrow, ekat::npack<Pack>(ncol)). Then each step of the Thomas recurrence
+      is vectorized across columns, rather than across L,RHS as in problem
+      format 2. Lanes past ncol must hold nonsingular systems (e.g., d = 1).
+
    b. Use the Thomas algorithm to solve the problem in serial. Here no reference
       is made to Kokkos parallel constructs. The call must be protected by
       Kokkos::single(Kokkos::PerTeam).
@@ -68,16 +77,93 @@ namespace tridiag {
         void cr(const TeamMember& team,
                 TridiagDiag dl, TridiagDiag d, TridiagDiag du, DataArray X);
 
+   d. Partitioned Thomas algorithm at the Kokkos team level. The rows are split
+      into one contiguous block per thread, and each thread eliminates within
+      its block, which leaves a tridiagonal system in the first and last
+      unknowns of the blocks. One thread solves this system, of size twice the
+      number of threads, and then each thread recovers the unknowns inside its
+      block. Unlike cr, which has two team barriers per level, it has three
+      team barriers in all, the last one before returning, as in cr. Problem
+      formats 1 and 2 are supported.
+
+        template <typename TeamMember, typename TridiagDiag, typename DataArray>
+        void partitioned_thomas(const TeamMember& team,
+                                TridiagDiag dl, TridiagDiag d, TridiagDiag du,
+                                DataArray X);
+
    In practice, (a, b) are used on a non-GPU computer, and (c) is used on the
    GPU. On a non-GPU computer, the typical use case is that a team has just one
    thread. On a GPU, the typical use case is that a team has 128 to 1024 threads
-   (4 to 32 warps).
+   (4 to 32 warps). (d) is for a non-GPU computer with teams of a few (2 to 16)
+   threads, when the columns are long enough (nrow of several hundreds) that
+   several cores per column pay off.
 
    On a non-GPU computer, in the case of multiple A or L,RHS per team,
    ekat::pack::Pack may be used as the value type. On GPU, as usual, only
    ekat::pack::Pack<scalar_type, 1> makes sense, so it also likely makes sense
    that the value type is just the POD (plain-old data) scalar_type.
 
+   When the same matrix is used in several solves (e.g., an implicit vertical
+   diffusion matrix applied to many tracers, or over several substeps), factor
+   it once and then solve with the factors, which skips all the divisions but
+   one per row:
+
+        template <typename TeamMember, typename TridiagDiag>
+        void thomas_factor(const TeamMember& team,
+                           TridiagDiag dl, TridiagDiag d, TridiagDiag du);
+
+        template <typename TeamMember, typename TridiagDiag, typename DataArray>
+        void thomas_solve_factored(const TeamMember& team,
+                                   TridiagDiag dl, TridiagDiag d, TridiagDiag du,
+                                   DataArray X);
+
+   thomas_factor overwrites dl with the LU multipliers and d with the
+   reciprocals of the pivots, leaving du unchanged; all three problem formats
+   are supported. The cyclic reduction analogue, for problem formats 1 and 2,
+   also stores the reduction coefficients, in an array f of the same value type
+   as d and of extent at least cr_factor_size(nrow):
+
+        int cr_factor_size(const int nrow);
+
+        template <typename TeamMember, typename TridiagDiag, typename CoefArray>
+        void cr_factor(const TeamMember& team,
+                       TridiagDiag dl, TridiagDiag d, TridiagDiag du, CoefArray f);
+
+        template <typename TeamMember, typename TridiagDiag, typename CoefArray,
+                  typename DataArray>
+        void cr_solve_factored(const TeamMember& team,
+                               TridiagDiag dl, TridiagDiag d, TridiagDiag du,
+                               CoefArray f, DataArray X);
+
+   The factors of one algorithm cannot be used in the solve of the other. Both
+   factor functions end with a team barrier, so the solve can follow directly.
+
+   Two variants of the matrix structure are supported by the Thomas algorithm
+   at the Kokkos team level, in all three problem formats:
+
+     * Block tridiagonal matrices, with BxB blocks, B known at compile time
+       (e.g., the coupled equations of two or three fields). Block row i of
+       the matrix is in dl(i,:,:), d(i,:,:), du(i,:,:), and (in problem format
+       3) matrix p in dl(i,:,:,p), etc.; row i of the L,RHS is X(i,:), or
+       X(i,:,j) for L,RHS j in problem formats 2, 3. The diagonal blocks must
+       be invertible without pivoting, e.g., block diagonally dominant.
+
+        template <int B, typename TeamMember, typename TridiagDiag, typename DataArray>
+        void block_thomas(const TeamMember& team,
+                          TridiagDiag dl, TridiagDiag d, TridiagDiag du, DataArray X);
+
+     * Cyclic (periodic) tridiagonal matrices, where, using the otherwise
+       unused entries, dl(0) is the entry (0, nrow-1) and du(nrow-1) is the
+       entry (nrow-1, 0) of the matrix. The solver uses the Sherman-Morrison
+       formula, and needs a work array z with the shape of one L,RHS per matrix,
+       (nrow) or, in problem format 3, (nrow, nprob). nrow must be at least 2.
+
+        template <typename TeamMember, typename TridiagDiag, typename DataArray,
+                  typename WorkArray>
+        void cyclic_thomas(const TeamMember& team,
+                           TridiagDiag dl, TridiagDiag d, TridiagDiag du,
+                           DataArray X, WorkArray z);
+
    For BFB development work, there is a function
 
         template <typename TeamMember, typename TridiagDiag, typename DataArray>
@@ -87,7 +173,7 @@ namespace tridiag {
    it is not performant and should be used only when requiring answers to be
    BFB-identical across architectures.
 
-   The rest of this file contains implementation details. Each of (a, b, c) is
+   The rest of this file contains implementation details. Each of (a, b, c, d) is
    specialized to the various problem formats. This header documentation is the
    interface, and nothing further needs to be read.
 */
@@ -289,6 +375,363 @@ void thomas_amxm (DT* const dl, DT* d, DT* const du, XT* X,
   }
 }
 
+// Solve the system in column j of the (nrow, ncol) arrays of problem format 3.
+template <typename DT, typename XT>
+KOKKOS_INLINE_FUNCTION
+void thomas_amx1 (DT* const dl, DT* d, DT* const du, XT* X,
+                  const int nrow, const int ncol, const int j) {
+  for (int i = 1; i < nrow; ++i) {
+    const int ij = i*ncol + j;
+    const auto dlij = dl[ij] / d[ij-ncol];
+    d[ij] -= dlij * du[ij-ncol];
+    X[ij] -= dlij * X[ij-ncol];
+  }
+  X[(nrow-1)*ncol + j] /= d[(nrow-1)*ncol + j];
+  for (int i = nrow-1; i > 0; --i) {
+    const int ij = i*ncol + j;
+    X[ij-ncol] = (X[ij-ncol] - du[ij-ncol] * X[ij]) / d[ij-ncol];
+  }
+}
+
+// Factor the matrix whose rows are stride apart, storing the multipliers in dl
+// and the reciprocals of the pivots in d.
+template <typename DT>
+KOKKOS_INLINE_FUNCTION
+void thomas_factor_inv (DT* dl, DT* d, DT* const du, const int nrow, const int stride) {
+  using Scalar = typename std::remove_const<DT>::type;
+  d[0] = Scalar(1) / d[0];
+  for (int i = 1; i < nrow; ++i) {
+    const int k = i*stride;
+    dl[k] *= d[k-stride];
+    d[k] = Scalar(1) / (d[k] - dl[k] * du[k-stride]);
+  }
+}
+
+// Solve with the factors from thomas_factor_inv. The rows of the matrix are sa
+// apart, and those of X are sx apart.
+template <typename DT, typename XT>
+KOKKOS_INLINE_FUNCTION
+void thomas_solve_inv (const DT* dl, const DT* d, const DT* du, const int sa,
+                       XT* X, const int sx, const int nrow) {
+  for (int i = 1; i < nrow; ++i)
+    X[i*sx] -= dl[i*sa] * X[(i-1)*sx];
+  X[(nrow-1)*sx] *= d[(nrow-1)*sa];
+  for (int i = nrow-1; i > 0; --i)
+    X[(i-1)*sx] = (X[(i-1)*sx] - du[(i-1)*sa] * X[i*sx]) * d[(i-1)*sa];
+}
+
+// Invert in place the BxB matrix whose entry (r,c) is a[(r*B + c)*s], without
+// pivoting. The cases B <= 3 are unrolled by hand.
+template <int B, typename DT>
+KOKKOS_INLINE_FUNCTION
+void block_invert (DT* a, const int s) {
+  using Scalar = typename std::remove_const<DT>::type;
+  const auto e = [&] (const int r, const int c) -> DT& { return a[(r*B + c)*s]; };
+  if constexpr (B == 1) {
+    e(0,0) = Scalar(1)/e(0,0);
+  } else if constexpr (B == 2) {
+    const Scalar a00 = e(0,0), a01 = e(0,1), a10 = e(1,0), a11 = e(1,1);
+    const Scalar r = Scalar(1)/(a00*a11 - a01*a10);
+    e(0,0) =  r*a11; e(0,1) = -r*a01;
+    e(1,0) = -r*a10; e(1,1) =  r*a00;
+  } else if constexpr (B == 3) {
+    const Scalar
+      a00 = e(0,0), a01 = e(0,1), a02 = e(0,2),
+      a10 = e(1,0), a11 = e(1,1), a12 = e(1,2),
+      a20 = e(2,0), a21 = e(2,1), a22 = e(2,2);
+    const Scalar c00 = a11*a22 - a12*a21, c01 = a12*a20 - a10*a22, c02 = a10*a21 - a11*a20;
+    const Scalar r = Scalar(1)/(a00*c00 + a01*c01 + a02*c02);
+    e(0,0) = r*c00; e(0,1) = r*(a02*a21 - a01*a22); e(0,2) = r*(a01*a12 - a02*a11);
+    e(1,0) = r*c01; e(1,1) = r*(a00*a22 - a02*a20); e(1,2) = r*(a02*a10 - a00*a12);
+    e(2,0) = r*c02; e(2,1) = r*(a01*a20 - a00*a21); e(2,2) = r*(a00*a11 - a01*a10);
+  } else {
+    // Gauss-Jordan elimination.
+    Scalar m[B][B];
+    for (int r = 0; r < B; ++r)
+      for (int c = 0; c < B; ++c)
+        m[r][c] = e(r,c);
+    for (int k = 0; k < B; ++k) {
+      const Scalar p = Scalar(1)/m[k][k];
+      m[k][k] = 1;
+      for (int c = 0; c < B; ++c)
+        m[k][c] *= p;
+      for (int r = 0; r < B; ++r) {
+        if (r == k) continue;
+        const Scalar f = m[r][k];
+        m[r][k] = 0;
+        for (int c = 0; c < B; ++c)
+          m[r][c] -= f*m[k][c];
+      }
+    }
+    for (int r = 0; r < B; ++r)
+      for (int c = 0; c < B; ++c)
+        e(r,c) = m[r][c];
+  }
+}
+
+// Block version of thomas_factor_inv: dl gets the block multipliers and d the
+// inverses of the block pivots. Entry (r,c) of block row i is at
+// [((i*B + r)*B + c)*s].
+template <int B, typename DT>
+KOKKOS_INLINE_FUNCTION
+void block_thomas_factor_inv (DT* dl, DT* d, DT* const du, const int nrow, const int s) {
+  using Scalar = typename std::remove_const<DT>::type;
+  const int bs = B*B*s;
+  const auto e = [&] (DT* a, const int r, const int c) -> DT& { return a[(r*B + c)*s]; };
+  block_invert<B>(d, s);
+  for (int i = 1; i < nrow; ++i) {
+    DT* const li = dl + i*bs;
+    DT* const di = d + i*bs;
+    DT* const dim1 = d + (i-1)*bs;
+    DT* const uim1 = du + (i-1)*bs;
+    Scalar l[B][B];
+    for (int r = 0; r < B; ++r)
+      for (int c = 0; c < B; ++c) {
+        Scalar v = 0;
+        for (int k = 0; k < B; ++k)
+          v += e(li,r,k)*e(dim1,k,c);
+        l[r][c] = v;
+      }
+    for (int r = 0; r < B; ++r)
+      for (int c = 0; c < B; ++c) {
+        Scalar v = e(di,r,c);
+        for (int k = 0; k < B; ++k)
+          v -= l[r][k]*e(uim1,k,c);
+        e(di,r,c) = v;
+        e(li,r,c) = l[r][c];
+      }
+    block_invert<B>(di, s);
+  }
+}
+
+// Solve with the factors from block_thomas_factor_inv. The matrix entries are
+// sa apart, as s above, and entry r of row i of X is at [(i*B + r)*sx].
+template <int B, typename DT, typename XT>
+KOKKOS_INLINE_FUNCTION
+void block_thomas_solve_inv (const DT* dl, const DT* d, const DT* du, const int sa,
+                             XT* X, const int sx, const int nrow) {
+  using XS = typename std::remove_const<XT>::type;
+  const int bs = B*B*sa;
+  const auto e = [&] (const DT* a, const int r, const int c) -> const DT& {
+    return a[(r*B + c)*sa];
+  };
+  const auto x = [&] (const int i, const int r) -> XT& { return X[(i*B + r)*sx]; };
+  for (int i = 1; i < nrow; ++i)
+    for (int r = 0; r < B; ++r) {
+      XS v = x(i,r);
+      for (int k = 0; k < B; ++k)
+        v -= e(dl + i*bs,r,k)*x(i-1,k);
+      x(i,r) = v;
+    }
+  XS t[B];
+  for (int r = 0; r < B; ++r)
+    t[r] = x(nrow-1,r);
+  for (int r = 0; r < B; ++r) {
+    XS v = 0;
+    for (int k = 0; k < B; ++k)
+      v += e(d + (nrow-1)*bs,r,k)*t[k];
+    x(nrow-1,r) = v;
+  }
+  for (int i = nrow-1; i > 0; --i) {
+    for (int r = 0; r < B; ++r) {
+      XS v = x(i-1,r);
+      for (int k = 0; k < B; ++k)
+        v -= e(du + (i-1)*bs,r,k)*x(i,k);
+      t[r] = v;
+    }
+    for (int r = 0; r < B; ++r) {
+      XS v = 0;
+      for (int k = 0; k < B; ++k)
+        v += e(d + (i-1)*bs,r,k)*t[k];
+      x(i-1,r) = v;
+    }
+  }
+}
+
+// Factor the cyclic matrix whose rows are sa apart. By the Sherman-Morrison
+// formula, A = A' + u v^T, where A' is A without the corner entries and with
+// modified first and last diagonal entries, u = (g, 0, ..., 0, du(n-1)), and
+// v = (1, 0, ..., 0, dl(0)/g), with g = -d(0). A' is factored as in
+// thomas_factor_inv, z = A' \ u is stored in z (whose entries are sz apart),
+// and the corner entries, unused by the tridiagonal solve, are replaced by
+// v(n-1) and 1/(1 + v^T z).
+template <typename DT>
+KOKKOS_INLINE_FUNCTION
+void cyclic_thomas_factor_inv (DT* dl, DT* d, DT* du, DT* z,
+                               const int nrow, const int sa, const int sz) {
+  using Scalar = typename std::remove_const<DT>::type;
+  const int l = (nrow-1)*sa;
+  const Scalar g = -d[0], alpha = du[l], beta = dl[0];
+  d[0] -= g;
+  d[l] -= alpha*beta/g;
+  thomas_factor_inv(dl, d, du, nrow, sa);
+  for (int i = 0; i < nrow; ++i)
+    z[i*sz] = 0;
+  z[0] = g;
+  z[(nrow-1)*sz] = alpha;
+  thomas_solve_inv(dl, d, du, sa, z, sz, nrow);
+  const Scalar v = beta/g;
+  dl[0] = v;
+  du[l] = Scalar(1)/(1 + z[0] + v*z[(nrow-1)*sz]);
+}
+
+// Solve with the factors from cyclic_thomas_factor_inv: X = y - (v^T y/(1 + v^T z)) z,
+// where y = A' \ X.
+template <typename DT, typename XT>
+KOKKOS_INLINE_FUNCTION
+void cyclic_thomas_solve_inv (const DT* dl, const DT* d, const DT* du, const DT* z,
+                              const int sa, const int sz, XT* X, const int sx,
+                              const int nrow) {
+  thomas_solve_inv(dl, d, du, sa, X, sx, nrow);
+  const auto c = (X[0] + dl[0]*X[(nrow-1)*sx])*du[(nrow-1)*sa];
+  for (int i = 0; i < nrow; ++i)
+    X[i*sx] -= c*z[i*sz];
+}
+
+// Solve with the factors from cr_factor. x(i,j) accesses row i of L,RHS j, so
+// that the same code serves rank-1 and rank-2 X. The threads are split over the
+// (row, L,RHS) pairs of each level.
+template <typename TeamMember, typename TridiagDiag, typename CoefArray, typename XAccess>
+KOKKOS_INLINE_FUNCTION
+void cr_solve_factored (const TeamMember& team,
+                        TridiagDiag dl, TridiagDiag d, TridiagDiag du, CoefArray f,
+                        const int nrow, const int nrhs, const XAccess& x) {
+  const int tid = impl::get_thread_id_within_team(team);
+  const int nthr = impl::get_team_nthr(team);
+  int os = 1, stride, fos = 0;
+  // Go down reduction, applying the stored coefficients.
+  while ((stride = (os << 1)) < nrow) {
+    const int nlev = (nrow + stride - 1)/stride;
+    for (int k = tid; k < nlev*nrhs; k += nthr) {
+      const int r = k / nrhs, j = k % nrhs;
+      const int i = r*stride;
+      // As in cr, the coefficient is 0 when the index is out of bounds.
+      const int im = i - os >= 0   ? i - os : i;
+      const int ip = i + os < nrow ? i + os : i;
+      x(i,j) += f(fos + 2*r)*x(im,j) + f(fos + 2*r + 1)*x(ip,j);
+    }
+    fos += 2*nlev;
+    os <<= 1;
+    team.team_barrier();
+  }
+  // Bottom of the reduction, with the inverse of the 1x1 or 2x2 matrix.
+  if (os >= nrow) {
+    for (int j = tid; j < nrhs; j += nthr)
+      x(0,j) *= d(0);
+  } else {
+    for (int j = tid; j < nrhs; j += nthr) {
+      const auto x0 = x(0,j), x1 = x(os,j);
+      x( 0,j) = d( 0)*x0 + du(0)*x1;
+      x(os,j) = dl(os)*x0 + d(os)*x1;
+    }
+  }
+  team.team_barrier();
+  os >>= 1;
+  // Go up reduction.
+  while (os) {
+    stride = os << 1;
+    const int nlev = (nrow - os + stride - 1)/stride;
+    for (int k = tid; k < nlev*nrhs; k += nthr) {
+      const int r = k / nrhs, j = k % nrhs;
+      const int i = r*stride + os;
+      const int ip = i + os;
+      auto xi = x(i,j) - dl(i)*x(i-os,j);
+      if (ip < nrow) xi -= du(i)*x(ip,j);
+      x(i,j) = xi*d(i);
+    }
+    os >>= 1;
+    team.team_barrier();
+  }
+}
+
+// Partitioned Thomas algorithm. x(i,j) accesses row i of L,RHS j, as in
+// cr_solve_factored.
+template <typename TeamMember, typename TridiagDiag, typename XAccess>
+KOKKOS_INLINE_FUNCTION
+void partitioned_thomas (const TeamMember& team,
+                         TridiagDiag dl, TridiagDiag d, TridiagDiag du,
+                         const int nrow, const int nrhs, const XAccess& x) {
+  using Scalar = typename TridiagDiag::non_const_value_type;
+  const int tid = impl::get_thread_id_within_team(team);
+  const int nthr = impl::get_team_nthr(team);
+  if (nrow == 1) {
+    if (tid == 0)
+      for (int j = 0; j < nrhs; ++j)
+        x(0,j) /= d(0);
+    team.team_barrier();
+    return;
+  }
+  // Each block has at least two rows, its first and last.
+  const int nblk = ekat::impl::min(nthr, nrow/2);
+  const auto first = [&] (const int b) { return (b*nrow)/nblk; };
+  if (tid < nblk) {
+    const int s = first(tid), e = first(tid+1) - 1;
+    // Go down the block, normalizing the diagonal, so that row i > s becomes
+    //     dl(i) x(s) + x(i) + du(i) x(i+1) = x(i).
+    for (int i = s; i <= s+1; ++i) {
+      const Scalar r = Scalar(1)/d(i);
+      dl(i) *= r;
+      du(i) *= r;
+      for (int j = 0; j < nrhs; ++j)
+        x(i,j) *= r;
+    }
+    for (int i = s+2; i <= e; ++i) {
+      const Scalar r = Scalar(1)/(d(i) - dl(i)*du(i-1));
+      for (int j = 0; j < nrhs; ++j)
+        x(i,j) = r*(x(i,j) - dl(i)*x(i-1,j));
+      du(i) *= r;
+      dl(i) = -r*dl(i)*dl(i-1);
+    }
+    // Go up the block, so that row s < i < e becomes
+    //     dl(i) x(s) + x(i) + du(i) x(e) = x(i),
+    // and row s becomes
+    //     dl(s) x(s-1) + x(s) + du(s) x(e) = x(s).
+    for (int i = e-2; i > s; --i) {
+      for (int j = 0; j < nrhs; ++j)
+        x(i,j) -= du(i)*x(i+1,j);
+      dl(i) -= du(i)*dl(i+1);
+      du(i) = -du(i)*du(i+1);
+    }
+    if (e > s+1) {
+      const Scalar r = Scalar(1)/(1 - du(s)*dl(s+1));
+      for (int j = 0; j < nrhs; ++j)
+        x(s,j) = r*(x(s,j) - du(s)*x(s+1,j));
+      dl(s) *= r;
+      du(s) = -r*du(s)*du(s+1);
+    }
+  }
+  team.team_barrier();
+  // The first and last rows of the blocks form a tridiagonal system with unit
+  // diagonal. Solve it with the Thomas algorithm, using d for the pivots.
+  if (tid == 0) {
+    const auto row = [&] (const int k) { return k % 2 == 0 ? first(k/2) : first(k/2+1) - 1; };
+    const int n = 2*nblk;
+    d(row(0)) = 1;
+    for (int k = 1; k < n; ++k) {
+      const int i = row(k), im = row(k-1);
+      const auto w = dl(i)/d(im);
+      d(i) = 1 - w*du(im);
+      for (int j = 0; j < nrhs; ++j)
+        x(i,j) -= w*x(im,j);
+    }
+    for (int j = 0; j < nrhs; ++j)
+      x(row(n-1),j) /= d(row(n-1));
+    for (int k = n-1; k > 0; --k) {
+      const int i = row(k), im = row(k-1);
+      for (int j = 0; j < nrhs; ++j)
+        x(im,j) = (x(im,j) - du(im)*x(i,j))/d(im);
+    }
+  }
+  team.team_barrier();
+  if (tid < nblk) {
+    const int s = first(tid), e = first(tid+1) - 1;
+    for (int i = s+1; i < e; ++i)
+      for (int j = 0; j < nrhs; ++j)
+        x(i,j) -= dl(i)*x(s,j) + du(i)*x(e,j);
+  }
+  team.team_barrier();
+}
+
 template <typename TridiagDiag>
 KOKKOS_INLINE_FUNCTION
 void bfb_thomas_factorize (TridiagDiag dl, TridiagDiag d, TridiagDiag du,
@@ -333,6 +776,32 @@ void thomas (const TeamMember& team,
   impl::thomas_solve(team, dl, d, du, X);
 }
 
+// Batched Thomas algorithm: the ncol = d.extent(1) independent systems of
+// problem format 3 are split over the team's threads and vector lanes. With
+// Pack value types, each entry of (dl, d, du, X) holds the rows of Pack::n
+// columns, so the recurrence runs on all of them at once.
+template <typename TeamMember, typename TridiagDiag, typename DataArray>
+KOKKOS_INLINE_FUNCTION
+void thomas (const TeamMember& team,
+             TridiagDiag dl, TridiagDiag d, TridiagDiag du, DataArray X,
+             typename std::enable_if<TridiagDiag::rank == 2>::type* = 0,
+             typename std::enable_if<DataArray::rank == 2>::type* = 0,
+             impl::EnableIfCanUsePointer<TridiagDiag>* = 0,
+             impl::EnableIfCanUsePointer<DataArray>* = 0) {
+  const int nrow = d.extent_int(0);
+  const int ncol = d.extent_int(1);
+  assert(X .extent_int(0) == nrow);
+  assert(dl.extent_int(0) == nrow);
+  assert(du.extent_int(0) == nrow);
+  assert(X .extent_int(1) == ncol);
+  assert(dl.extent_int(1) == ncol);
+  assert(du.extent_int(1) == ncol);
+  const auto f = [&] (const int& j) {
+    impl::thomas_amx1(dl.data(), d.data(), du.data(), X.data(), nrow, ncol, j);
+  };
+  Kokkos::parallel_for(Kokkos::TeamVectorRange(team, ncol), f);
+}
+
 template <typename TridiagDiag, typename DataArray>
 KOKKOS_INLINE_FUNCTION
 void thomas (TridiagDiag dl, TridiagDiag d, TridiagDiag du, DataArray X,
@@ -629,6 +1098,372 @@ void cr (const TeamMember& team,
   }
 }
 
+template <typename TeamMember, typename TridiagDiag, typename DataArray>
+KOKKOS_INLINE_FUNCTION
+void partitioned_thomas (const TeamMember& team,
+                         TridiagDiag dl, TridiagDiag d, TridiagDiag du, DataArray X,
+                         typename std::enable_if<TridiagDiag::rank == 1>::type* = 0,
+                         typename std::enable_if<DataArray::rank == 1>::type* = 0) {
+  const int nrow = d.extent_int(0);
+  assert(dl.extent_int(0) == nrow);
+  assert(du.extent_int(0) == nrow);
+  assert(X. extent_int(0) == nrow);
+  const auto x = [&] (const int& i, const int&) -> typename DataArray::reference_type {
+    return X(i);
+  };
+  impl::partitioned_thomas(team, dl, d, du, nrow, 1, x);
+}
+
+template <typename TeamMember, typename TridiagDiag, typename DataArray>
+KOKKOS_INLINE_FUNCTION
+void partitioned_thomas (const TeamMember& team,
+                         TridiagDiag dl, TridiagDiag d, TridiagDiag du, DataArray X,
+                         typename std::enable_if<TridiagDiag::rank == 1>::type* = 0,
+                         typename std::enable_if<DataArray::rank == 2>::type* = 0) {
+  const int nrow = d.extent_int(0);
+  assert(dl.extent_int(0) == nrow);
+  assert(du.extent_int(0) == nrow);
+  assert(X. extent_int(0) == nrow);
+  const auto x = [&] (const int& i, const int& j) -> typename DataArray::reference_type {
+    return X(i,j);
+  };
+  impl::partitioned_thomas(team, dl, d, du, nrow, X.extent_int(1), x);
+}
+
+template <int B, typename TeamMember, typename TridiagDiag, typename DataArray>
+KOKKOS_INLINE_FUNCTION
+void block_thomas (const TeamMember& team,
+                   TridiagDiag dl, TridiagDiag d, TridiagDiag du, DataArray X,
+                   typename std::enable_if<TridiagDiag::rank == 3>::type* = 0,
+                   typename std::enable_if<DataArray::rank == 2>::type* = 0,
+                   impl::EnableIfCanUsePointer<TridiagDiag>* = 0,
+                   impl::EnableIfCanUsePointer<DataArray>* = 0) {
+  const int nrow = d.extent_int(0);
+  assert(d .extent_int(1) == B && d.extent_int(2) == B);
+  assert(dl.extent_int(0) == nrow);
+  assert(du.extent_int(0) == nrow);
+  assert(X .extent_int(0) == nrow && X.extent_int(1) == B);
+  Kokkos::single(Kokkos::PerTeam(team), [&] () {
+    impl::block_thomas_factor_inv<B>(dl.data(), d.data(), du.data(), nrow, 1);
+    impl::block_thomas_solve_inv<B>(dl.data(), d.data(), du.data(), 1, X.data(), 1, nrow);
+  });
+}
+
+template <int B, typename TeamMember, typename TridiagDiag, typename DataArray>
+KOKKOS_INLINE_FUNCTION
+void block_thomas (const TeamMember& team,
+                   TridiagDiag dl, TridiagDiag d, TridiagDiag du, DataArray X,
+                   typename std::enable_if<TridiagDiag::rank == 3>::type* = 0,
+                   typename std::enable_if<DataArray::rank == 3>::type* = 0,
+                   impl::EnableIfCanUsePointer<TridiagDiag>* = 0,
+                   impl::EnableIfCanUsePointer<DataArray>* = 0) {
+  const int nrow = d.extent_int(0);
+  const int nrhs = X.extent_int(2);
+  assert(d .extent_int(1) == B && d.extent_int(2) == B);
+  assert(dl.extent_int(0) == nrow);
+  assert(du.extent_int(0) == nrow);
+  assert(X .extent_int(0) == nrow && X.extent_int(1) == B);
+  Kokkos::single(Kokkos::PerTeam(team), [&] () {
+    impl::block_thomas_factor_inv<B>(dl.data(), d.data(), du.data(), nrow, 1);
+  });
+  team.team_barrier();
+  const auto f = [&] (const int& j) {
+    impl::block_thomas_solve_inv<B>(dl.data(), d.data(), du.data(), 1,
+                                    X.data() + j, nrhs, nrow);
+  };
+  Kokkos::parallel_for(Kokkos::TeamVectorRange(team, nrhs), f);
+}
+
+template <int B, typename TeamMember, typename TridiagDiag, typename DataArray>
+KOKKOS_INLINE_FUNCTION
+void block_thomas (const TeamMember& team,
+                   TridiagDiag dl, TridiagDiag d, TridiagDiag du, DataArray X,
+                   typename std::enable_if<TridiagDiag::rank == 4>::type* = 0,
+                   typename std::enable_if<DataArray::rank == 3>::type* = 0,
+                   impl::EnableIfCanUsePointer<TridiagDiag>* = 0,
+                   impl::EnableIfCanUsePointer<DataArray>* = 0) {
+  const int nrow = d.extent_int(0);
+  const int nprob = d.extent_int(3);
+  assert(d .extent_int(1) == B && d.extent_int(2) == B);
+  assert(dl.extent_int(0) == nrow && dl.extent_int(3) == nprob);
+  assert(du.extent_int(0) == nrow && du.extent_int(3) == nprob);
+  assert(X .extent_int(0) == nrow && X.extent_int(1) == B);
+  assert(X .extent_int(2) == nprob);
+  const auto f = [&] (const int& j) {
+    impl::block_thomas_factor_inv<B>(dl.data() + j, d.data() + j, du.data() + j,
+                                     nrow, nprob);
+    impl::block_thomas_solve_inv<B>(dl.data() + j, d.data() + j, du.data() + j, nprob,
+                                    X.data() + j, nprob, nrow);
+  };
+  Kokkos::parallel_for(Kokkos::TeamVectorRange(team, nprob), f);
+}
+
+template <typename TeamMember, typename TridiagDiag, typename DataArray, typename WorkArray>
+KOKKOS_INLINE_FUNCTION
+void cyclic_thomas (const TeamMember& team,
+                    TridiagDiag dl, TridiagDiag d, TridiagDiag du, DataArray X,
+                    WorkArray z,
+                    typename std::enable_if<TridiagDiag::rank == 1>::type* = 0,
+                    typename std::enable_if<DataArray::rank == 1>::type* = 0,
+                    impl::EnableIfCanUsePointer<TridiagDiag>* = 0,
+                    impl::EnableIfCanUsePointer<DataArray>* = 0,
+                    impl::EnableIfCanUsePointer<WorkArray>* = 0) {
+  const int nrow = d.extent_int(0);
+  assert(nrow >= 2);
+  assert(dl.extent_int(0) == nrow);
+  assert(du.extent_int(0) == nrow);
+  assert( X.extent_int(0) == nrow);
+  assert( z.extent_int(0) == nrow);
+  Kokkos::single(Kokkos::PerTeam(team), [&] () {
+    impl::cyclic_thomas_factor_inv(dl.data(), d.data(), du.data(), z.data(), nrow, 1, 1);
+    impl::cyclic_thomas_solve_inv(dl.data(), d.data(), du.data(), z.data(), 1, 1,
+                                  X.data(), 1, nrow);
+  });
+}
+
+template <typename TeamMember, typename TridiagDiag, typename DataArray, typename WorkArray>
+KOKKOS_INLINE_FUNCTION
+void cyclic_thomas (const TeamMember& team,
+                    TridiagDiag dl, TridiagDiag d, TridiagDiag du, DataArray X,
+                    WorkArray z,
+                    typename std::enable_if<TridiagDiag::rank == 1>::type* = 0,
+                    typename std::enable_if<DataArray::rank == 2>::type* = 0,
+                    impl::EnableIfCanUsePointer<TridiagDiag>* = 0,
+                    impl::EnableIfCanUsePointer<DataArray>* = 0,
+                    impl::EnableIfCanUsePointer<WorkArray>* = 0) {
+  const int nrow = d.extent_int(0);
+  const int nrhs = X.extent_int(1);
+  assert(nrow >= 2);
+  assert(dl.extent_int(0) == nrow);
+  assert(du.extent_int(0) == nrow);
+  assert( X.extent_int(0) == nrow);
+  assert( z.extent_int(0) == nrow);
+  Kokkos::single(Kokkos::PerTeam(team), [&] () {
+    impl::cyclic_thomas_factor_inv(dl.data(), d.data(), du.data(), z.data(), nrow, 1, 1);
+  });
+  team.team_barrier();
+  const auto f = [&] (const int& j) {
+    impl::cyclic_thomas_solve_inv(dl.data(), d.data(), du.data(), z.data(), 1, 1,
+                                  X.data() + j, nrhs, nrow);
+  };
+  Kokkos::parallel_for(Kokkos::TeamVectorRange(team, nrhs), f);
+}
+
+template <typename TeamMember, typename TridiagDiag, typename DataArray, typename WorkArray>
+KOKKOS_INLINE_FUNCTION
+void cyclic_thomas (const TeamMember& team,
+                    TridiagDiag dl, TridiagDiag d, TridiagDiag du, DataArray X,
+                    WorkArray z,
+                    typename std::enable_if<TridiagDiag::rank == 2>::type* = 0,
+                    typename std::enable_if<DataArray::rank == 2>::type* = 0,
+                    impl::EnableIfCanUsePointer<TridiagDiag>* = 0,
+                    impl::EnableIfCanUsePointer<DataArray>* = 0,
+                    impl::EnableIfCanUsePointer<WorkArray>* = 0) {
+  const int nrow = d.extent_int(0);
+  const int nprob = d.extent_int(1);
+  assert(nrow >= 2);
+  assert(dl.extent_int(0) == nrow && dl.extent_int(1) == nprob);
+  assert(du.extent_int(0) == nrow && du.extent_int(1) == nprob);
+  assert( X.extent_int(0) == nrow &&  X.extent_int(1) == nprob);
+  assert( z.extent_int(0) == nrow &&  z.extent_int(1) == nprob);
+  const auto f = [&] (const int& j) {
+    impl::cyclic_thomas_factor_inv(dl.data() + j, d.data() + j, du.data() + j,
+                                   z.data() + j, nrow, nprob, nprob);
+    impl::cyclic_thomas_solve_inv(dl.data() + j, d.data() + j, du.data() + j,
+                                  z.data() + j, nprob, nprob, X.data() + j, nprob, nrow);
+  };
+  Kokkos::parallel_for(Kokkos::TeamVectorRange(team, nprob), f);
+}
+
+// Factor once, solve many times.
+
+template <typename TeamMember, typename TridiagDiag>
+KOKKOS_INLINE_FUNCTION
+void thomas_factor (const TeamMember& team,
+                    TridiagDiag dl, TridiagDiag d, TridiagDiag du,
+                    typename std::enable_if<TridiagDiag::rank == 1>::type* = 0,
+                    impl::EnableIfCanUsePointer<TridiagDiag>* = 0) {
+  const int nrow = d.extent_int(0);
+  assert(dl.extent_int(0) == nrow);
+  assert(du.extent_int(0) == nrow);
+  Kokkos::single(Kokkos::PerTeam(team), [&] () {
+    impl::thomas_factor_inv(dl.data(), d.data(), du.data(), nrow, 1);
+  });
+  team.team_barrier();
+}
+
+template <typename TeamMember, typename TridiagDiag>
+KOKKOS_INLINE_FUNCTION
+void thomas_factor (const TeamMember& team,
+                    TridiagDiag dl, TridiagDiag d, TridiagDiag du,
+                    typename std::enable_if<TridiagDiag::rank == 2>::type* = 0,
+                    impl::EnableIfCanUsePointer<TridiagDiag>* = 0) {
+  const int nrow = d.extent_int(0);
+  const int ncol = d.extent_int(1);
+  assert(dl.extent_int(0) == nrow);
+  assert(du.extent_int(0) == nrow);
+  assert(dl.extent_int(1) == ncol);
+  assert(du.extent_int(1) == ncol);
+  const auto f = [&] (const int& j) {
+    impl::thomas_factor_inv(dl.data() + j, d.data() + j, du.data() + j, nrow, ncol);
+  };
+  Kokkos::parallel_for(Kokkos::TeamVectorRange(team, ncol), f);
+  team.team_barrier();
+}
+
+template <typename TeamMember, typename TridiagDiag, typename DataArray>
+KOKKOS_INLINE_FUNCTION
+void thomas_solve_factored (const TeamMember& team,
+                            TridiagDiag dl, TridiagDiag d, TridiagDiag du, DataArray X,
+                            typename std::enable_if<TridiagDiag::rank == 1>::type* = 0,
+                            typename std::enable_if<DataArray::rank == 1>::type* = 0,
+                            impl::EnableIfCanUsePointer<TridiagDiag>* = 0,
+                            impl::EnableIfCanUsePointer<DataArray>* = 0) {
+  const int nrow = d.extent_int(0);
+  assert( X.extent_int(0) == nrow);
+  assert(dl.extent_int(0) == nrow);
+  assert(du.extent_int(0) == nrow);
+  Kokkos::single(Kokkos::PerTeam(team), [&] () {
+    impl::thomas_solve_inv(dl.data(), d.data(), du.data(), 1, X.data(), 1, nrow);
+  });
+}
+
+template <typename TeamMember, typename TridiagDiag, typename DataArray>
+KOKKOS_INLINE_FUNCTION
+void thomas_solve_factored (const TeamMember& team,
+                            TridiagDiag dl, TridiagDiag d, TridiagDiag du, DataArray X,
+                            typename std::enable_if<TridiagDiag::rank == 1>::type* = 0,
+                            typename std::enable_if<DataArray::rank == 2>::type* = 0,
+                            impl::EnableIfCanUsePointer<TridiagDiag>* = 0,
+                            impl::EnableIfCanUsePointer<DataArray>* = 0) {
+  const int nrow = d.extent_int(0);
+  const int nrhs = X.extent_int(1);
+  assert( X.extent_int(0) == nrow);
+  assert(dl.extent_int(0) == nrow);
+  assert(du.extent_int(0) == nrow);
+  const auto f = [&] (const int& j) {
+    impl::thomas_solve_inv(dl.data(), d.data(), du.data(), 1, X.data() + j, nrhs, nrow);
+  };
+  Kokkos::parallel_for(Kokkos::TeamVectorRange(team, nrhs), f);
+}
+
+template <typename TeamMember, typename TridiagDiag, typename DataArray>
+KOKKOS_INLINE_FUNCTION
+void thomas_solve_factored (const TeamMember& team,
+                            TridiagDiag dl, TridiagDiag d, TridiagDiag du, DataArray X,
+                            typename std::enable_if<TridiagDiag::rank == 2>::type* = 0,
+                            typename std::enable_if<DataArray::rank == 2>::type* = 0,
+                            impl::EnableIfCanUsePointer<TridiagDiag>* = 0,
+                            impl::EnableIfCanUsePointer<DataArray>* = 0) {
+  const int nrow = d.extent_int(0);
+  const int ncol = d.extent_int(1);
+  assert(X .extent_int(0) == nrow);
+  assert(dl.extent_int(0) == nrow);
+  assert(du.extent_int(0) == nrow);
+  assert(X .extent_int(1) == ncol);
+  assert(dl.extent_int(1) == ncol);
+  assert(du.extent_int(1) == ncol);
+  const auto f = [&] (const int& j) {
+    impl::thomas_solve_inv(dl.data() + j, d.data() + j, du.data() + j, ncol,
+                           X.data() + j, ncol, nrow);
+  };
+  Kokkos::parallel_for(Kokkos::TeamVectorRange(team, ncol), f);
+}
+
+KOKKOS_INLINE_FUNCTION
+int cr_factor_size (const int nrow) {
+  int n = 0, os = 1, stride;
+  while ((stride = (os << 1)) < nrow) {
+    n += 2*((nrow + stride - 1)/stride);
+    os <<= 1;
+  }
+  return n;
+}
+
+// Same reduction as cr, except that the coefficients of each level are stored
+// in f, the bottom 1x1 or 2x2 matrix is replaced by its inverse, and the other
+// entries of d by their reciprocals.
+template <typename TeamMember, typename TridiagDiag, typename CoefArray>
+KOKKOS_INLINE_FUNCTION
+void cr_factor (const TeamMember& team,
+                TridiagDiag dl, TridiagDiag d, TridiagDiag du, CoefArray f,
+                typename std::enable_if<TridiagDiag::rank == 1>::type* = 0) {
+  using Scalar = typename TridiagDiag::non_const_value_type;
+  const int nrow = d.extent_int(0);
+  assert(dl.extent_int(0) == nrow);
+  assert(du.extent_int(0) == nrow);
+  assert(f.extent_int(0) >= cr_factor_size(nrow));
+  const int team_id = impl::get_thread_id_within_team(team);
+  const int nteam = impl::get_team_nthr(team);
+  int os = 1, stride, fos = 0;
+  while ((stride = (os << 1)) < nrow) {
+    const int inc = stride*nteam;
+    for (int i = stride*team_id; i < nrow; i += inc) {
+      int im = i - os;
+      int ip = i + os;
+      const auto f1 = im >= 0   ? -dl(i)/d(im) : 0;
+      const auto f2 = ip < nrow ? -du(i)/d(ip) : 0;
+      im = im >= 0   ? im : i;
+      ip = ip < nrow ? ip : i;
+      dl(i)  = f1*dl(im);
+      du(i)  = f2*du(ip);
+      d (i) += f1*du(im) + f2*dl(ip);
+      f(fos + 2*(i/stride)    ) = f1;
+      f(fos + 2*(i/stride) + 1) = f2;
+    }
+    fos += 2*((nrow + stride - 1)/stride);
+    os <<= 1;
+    team.team_barrier();
+  }
+  if (team_id == 0) {
+    if (os >= nrow) {
+      d(0) = Scalar(1)/d(0);
+    } else {
+      const Scalar det = d(0)*d(os) - du(0)*dl(os);
+      const Scalar d0 = d(0);
+      d ( 0) =  d(os)/det;
+      du( 0) = -du(0)/det;
+      dl(os) = -dl(os)/det;
+      d (os) =  d0/det;
+    }
+  }
+  // The other rows are only divided by d in the up reduction.
+  for (int i = team_id; i < nrow; i += nteam)
+    if (i != 0 && i != os)
+      d(i) = Scalar(1)/d(i);
+  team.team_barrier();
+}
+
+template <typename TeamMember, typename TridiagDiag, typename CoefArray, typename DataArray>
+KOKKOS_INLINE_FUNCTION
+void cr_solve_factored (const TeamMember& team,
+                        TridiagDiag dl, TridiagDiag d, TridiagDiag du, CoefArray f,
+                        DataArray X,
+                        typename std::enable_if<TridiagDiag::rank == 1>::type* = 0,
+                        typename std::enable_if<DataArray::rank == 1>::type* = 0) {
+  const int nrow = d.extent_int(0);
+  assert(X.extent_int(0) == nrow);
+  const auto x = [&] (const int& i, const int&) -> typename DataArray::reference_type {
+    return X(i);
+  };
+  impl::cr_solve_factored(team, dl, d, du, f, nrow, 1, x);
+}
+
+template <typename TeamMember, typename TridiagDiag, typename CoefArray, typename DataArray>
+KOKKOS_INLINE_FUNCTION
+void cr_solve_factored (const TeamMember& team,
+                        TridiagDiag dl, TridiagDiag d, TridiagDiag du, CoefArray f,
+                        DataArray X,
+                        typename std::enable_if<TridiagDiag::rank == 1>::type* = 0,
+                        typename std::enable_if<DataArray::rank == 2>::type* = 0) {
+  const int nrow = d.extent_int(0);
+  assert(X.extent_int(0) == nrow);
+  const auto x = [&] (const int& i, const int& j) -> typename DataArray::reference_type {
+    return X(i,j);
+  };
+  impl::cr_solve_factored(team, dl, d, du, f, nrow, X.extent_int(1), x);
+}
+
 template <typename TeamMember, typename TridiagDiag, typename DataArray>
 KOKKOS_INLINE_FUNCTION
 void bfb (const TeamMember& team,
@@ -47,6 +47,11 @@ using HostDevice = Kokkos::Device<Kokkos::DefaultHostExecutionSpace, Kokkos::Def
 // Alias for Kokkos' default memory trait for views (managed memory, no special properties)
 using ManagedMemoryTrait = Kokkos::MemoryTraits<0>;
 
+// Alias for Kokkos' aligned memory trait. The data of views with this trait is
+// guaranteed (and checked upon construction) to be aligned to Kokkos' memory
+// alignment (64 bytes by default). See also allocate_aligned in ekat_pack_kokkos.hpp.
+using AlignedMemoryTrait = Kokkos::MemoryTraits<Kokkos::Aligned>;
+
 template<typename DT, typename... Props>
 using ViewLR = Kokkos::View<DT,Kokkos::LayoutRight,Props...>;
 
@@ -94,6 +99,16 @@ struct KokkosTypes
   template <typename Scalar, typename MemoryTraits = ManagedMemoryTrait>
   using view_3d = view<Scalar***,MemoryTraits>;
 
+  // Same as above, but with the data aligned (see AlignedMemoryTrait)
+  template <typename Scalar>
+  using aligned_view_1d = view_1d<Scalar,AlignedMemoryTrait>;
+
+  template <typename Scalar>
+  using aligned_view_2d = view_2d<Scalar,AlignedMemoryTrait>;
+
+  template <typename Scalar>
+  using aligned_view_3d = view_3d<Scalar,AlignedMemoryTrait>;
+
   template <typename Scalar, int X, typename MemoryTraits = ManagedMemoryTrait>
   using view_1d_table = view<const Scalar[X],MemoryTraits>;
 
@@ -110,6 +110,129 @@ struct TeamPolicyFactory<EkatGpuSpace> {
 };
 #endif
 
+namespace impl {
+
+/*
+ * A lock-free stack (AKA Treiber stack) of the slot indices 0,...,n-1, which
+ * can be popped/pushed concurrently by any number of host or device threads.
+ * The head of the stack stores the top slot in its low 32 bits, and a counter,
+ * bumped at every change, in its high 32 bits, so that a CAS on the head fails
+ * if the top slot was popped and pushed back in the meantime (the ABA problem).
+ */
+template <typename ExeSpace>
+class SlotFreeList
+{
+  using Device    = Kokkos::Device<ExeSpace, typename ExeSpace::memory_space>;
+  using head_type = unsigned long long;
+  using view_head = typename KokkosTypes<Device>::template view_1d<head_type>;
+  using view_next = typename KokkosTypes<Device>::template view_1d<int>;
+
+  view_head _head;  // (counter, top slot), with top slot -1 if the list is empty
+  view_next _next;  // _next(i) is the slot below i in the stack (-1 for the bottom one)
+  int       _size = 0;
+
+  KOKKOS_FORCEINLINE_FUNCTION
+  static int get_top (const head_type h) { return static_cast<int>(static_cast<unsigned>(h)); }
+
+  KOKKOS_FORCEINLINE_FUNCTION
+  static head_type make_head (const head_type old, const int top) {
+    return (((old >> 32) + 1) << 32) | static_cast<unsigned>(top);
+  }
+
+ public:
+  SlotFreeList() = default;
+
+  explicit SlotFreeList(const int n) : _size(n)
+  {
+    EKAT_REQUIRE_MSG (n>=0, "Error! Invalid (negative) number of slots.\n");
+    if (n>0) {
+      _head = view_head("SlotFreeList.head", 1);
+      _next = view_next("SlotFreeList.next", n);
+      reset();
+    }
+  }
+
+  // Number of slots
+  int size () const { return _size; }
+
+  // call from host.
+  //
+  // Put all the slots back in the list (with slot 0 on top). Only call when no slot is in use.
+  void reset ()
+  {
+    if (_size==0) return;
+    auto next_h = Kokkos::create_mirror_view(_next);
+    for (int i=0; i<_size; ++i) {
+      next_h(i) = i+1<_size ? i+1 : -1;
+    }
+    Kokkos::deep_copy(_next, next_h);
+    Kokkos::deep_copy(_head, make_head(0, 0));
+  }
+
+  // Pop a slot, or return -1 if all slots are in use
+  KOKKOS_INLINE_FUNCTION
+  int try_pop () const
+  {
+    head_type old = Kokkos::atomic_load(&_head(0));
+    for (int top = get_top(old); top >= 0; top = get_top(old)) {
+      const int below = Kokkos::atomic_load(&_next(top));
+      const head_type prev = Kokkos::atomic_compare_exchange(&_head(0), old, make_head(old, below));
+      if (prev == old) {
+        // Make sure reads of the resource guarded by this slot happen after we own it
+        Kokkos::memory_fence();
+        return top;
+      }
+      old = prev;
+    }
+    return -1;
+  }
+
+  // Pop a slot, spinning until one is available
+  KOKKOS_INLINE_FUNCTION
+  int pop () const
+  {
+    int slot = try_pop();
+    while (slot < 0) {
+      slot = try_pop();
+    }
+    return slot;
+  }
+
+  // Give back a slot obtained from try_pop/pop
+  KOKKOS_INLINE_FUNCTION
+  void push (const int slot) const
+  {
+    // Make sure writes to the resource guarded by this slot are seen
+    // before the slot can be popped by another thread
+    Kokkos::memory_fence();
+    head_type old = Kokkos::atomic_load(&_head(0));
+    for (;;) {
+      Kokkos::atomic_store(&_next(slot), get_top(old));
+      const head_type prev = Kokkos::atomic_compare_exchange(&_head(0), old, make_head(old, slot));
+      if (prev == old) {
+        return;
+      }
+      old = prev;
+    }
+  }
+};
+
+} // namespace impl
+
+/*
+ * How TeamUtils assigns ws slots to teams, when the policy has more teams than ws slots:
+ *  - Default: thread id on OpenMP/Threads/HPX (if teams have one thread), random probing
+ *             of per-slot flags on GPU, and a lock-free free list of slots otherwise.
+ *  - FreeList: a lock-free free list of slots (see impl::SlotFreeList) on all backends.
+ *             Acquire/release are O(1), except when all slots are in use, and do not
+ *             depend on random numbers, so the cost does not blow up as the number of
+ *             slots approaches the number of concurrent teams.
+ */
+enum class WsSlotAssignment {
+  Default,
+  FreeList
+};
+
 /*
  * TeamUtils contains utilities for getting concurrency info for thread teams.
  * You cannot use it directly (protected c-tor). You must use TeamUtils.
@@ -186,44 +309,210 @@ public:
   { }
 };
 
+/*
+ * If the policy has more teams than can run concurrently, teams take a ws slot
+ * from a lock-free free list in get_workspace_idx, and give it back in
+ * release_workspace_idx, so that teams running at the same time never share a
+ * slot, regardless of how (and on how many threads) the backend runs them.
+ * Otherwise, each team has its own slot.
+ */
+template <typename ValueType, typename ExeSpace = Kokkos::DefaultExecutionSpace>
+class TeamUtilsFreeListBase : public TeamUtilsCommonBase<ValueType, ExeSpace>
+{
+protected:
+  bool _need_ws_sharing = false; // true if there are more teams in the policy than ws slots
+  impl::SlotFreeList<ExeSpace> _free_ws_slots;
+
+  TeamUtilsFreeListBase() = default;
+
+  // Derived classes that can map teams to slots in another way can skip the free list
+  template <typename TeamPolicy>
+  TeamUtilsFreeListBase(const TeamPolicy& policy, const bool use_free_list = true) :
+    TeamUtilsCommonBase<ValueType, ExeSpace>(policy),
+    _need_ws_sharing(this->_league_size > this->_num_teams),
+    _free_ws_slots(_need_ws_sharing && use_free_list ? this->_num_teams : 0)
+  { }
+
+public:
+
+  template <typename MemberType>
+  KOKKOS_INLINE_FUNCTION
+  int get_workspace_idx(const MemberType& team_member) const
+  {
+    EKAT_KERNEL_ASSERT_MSG (this->_team_size>0, "Error! TeamUtils not yet inited.\n");
+
+    if ( ! _need_ws_sharing) {
+      return team_member.league_rank();
+    }
+    int ws_idx_broadcast;
+    Kokkos::single(Kokkos::PerTeam(team_member), [&] (int& ws_idx) {
+      ws_idx = _free_ws_slots.pop();
+    }, ws_idx_broadcast);
+    return ws_idx_broadcast;
+  }
+
+  template <typename MemberType>
+  KOKKOS_INLINE_FUNCTION
+  void release_workspace_idx(const MemberType& team_member, int ws_idx) const
+  {
+    if (_need_ws_sharing) {
+      // All threads must be done with the slot before it is handed to another team
+      team_member.team_barrier();
+      Kokkos::single(Kokkos::PerTeam(team_member), [&] () {
+        _free_ws_slots.push(ws_idx);
+      });
+    }
+  }
+};
+
 template <typename ValueType, typename ExeSpace = Kokkos::DefaultExecutionSpace>
-class TeamUtils : public TeamUtilsCommonBase<ValueType, ExeSpace>
+class TeamUtils : public TeamUtilsFreeListBase<ValueType, ExeSpace>
 {
  public:
   TeamUtils() = default;
 
   template <typename TeamPolicy>
-  TeamUtils(const TeamPolicy& policy, const double& = 1.0) :
-    TeamUtilsCommonBase<ValueType, ExeSpace>(policy)
+  TeamUtils(const TeamPolicy& policy, const double& = 1.0,
+            const WsSlotAssignment = WsSlotAssignment::Default) :
+    TeamUtilsFreeListBase<ValueType, ExeSpace>(policy)
   { }
 
   TeamUtils& operator= (const TeamUtils& src) = default;
 };
 
 /*
- * Specialization for OpenMP execution space
+ * Specialization for OpenMP execution space. With WsSlotAssignment::FreeList,
+ * it uses the same free list as the GPU specialization, which allows to test
+ * the latter on host.
  */
 #ifdef KOKKOS_ENABLE_OPENMP
 template <typename ValueType>
-class TeamUtils<ValueType, Kokkos::OpenMP> : public TeamUtilsCommonBase<ValueType,Kokkos::OpenMP>
+class TeamUtils<ValueType, Kokkos::OpenMP> : public TeamUtilsFreeListBase<ValueType,Kokkos::OpenMP>
 {
+  using Base = TeamUtilsFreeListBase<ValueType,Kokkos::OpenMP>;
+
+  bool _use_free_list = false;
+
  public:
   TeamUtils() = default;
 
   template <typename TeamPolicy>
-  TeamUtils(const TeamPolicy& policy, const double& = 1.0) :
-    TeamUtilsCommonBase<ValueType,Kokkos::OpenMP>(policy)
+  TeamUtils(const TeamPolicy& policy, const double& = 1.0,
+            const WsSlotAssignment assignment = WsSlotAssignment::Default) :
+    Base(policy, assignment == WsSlotAssignment::FreeList),
+    _use_free_list(assignment == WsSlotAssignment::FreeList)
   { }
 
   TeamUtils& operator= (const TeamUtils& src) = default;
 
   template <typename MemberType>
   KOKKOS_INLINE_FUNCTION
-  int get_workspace_idx(const MemberType& /*team_member*/) const
+  int get_workspace_idx(const MemberType& team_member) const
   {
     EKAT_KERNEL_ASSERT_MSG (this->_team_size>0, "Error! TeamUtils not yet inited.\n");
+    if (_use_free_list) {
+      return Base::get_workspace_idx(team_member);
+    }
     return omp_get_thread_num() / this->_team_size;
   }
+
+  template <typename MemberType>
+  KOKKOS_INLINE_FUNCTION
+  void release_workspace_idx(const MemberType& team_member, int ws_idx) const
+  {
+    if (_use_free_list) {
+      Base::release_workspace_idx(team_member, ws_idx);
+    }
+  }
+};
+#endif
+
+/*
+ * Specializations for Threads and HPX execution spaces. With one thread per
+ * team (the default on CPU), a thread runs one team at a time, so the thread
+ * id is a valid ws slot, with no need for atomics. Otherwise, use the free list.
+ */
+#ifdef KOKKOS_ENABLE_THREADS
+template <typename ValueType>
+class TeamUtils<ValueType, Kokkos::Threads> : public TeamUtilsFreeListBase<ValueType,Kokkos::Threads>
+{
+  using Base = TeamUtilsFreeListBase<ValueType,Kokkos::Threads>;
+
+  bool _use_thread_id = false;
+
+ public:
+  TeamUtils() = default;
+
+  template <typename TeamPolicy>
+  TeamUtils(const TeamPolicy& policy, const double& = 1.0,
+            const WsSlotAssignment assignment = WsSlotAssignment::Default) :
+    Base(policy, policy.team_size() > 1 || assignment == WsSlotAssignment::FreeList),
+    _use_thread_id(policy.team_size() == 1 && assignment == WsSlotAssignment::Default)
+  { }
+
+  TeamUtils& operator= (const TeamUtils& src) = default;
+
+  template <typename MemberType>
+  KOKKOS_INLINE_FUNCTION
+  int get_workspace_idx(const MemberType& team_member) const
+  {
+    EKAT_KERNEL_ASSERT_MSG (this->_team_size>0, "Error! TeamUtils not yet inited.\n");
+    if (this->_need_ws_sharing && _use_thread_id) {
+      return Kokkos::Threads::impl_thread_pool_rank();
+    }
+    return Base::get_workspace_idx(team_member);
+  }
+
+  template <typename MemberType>
+  KOKKOS_INLINE_FUNCTION
+  void release_workspace_idx(const MemberType& team_member, int ws_idx) const
+  {
+    if (not _use_thread_id) {
+      Base::release_workspace_idx(team_member, ws_idx);
+    }
+  }
+};
+#endif
+
+#ifdef KOKKOS_ENABLE_HPX
+template <typename ValueType>
+class TeamUtils<ValueType, Kokkos::Experimental::HPX> : public TeamUtilsFreeListBase<ValueType,Kokkos::Experimental::HPX>
+{
+  using Base = TeamUtilsFreeListBase<ValueType,Kokkos::Experimental::HPX>;
+
+  bool _use_thread_id = false;
+
+ public:
+  TeamUtils() = default;
+
+  template <typename TeamPolicy>
+  TeamUtils(const TeamPolicy& policy, const double& = 1.0,
+            const WsSlotAssignment assignment = WsSlotAssignment::Default) :
+    Base(policy, policy.team_size() > 1 || assignment == WsSlotAssignment::FreeList),
+    _use_thread_id(policy.team_size() == 1 && assignment == WsSlotAssignment::Default)
+  { }
+
+  TeamUtils& operator= (const TeamUtils& src) = default;
+
+  template <typename MemberType>
+  KOKKOS_INLINE_FUNCTION
+  int get_workspace_idx(const MemberType& team_member) const
+  {
+    EKAT_KERNEL_ASSERT_MSG (this->_team_size>0, "Error! TeamUtils not yet inited.\n");
+    if (this->_need_ws_sharing && _use_thread_id) {
+      return Kokkos::Experimental::HPX::impl_hardware_thread_id();
+    }
+    return Base::get_workspace_idx(team_member);
+  }
+
+  template <typename MemberType>
+  KOKKOS_INLINE_FUNCTION
+  void release_workspace_idx(const MemberType& team_member, int ws_idx) const
+  {
+    if (not _use_thread_id) {
+      Base::release_workspace_idx(team_member, ws_idx);
+    }
+  }
 };
 #endif
 
@@ -242,24 +531,29 @@ class TeamUtils<ValueType,EkatGpuSpace> : public TeamUtilsCommonBase<ValueType,E
 
   int             _num_ws_slots;    // how many workspace slots (potentially more than the num of concurrent teams due to overprovision factor)
   bool            _need_ws_sharing; // true if there are more teams in the policy than ws slots
+  bool            _use_free_list;   // true if slots are taken from _free_ws_slots rather than via random probing
   view_1d         _open_ws_slots;    // indexed by ws-idx, true if in current use, else false
   RandomGenerator _rand_pool;
+  impl::SlotFreeList<EkatGpuSpace> _free_ws_slots;
 
  public:
   TeamUtils() = default;
 
   template <typename TeamPolicy>
-  TeamUtils(const TeamPolicy& policy, const double& overprov_factor = 1.0) :
+  TeamUtils(const TeamPolicy& policy, const double& overprov_factor = 1.0,
+            const WsSlotAssignment assignment = WsSlotAssignment::Default) :
     TeamUtilsCommonBase<ValueType,EkatGpuSpace>(policy),
     _num_ws_slots(this->_league_size > this->_num_teams
                   ? (overprov_factor * this->_num_teams > this->_league_size ? this->_league_size : overprov_factor * this->_num_teams)
                   : this->_num_teams),
     _need_ws_sharing(this->_league_size > _num_ws_slots),
-    _open_ws_slots("open_ws_slots", _need_ws_sharing ? _num_ws_slots : 0),
-    _rand_pool()
+    _use_free_list(assignment == WsSlotAssignment::FreeList),
+    _open_ws_slots("open_ws_slots", _need_ws_sharing && !_use_free_list ? _num_ws_slots : 0),
+    _rand_pool(),
+    _free_ws_slots(_need_ws_sharing && _use_free_list ? _num_ws_slots : 0)
   {
     EKAT_REQUIRE_MSG(overprov_factor >= 1.0, "Makes no sense to have an overprov < 1");
-    if (_need_ws_sharing) {
+    if (_need_ws_sharing && !_use_free_list) {
       _rand_pool = RandomGenerator(std::chrono::high_resolution_clock::now().time_since_epoch().count());
     }
   }
@@ -281,6 +575,12 @@ class TeamUtils<ValueType,EkatGpuSpace> : public TeamUtilsCommonBase<ValueType,E
 
     if ( ! _need_ws_sharing) {
       return team_member.league_rank();
+    } else if (_use_free_list) {
+      int ws_idx_broadcast;
+      Kokkos::single(Kokkos::PerTeam(team_member), [&] (int& ws_idx) {
+        ws_idx = _free_ws_slots.pop();
+      }, ws_idx_broadcast);
+      return ws_idx_broadcast;
     } else {
       int ws_idx_broadcast;
       Kokkos::single(Kokkos::PerTeam(team_member), [&] (int& ws_idx) {
@@ -308,7 +608,13 @@ class TeamUtils<ValueType,EkatGpuSpace> : public TeamUtilsCommonBase<ValueType,E
   KOKKOS_INLINE_FUNCTION
   void release_workspace_idx(const MemberType& team_member, int ws_idx) const
   {
-    if (_need_ws_sharing) {
+    if (_need_ws_sharing && _use_free_list) {
+      team_member.team_barrier();
+      Kokkos::single(Kokkos::PerTeam(team_member), [&] () {
+        // push fences before making the slot available, for the reasons explained below
+        _free_ws_slots.push(ws_idx);
+      });
+    } else if (_need_ws_sharing) {
       team_member.team_barrier();
       Kokkos::single(Kokkos::PerTeam(team_member), [&] () {
         // The 'volatile' declaration in atomic_compare_exchange and in
@@ -4,12 +4,17 @@
 #include "ekat_team_policy_utils.hpp"
 #include "ekat_kokkos_types.hpp"
 
+#include <vector>
+
 namespace unit_test {
 struct UnitWrap;
 }
 
 namespace ekat {
 
+template <typename DeviceT>
+class WorkspaceArena;
+
 /*
  * WorkspaceManager is a utility for requesting workspaces
  * (temporary memory blocks) from within a Kokkos kernel. Workspaces
@@ -34,12 +39,51 @@ namespace ekat {
  * making a single take_many_and_reset call at the beginning of the
  * Kokkos kernel, though this may not be practical for large
  * kernels. High-granularity take/release calls can allow you to use a
- * smaller Workspace (by allowing you to use a smaller max_used).
+ * smaller Workspace (by allowing you to use a smaller max_used). The
+ * take_scoped variants return handles that release their sub-blocks when
+ * they go out of scope, so that fine-grained take/release cannot leak.
  *
  * You can fine-tune the max_used by making a large overestimate for
  * this value, running your kernel, and then calling report, which
  * will tell you the actual maximum number of sub-blocks that you
  * used. Note that all sub-blocks have a name.
+ *
+ * If a kernel needs sub-blocks of different sizes (e.g., a few of
+ * length nlev and a couple of length 3*nlev), sizing all of them for
+ * the largest one wastes memory. Instead, one can set up the WSM with
+ * a list of block classes, {size, max_used}, and take sub-blocks via
+ * take(name,nelems), which returns a view with exactly nelems entries,
+ * stored in a sub-block of the smallest class that fits (or of a larger
+ * class, if all the sub-blocks of the smallest one are in use). Each
+ * class has its own free list, in a separate segment of the same
+ * workspace. The first class is the default one, which is used by all
+ * the other take/release methods. E.g.,
+ *
+ *   WSM wsm({ {nlev,6}, {3*nlev,2} }, policy);
+ *
+ * needs 6*nlev+6*nlev T's per workspace, rather than the 8*3*nlev T's
+ * of WSM(3*nlev,8,policy), which means a smaller per-team footprint.
+ *
+ * If a workspace is small enough to fit in the team scratch memory (e.g.,
+ * GPU shared memory), calling use_team_scratch after setup makes each team
+ * get its workspace in team scratch rather than in global memory, e.g.,
+ *
+ *   WSM wsm(nlev, 4, policy);
+ *   wsm.use_team_scratch(policy); // sets the scratch size of policy
+ *   Kokkos::parallel_for(policy, ...);
+ *
+ * Besides the faster memory, each team then owns its workspace, so that
+ * get_workspace does not have to acquire a workspace slot via TeamUtils.
+ *
+ * If EKAT is configured with EKAT_WSM_GUARD=ON (in debug or release builds),
+ * every sub-block is followed by a canary, and taking a sub-block fills it
+ * with signaling NaN's (or with invalid<S>() for non floating point S). Enable
+ * FE_INVALID (see ekat::enable_fpes) to trap the reads of uninitialized
+ * workspace memory. Releasing a sub-block aborts if its canary was overwritten,
+ * i.e., if the kernel wrote past the end of the sub-block (for sub-blocks of
+ * block classes, past the end of the class size, rather than of nelems). The
+ * canaries are not checked by reset. Without EKAT_WSM_GUARD, none of this is
+ * compiled.
  */
 
 template <typename T, typename DeviceT=DefaultDevice>
@@ -64,9 +108,44 @@ class WorkspaceManager
   template <typename S>
   using view_3d = typename KokkosTypes<Device>::template view_3d<S>;
 
+  template <typename S>
+  using scratch_view_1d = Kokkos::View<S*, typename ExeSpace::scratch_memory_space,
+                                       Kokkos::MemoryTraits<Kokkos::Unmanaged> >;
+
   template <typename S, int N>
   using view_1d_ptr_array = typename KokkosTypes<Device>::template view_1d_ptr_array<S, N>;
 
+  // A class of sub-blocks of the same size
+  //   size: The number of T's per sub-block
+  //   max_used: The maximum number of active sub-blocks of this class
+  struct BlockClass {
+    int size;
+    int max_used;
+  };
+
+  // Usage statistics of a WSM set up with track_usage=true (see get_usage_summary)
+  struct UsageSummary {
+    struct ClassUsage {
+      int size;                       // The number of T's per sub-block
+      int max_used;                   // The maximum number of active sub-blocks, as set up
+      int high_water;                 // The max number of sub-blocks in use at once, over all workspaces
+      std::vector<int> ws_high_water; // Same as high_water, but for each workspace
+    };
+
+    int num_ws;                       // The number of workspaces
+    std::vector<ClassUsage> classes;  // One entry per block class (the default one first)
+
+    // The block classes with max_used replaced by the high-water mark, which can be
+    // fed back to the constructor/setup to shrink the workspace allocation.
+    std::vector<BlockClass> get_fitted_classes () const {
+      std::vector<BlockClass> fitted;
+      for (const auto& cu : classes) {
+        fitted.push_back({cu.size, cu.high_water});
+      }
+      return fitted;
+    }
+  };
+
   //
   // -------- Contants --------
   //
@@ -76,6 +155,9 @@ class WorkspaceManager
   //static inline constexpr double GPU_DEFAULT_OVERPROVISION_FACTOR = 1.25;
   static constexpr double GPU_DEFAULT_OVERPROVISION_FACTOR() { return 1.25; }
 
+  // Max number of block classes (see BlockClass below)
+  enum { MAX_BLOCK_CLASSES = 8 };
+
   //
   // ------- public API ---------
   //
@@ -88,8 +170,14 @@ class WorkspaceManager
   //   max_used: The maximum number of active sub-blocks
   //   policy: The team policy for Kokkos kernels using this WorkspaceManager
   //   overprov_factor: How many workspace slots to overprovision (only applies to GPU for large problems)
+  //   slot_assignment: How workspace slots are assigned to teams, if the policy has more
+  //                    teams than slots (see WsSlotAssignment in ekat_team_policy_utils.hpp)
+  //   track_usage: Whether to keep track of the high-water mark of each block class in
+  //                each workspace, also in release builds (see get_usage_summary)
   WorkspaceManager(int size, int max_used, TeamPolicy policy,
-                   const double& overprov_factor=GPU_DEFAULT_OVERPROVISION_FACTOR());
+                   const double& overprov_factor=GPU_DEFAULT_OVERPROVISION_FACTOR(),
+                   const WsSlotAssignment slot_assignment=WsSlotAssignment::Default,
+                   const bool track_usage=false);
 
   // Constructor, call from host
   //   Same as above, but here the user initializes the data.
@@ -99,7 +187,9 @@ class WorkspaceManager
   //   data is available, for which the get_total_slots_to_be_used()
   //   function can be helpful.
   WorkspaceManager(T* data, int size, int max_used, TeamPolicy policy,
-                   const double& overprov_factor=GPU_DEFAULT_OVERPROVISION_FACTOR());
+                   const double& overprov_factor=GPU_DEFAULT_OVERPROVISION_FACTOR(),
+                   const WsSlotAssignment slot_assignment=WsSlotAssignment::Default,
+                   const bool track_usage=false);
 
   // Helper functions which return the number of bytes that will be reserved for a given
   // set of constructor inputs. Note, this does not actually create an instance of the WSM,
@@ -108,24 +198,62 @@ class WorkspaceManager
   static int get_total_bytes_needed(int size, int max_used, TeamPolicy policy,
                                     const double& overprov_factor=GPU_DEFAULT_OVERPROVISION_FACTOR());
 
+  // Same as the three functions above, but with several block classes. The first
+  // class is the default one (i.e., the one with the size and max_used above).
+  WorkspaceManager(const std::vector<BlockClass>& classes, TeamPolicy policy,
+                   const double& overprov_factor=GPU_DEFAULT_OVERPROVISION_FACTOR(),
+                   const WsSlotAssignment slot_assignment=WsSlotAssignment::Default,
+                   const bool track_usage=false);
+
+  WorkspaceManager(T* data, const std::vector<BlockClass>& classes, TeamPolicy policy,
+                   const double& overprov_factor=GPU_DEFAULT_OVERPROVISION_FACTOR(),
+                   const WsSlotAssignment slot_assignment=WsSlotAssignment::Default,
+                   const bool track_usage=false);
+
+  static int get_total_bytes_needed(const std::vector<BlockClass>& classes, TeamPolicy policy,
+                                    const double& overprov_factor=GPU_DEFAULT_OVERPROVISION_FACTOR());
+
   // call from host.
   //
   // Will report usage statistics for your workspaces. These statistics will
   // have much more detail for debug builds.
   void report() const;
 
+  // call from host.
+  //
+  // Return the high-water marks of each block class, in each workspace, since setup.
+  // Unlike report, this works in release builds too, but requires track_usage=true
+  // at setup time. The cost of tracking is a couple of integer updates per take/release.
+  UsageSummary get_usage_summary() const;
+
   // call from host.
   //
   // Setup routine for the WSM if the user used the empty constructor
   void setup(int size, int max_used, TeamPolicy policy,
-             const double& overprov_factor=GPU_DEFAULT_OVERPROVISION_FACTOR());
+             const double& overprov_factor=GPU_DEFAULT_OVERPROVISION_FACTOR(),
+             const WsSlotAssignment slot_assignment=WsSlotAssignment::Default,
+             const bool track_usage=false);
 
   // call from host.
   //
   // Setup routine for the WSM if the user used the empty constructor.
   // Same as above, but here the user initializes the data.
   void setup(T* data, int size, int max_used, TeamPolicy policy,
-             const double& overprov_factor=GPU_DEFAULT_OVERPROVISION_FACTOR());
+             const double& overprov_factor=GPU_DEFAULT_OVERPROVISION_FACTOR(),
+             const WsSlotAssignment slot_assignment=WsSlotAssignment::Default,
+             const bool track_usage=false);
+
+  // call from host.
+  //
+  // Same as the two setup routines above, but with several block classes.
+  void setup(const std::vector<BlockClass>& classes, TeamPolicy policy,
+             const double& overprov_factor=GPU_DEFAULT_OVERPROVISION_FACTOR(),
+             const WsSlotAssignment slot_assignment=WsSlotAssignment::Default,
+             const bool track_usage=false);
+  void setup(T* data, const std::vector<BlockClass>& classes, TeamPolicy policy,
+             const double& overprov_factor=GPU_DEFAULT_OVERPROVISION_FACTOR(),
+             const WsSlotAssignment slot_assignment=WsSlotAssignment::Default,
+             const bool track_usage=false);
 
   // call from host.
   //
@@ -134,6 +262,26 @@ class WorkspaceManager
   // is called during an initialization phase, but the WSM is used inside an iteration loop.
   void reset_internals();
 
+  // call from host, after setup.
+  //
+  // Serve the workspaces from the team scratch memory at the given level, rather than
+  // from global memory, if a workspace fits in it (see get_team_scratch_size). If so,
+  // set the scratch size of policy at level accordingly, free the global memory of this
+  // WSM, and return true. Otherwise, keep using global memory, and return false.
+  //
+  // In team scratch mode, each team sets up a fresh workspace (as after reset) when
+  // calling get_workspace, so sub-blocks do not persist across kernels, and get_workspace
+  // must be called at most once per team in a kernel. The kernels must run with policy
+  // (if they use team scratch at the same level themselves, add their size to
+  // get_team_scratch_size()). No workspace slot is acquired, unless this is a debug
+  // build or usage is tracked, which both need one for their per-workspace statistics.
+  bool use_team_scratch(TeamPolicy& policy, const int level = 0);
+
+  // Number of bytes of team scratch memory needed by one workspace
+  size_t get_team_scratch_size() const;
+
+  bool uses_team_scratch() const { return m_use_scratch; }
+
   class Workspace;
 
   // call from device
@@ -178,11 +326,144 @@ class WorkspaceManager
     };
 
 
+    // A sub-block that is released when it goes out of scope (see take_scoped).
+    // As with take/release, it must be created and destroyed by all the threads
+    // of the team, and the Workspace must outlive it.
+    template <typename S>
+    class ScopedBlock {
+     public:
+      using view_type = Unmanaged<view_1d<S> >;
+
+      KOKKOS_INLINE_FUNCTION
+      ScopedBlock (const Workspace& ws, const view_type& v) : m_ws(&ws), m_view(v) {}
+
+      ScopedBlock (const ScopedBlock&) = delete;
+      ScopedBlock& operator= (const ScopedBlock&) = delete;
+
+      // The moved-from block no longer releases the sub-block
+      KOKKOS_INLINE_FUNCTION
+      ScopedBlock (ScopedBlock&& src) : m_ws(src.m_ws), m_view(src.m_view) { src.m_ws = nullptr; }
+
+      KOKKOS_INLINE_FUNCTION
+      ~ScopedBlock () { if (m_ws) m_ws->release(m_view); }
+
+      KOKKOS_INLINE_FUNCTION
+      const view_type& view () const { return m_view; }
+      KOKKOS_INLINE_FUNCTION
+      operator const view_type& () const { return m_view; }
+
+      KOKKOS_INLINE_FUNCTION
+      typename view_type::reference_type operator() (const int i) const { return m_view(i); }
+      KOKKOS_INLINE_FUNCTION
+      S* data () const { return m_view.data(); }
+      KOKKOS_INLINE_FUNCTION
+      int size () const { return m_view.extent_int(0); }
+
+     private:
+      const Workspace* m_ws;
+      view_type m_view;
+    };
+
+    // N sub-blocks that are released when they go out of scope (see take_scoped_many).
+    // If Contiguous, they are taken with take_many_and_reset, and released with
+    // release_many_contiguous, i.e., with no list traversal at all. Otherwise, they
+    // are taken with take_many, and released one by one, in reverse order, which
+    // leaves the free list as it was before the take. The choice is made at compile
+    // time, so the handle adds no work to the underlying take/release calls.
+    template <size_t N, typename S, bool Contiguous>
+    class ScopedBlocks {
+     public:
+      using view_type = Unmanaged<view_1d<S> >;
+
+      KOKKOS_INLINE_FUNCTION
+      ScopedBlocks (const Workspace& ws, const Kokkos::Array<const char*, N>& names)
+       : m_ws(&ws)
+      {
+        view_1d_ptr_array<S, N> ptrs;
+        for (int n = 0; n < static_cast<int>(N); ++n) {
+          ptrs[n] = &m_views[n];
+        }
+        if constexpr (Contiguous) {
+          ws.template take_many_and_reset<N, S>(names, ptrs);
+        } else {
+          ws.template take_many<N, S>(names, ptrs);
+        }
+      }
+
+      ScopedBlocks (const ScopedBlocks&) = delete;
+      ScopedBlocks& operator= (const ScopedBlocks&) = delete;
+
+      // The moved-from blocks no longer release the sub-blocks
+      KOKKOS_INLINE_FUNCTION
+      ScopedBlocks (ScopedBlocks&& src) : m_ws(src.m_ws), m_views(src.m_views) { src.m_ws = nullptr; }
+
+      KOKKOS_INLINE_FUNCTION
+      ~ScopedBlocks () {
+        if (!m_ws) return;
+        if constexpr (Contiguous) {
+          view_1d_ptr_array<S, N> ptrs;
+          for (int n = 0; n < static_cast<int>(N); ++n) {
+            ptrs[n] = &m_views[n];
+          }
+          m_ws->template release_many_contiguous<N, S>(ptrs);
+        } else {
+          for (int n = static_cast<int>(N) - 1; n >= 0; --n) {
+            m_ws->release(m_views[n]);
+          }
+        }
+      }
+
+      KOKKOS_INLINE_FUNCTION
+      const view_type& operator[] (const int n) const { return m_views[n]; }
+
+      static constexpr int size () { return N; }
+
+     private:
+      const Workspace* m_ws;
+      Kokkos::Array<view_type, N> m_views;
+    };
+
     // Take an individual sub-block
     template <typename S=T>
     KOKKOS_INLINE_FUNCTION
     Unmanaged<view_1d<S> > take(const char* name) const;
 
+    // Same as the two take methods above, but return a handle that releases the
+    // sub-block when it goes out of scope. E.g.,
+    //   {
+    //     const auto tmp = ws.take_scoped("tmp");
+    //     ... use tmp(k), or tmp.view() ...
+    //   } // tmp is released here
+    template <typename S=T>
+    KOKKOS_INLINE_FUNCTION
+    ScopedBlock<S> take_scoped(const char* name) const
+    { return ScopedBlock<S>(*this, take<S>(name)); }
+
+    template <typename S=T>
+    KOKKOS_INLINE_FUNCTION
+    ScopedBlock<S> take_scoped(const char* name, const int nelems) const
+    { return ScopedBlock<S>(*this, take<S>(name, nelems)); }
+
+    // Same as take_many and take_many_and_reset, but return a handle that releases
+    // all the sub-blocks when it goes out of scope. The sub-blocks are accessed with
+    // operator[]. Like take_many_and_reset, take_scoped_many_and_reset requires that
+    // no other sub-block is in use, but it is the fastest option.
+    template <size_t N, typename S=T>
+    KOKKOS_INLINE_FUNCTION
+    ScopedBlocks<N, S, false> take_scoped_many(const Kokkos::Array<const char*, N>& names) const
+    { return ScopedBlocks<N, S, false>(*this, names); }
+
+    template <size_t N, typename S=T>
+    KOKKOS_INLINE_FUNCTION
+    ScopedBlocks<N, S, true> take_scoped_many_and_reset(const Kokkos::Array<const char*, N>& names) const
+    { return ScopedBlocks<N, S, true>(*this, names); }
+
+    // Take a sub-block of exactly nelems S's, from the smallest block class
+    // that fits it and has a free sub-block. Release it with release.
+    template <typename S=T>
+    KOKKOS_INLINE_FUNCTION
+    Unmanaged<view_1d<S> > take(const char* name, const int nelems) const;
+
     // Take several sub-blocks. The user gets pointers to their sub-blocks
     // via the ptrs argument.
     template <size_t N, typename S=T>
@@ -206,17 +487,29 @@ class WorkspaceManager
 
     // Take an individual sub-block while telling the WorkSpaceManager to skip over the
     // next n_sub_blocks-1 sub-blocks. This allows the user to safely access the memory
-    // of these sub-block, which is useful for creating local 2d views through the
-    // WorkspaceManager.
+    // of these sub-block. To create local 2d/3d views, use take_2d/take_3d below.
+    template <typename S=T>
+    KOKKOS_INLINE_FUNCTION
+    Unmanaged<view_1d<S> > take_macro_block(const char* name, const int n_sub_blocks) const;
+
+    // Take a 2d view of S's with extents (n0, n1), or a 3d one with extents (n0, n1, n2),
+    // stored in as many contiguous sub-blocks (of the default class) as needed, via
+    // take_macro_block, whose restrictions apply. S can differ from T, e.g., a view of
+    // packs in a workspace of scalars, or vice versa. If S is smaller than T, the last
+    // extent is padded to a whole number of T's, so that each row starts at a T (e.g., a
+    // pack) boundary: in that case, the last extent of the view can be larger than n1 (n2).
+    // Release with release.
     //
-    // Example: Local 2d view of size (n, m_size).
+    // Example: Local 2d view of size (ntracers, nlev), in a workspace of packs.
     // Code:
-    //   const auto local_slot = workspace.take_n_size_block("local_slot",n);
-    //   const auto local_var  = Unmanaged2dViewT<ScalarT>(reinterpret_cast<ScalarT*>(local_slot.data()),
-    //                                                     n, m_sizes);
+    //   const auto q = workspace.template take_2d<Real>("q", ntracers, nlev);
     template <typename S=T>
     KOKKOS_INLINE_FUNCTION
-    Unmanaged<view_1d<S> > take_macro_block(const char* name, const int n_sub_blocks) const;
+    Unmanaged<view_2d<S> > take_2d(const char* name, const int n0, const int n1) const;
+
+    template <typename S=T>
+    KOKKOS_INLINE_FUNCTION
+    Unmanaged<view_3d<S> > take_3d(const char* name, const int n0, const int n1, const int n2) const;
 
     // Combines reset and take_many_contiguous_unsafe. This is the most-performant
     // option for a kernel to use N sub-blocks that are needed for the duration of the
@@ -229,10 +522,16 @@ class WorkspaceManager
     // Release an individual sub-block.
     template <typename View>
     KOKKOS_FORCEINLINE_FUNCTION
-    void release(const View& space, std::enable_if<View::rank == 1>* = 0) const
+    void release(const View& space, std::enable_if_t<View::rank == 1>* = 0) const
     { release_impl<typename View::value_type>(space); }
 
-    // Release several contiguous sub-blocks.
+    // Release a view obtained from take_2d/take_3d.
+    template <typename View>
+    KOKKOS_FORCEINLINE_FUNCTION
+    void release(const View& space, std::enable_if_t<View::rank == 2 || View::rank == 3>* = 0) const
+    { release_nd_impl<typename View::value_type>(space.data(), space.size()); }
+
+    // Release several contiguous sub-blocks (of the default class).
     template <size_t N, typename S=T>
     KOKKOS_INLINE_FUNCTION
     void release_many_contiguous(const view_1d_ptr_array<S, N>& ptrs) const;
@@ -254,6 +553,11 @@ class WorkspaceManager
     KOKKOS_INLINE_FUNCTION
     void reset() const;
 
+    // Number of free sub-blocks of block class c. Only meant for testing/debugging,
+    // since it walks the whole free list.
+    KOKKOS_INLINE_FUNCTION
+    int get_num_free(const int c) const;
+
     // Print the linked list. Obviously not a device function.
     void print() const;
 
@@ -273,6 +577,29 @@ class WorkspaceManager
     KOKKOS_INLINE_FUNCTION
     void release_impl(const Unmanaged<view_1d<S> >& space) const;
 
+    template <typename S>
+    KOKKOS_INLINE_FUNCTION
+    void release_nd_impl(S* data, const int nelems) const;
+
+    // Head of the free list of block class c
+    KOKKOS_FORCEINLINE_FUNCTION
+    int& next_slot(const int c) const
+    { return m_heads[c]; }
+
+    // Reset the free lists of all block classes but the default one
+    KOKKOS_INLINE_FUNCTION
+    void reset_non_default_classes() const;
+
+    // If usage is tracked, change the number of sub-blocks of class c in use by
+    // change_by, and update its high-water mark. Call from within a single(PerTeam).
+    KOKKOS_FORCEINLINE_FUNCTION
+    void change_usage(const int c, const int change_by) const;
+
+    // Same as above, but set the number of sub-blocks of the default class in use
+    // to num_used, and of all the other classes to 0.
+    KOKKOS_INLINE_FUNCTION
+    void reset_usage(const int num_used) const;
+
 #ifndef NDEBUG
     template <typename S>
     KOKKOS_INLINE_FUNCTION
@@ -309,12 +636,19 @@ class WorkspaceManager
     KOKKOS_INLINE_FUNCTION
     Workspace(const WorkspaceManager& parent, int ws_idx, const MemberType& team, const char* ws_name);
 
+    // Same as above, but on the given workspace memory and free list heads
+    KOKKOS_INLINE_FUNCTION
+    Workspace(const WorkspaceManager& parent, int ws_idx, const MemberType& team, const char* ws_name,
+              T* row, int* heads);
+
     friend struct unit_test::UnitWrap;
     friend class WorkspaceManager;
 
     const WorkspaceManager& m_parent;
     const MemberType& m_team;
     const int m_ws_idx; // Workspace idx for m_team
+    T* const m_row;     // The memory of the workspace (in global or team scratch memory)
+    int* const m_heads; // The heads of the free lists of the block classes
     int& m_next_slot; // the next free ws slot to allocate
     const char* m_ws_name;
   }; // class Workspace
@@ -324,6 +658,7 @@ class WorkspaceManager
 #endif
 
   friend struct unit_test::UnitWrap;
+  friend class WorkspaceArena<DeviceT>;
 
   template <typename S=T>
   KOKKOS_FORCEINLINE_FUNCTION
@@ -341,14 +676,75 @@ class WorkspaceManager
 
   template <typename S=T>
   KOKKOS_FORCEINLINE_FUNCTION
-  Unmanaged<view_1d<S> > get_space_in_slot(const int team_idx, const int slot) const;
+  Unmanaged<view_1d<S> > get_space_in_slot(T* row, const int slot) const;
+
+  // Same as above, but for a slot of any block class c. Here, slot is the
+  // global slot index, i.e., the one stored in the slot metadata.
+  template <typename S=T>
+  KOKKOS_FORCEINLINE_FUNCTION
+  Unmanaged<view_1d<S> > get_space_in_slot(T* row, const int c, const int slot, const int nelems) const;
+
+  // Length of a row of n S's, padded to a whole number of T's if S is smaller than T
+  template <typename S>
+  KOKKOS_FORCEINLINE_FUNCTION
+  static constexpr int get_padded_len(const int n);
+
+  // Number of contiguous sub-blocks of the default class needed to store nelems S's
+  template <typename S>
+  KOKKOS_FORCEINLINE_FUNCTION
+  int get_num_sub_blocks(const int nelems) const;
+
+  // The block class of the slot with global index slot
+  KOKKOS_FORCEINLINE_FUNCTION
+  int get_slot_class(const int slot) const;
+
+  // The smallest block class with sub-blocks of at least nbytes bytes, and a free
+  // sub-block in the workspace with free list heads heads, or -1 if there is none.
+  KOKKOS_INLINE_FUNCTION
+  int get_fitting_class(const int* heads, const size_t nbytes) const;
+
+  KOKKOS_INLINE_FUNCTION
+  void init_slot_metadata(T* row, const int slot) const;
 
   KOKKOS_INLINE_FUNCTION
-  void init_slot_metadata(const int ws_idx, const int slot) const;
+  void init_slot_metadata(T* row, const int c, const int slot) const;
+
+  // Whether get_workspace needs to acquire a workspace slot, i.e., always in global
+  // memory mode, and only for the per-workspace statistics in team scratch mode
+  KOKKOS_FORCEINLINE_FUNCTION
+  bool needs_ws_idx() const;
 
   void init_all_metadata(const int max_ws_idx, const int max_used);
 
-  void compute_internals(const int size, const int max_used);
+  void compute_internals(const std::vector<BlockClass>& classes);
+
+#ifndef NDEBUG
+  // If this WSM uses the memory of a WorkspaceArena, record a conflict if it is not
+  // the active WSM of the arena (see WorkspaceArena::activate).
+  KOKKOS_INLINE_FUNCTION
+  void check_arena() const;
+#endif
+
+  // Number of T's needed to store the metadata of a slot
+  static int get_reserve ()
+  { return (sizeof(T) > 2*sizeof(int)) ? 1 : (2*sizeof(int) + sizeof(T) - 1)/sizeof(T); }
+
+  // Number of T's needed by each workspace
+  static int get_row_length (const std::vector<BlockClass>& classes);
+
+#ifdef EKAT_WSM_GUARD
+  // Fill the nelems S's at data with signaling NaN's (or invalid values, for non floating point S)
+  template <typename S>
+  KOKKOS_INLINE_FUNCTION
+  static void poison(S* data, const int nelems);
+
+  // Write/check the canary after the data of a sub-block of class c
+  KOKKOS_INLINE_FUNCTION
+  void set_canary(T* data, const int c) const;
+
+  KOKKOS_INLINE_FUNCTION
+  bool is_canary_intact(const T* data, const int c) const;
+#endif
 
   //
   // data
@@ -359,9 +755,31 @@ class WorkspaceManager
          m_max_names    = 256
   };
 
+  // Number of T's of the canary after each sub-block (at least 8 bytes), see EKAT_WSM_GUARD
+#ifdef EKAT_WSM_GUARD
+  enum { m_guard = (8 + sizeof(T) - 1)/sizeof(T) };
+  static constexpr unsigned char m_canary = 0xA5;
+#else
+  enum { m_guard = 0 };
+#endif
+
   TeamUtils<T,ExeSpace> m_tu;
-  int m_max_ws_idx, m_reserve, m_size, m_total, m_max_used;
+  int m_max_ws_idx, m_reserve, m_size, m_total, m_max_used, m_row_length;
+  // Block classes. Class c has m_class_max_used[c] slots of m_class_size[c]+m_reserve+m_guard T's,
+  // starting at m_class_offset[c] in each workspace, with global slot indices starting at
+  // m_class_base[c]. Class 0 (the default class) has size m_size and m_max_used slots.
+  int m_num_classes, m_num_slots, m_next_stride;
+  Kokkos::Array<int, MAX_BLOCK_CLASSES> m_class_size, m_class_max_used, m_class_offset, m_class_base;
   bool is_initialized=false;
+  // If m_track_usage, m_usage(ws,c,0) is the number of sub-blocks of class c in use
+  // in workspace ws, and m_usage(ws,c,1) its high-water mark. Unlike the debug-only
+  // stats below, these are available in release builds too.
+  bool m_track_usage=false;
+  view_3d<int> m_usage;
+  // If m_use_scratch, the workspaces are in the team scratch memory at m_scratch_level
+  // (see use_team_scratch), and m_data is empty.
+  bool m_use_scratch=false;
+  int m_scratch_level=0;
 #ifndef NDEBUG
   view_1d<int> m_num_used;
   view_1d<int> m_high_water;
@@ -369,6 +787,11 @@ class WorkspaceManager
   view_3d<char> m_curr_names;
   view_3d<char> m_all_names;
   view_3d<int> m_counts;
+  // If this WSM was set up by a WorkspaceArena, its id in the arena (-1 otherwise),
+  // and the arena active WSM id and conflict record
+  int m_arena_id = -1;
+  view_1d<int> m_arena_active;
+  view_1d<int> m_arena_conflicts;
 #endif
   view_1d<int> m_next_slot;
   view_2d<T> m_data;
@@ -0,0 +1,260 @@
+#ifndef EKAT_WORKSPACE_ARENA_HPP
+#define EKAT_WORKSPACE_ARENA_HPP
+
+#include "ekat_workspace.hpp"
+#include "ekat_kokkos_types.hpp"
+#include "ekat_assert.hpp"
+
+#include <algorithm>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace ekat {
+
+/*
+ * WorkspaceArena is a host-side utility to share a single memory buffer
+ * among several WorkspaceManager's whose kernels never run at the same time
+ * (e.g., the WSMs of different parameterizations, which run one after the
+ * other). Rather than each WSM allocating its own data, sized for its peak,
+ * the arena allocates once the max of the bytes needed by each of them.
+ *
+ * Usage: register each WSM with add, passing the same arguments as to
+ * WorkspaceManager::setup, then call allocate, which allocates the buffer
+ * and sets up all the registered WSMs on it. Since each WSM keeps its
+ * metadata in its workspaces, before running kernels with one WSM, call
+ * activate on it: if another WSM of the arena was the active one, this
+ * re-initializes the WSM (as in WorkspaceManager::reset_internals). E.g.,
+ *
+ *   WorkspaceArena<> arena;
+ *   const int micro = arena.add("micro", wsm_micro, nlev, 8, policy);
+ *   const int rad   = arena.add("rad",   wsm_rad, { {nlev,4}, {3*nlev,2} }, policy);
+ *   arena.allocate();
+ *   ...
+ *   arena.activate(micro);
+ *   // kernels using wsm_micro
+ *   arena.activate(rad);
+ *   // kernels using wsm_rad
+ *
+ * The registered WSMs must not be moved or destroyed while the arena is in use,
+ * and the arena must outlive them, since they do not own the arena memory.
+ *
+ * Only the active WSM can have workspaces in use. In debug builds, the WSMs
+ * record any use while not active (e.g., taking workspaces of two of them in
+ * the same kernel, or forgetting to call activate), and validate throws if
+ * there was any. In release builds, such a use silently corrupts the workspaces.
+ */
+
+template <typename DeviceT=DefaultDevice>
+class WorkspaceArena
+{
+ public:
+
+  //
+  // ---------- Types ---------
+  //
+
+  using Device     = DeviceT;
+  using TeamPolicy = typename KokkosTypes<Device>::TeamPolicy;
+
+  template <typename S>
+  using view_1d = typename KokkosTypes<Device>::template view_1d<S>;
+
+  //
+  // ------- public API ---------
+  //
+
+  // Constructor, call from host
+  WorkspaceArena() = default;
+
+  // call from host.
+  //
+  // Register wsm, to be set up (as in WorkspaceManager::setup) on the arena
+  // memory when allocate is called. Returns the id of wsm in the arena.
+  template <typename T>
+  int add (const std::string& name, WorkspaceManager<T,Device>& wsm,
+           int size, int max_used, TeamPolicy policy,
+           const double& overprov_factor=WorkspaceManager<T,Device>::GPU_DEFAULT_OVERPROVISION_FACTOR(),
+           const WsSlotAssignment slot_assignment=WsSlotAssignment::Default,
+           const bool track_usage=false)
+  {
+    return add(name, wsm, { {size, max_used} }, policy, overprov_factor, slot_assignment, track_usage);
+  }
+
+  template <typename T>
+  int add (const std::string& name, WorkspaceManager<T,Device>& wsm,
+           const std::vector<typename WorkspaceManager<T,Device>::BlockClass>& classes, TeamPolicy policy,
+           const double& overprov_factor=WorkspaceManager<T,Device>::GPU_DEFAULT_OVERPROVISION_FACTOR(),
+           const WsSlotAssignment slot_assignment=WsSlotAssignment::Default,
+           const bool track_usage=false);
+
+  // call from host.
+  //
+  // Allocate the arena memory (the max of the bytes needed by the registered WSMs),
+  // and set up all the registered WSMs on it.
+  void allocate ();
+
+  // call from host.
+  //
+  // Make the WSM with the given id the one that can use the arena memory, re-initializing
+  // it if it was not the active one already. Kernels using other WSMs of the arena must
+  // have completed, since this fences.
+  void activate (const int id);
+
+  // Id of the active WSM, or -1 if none was activated yet
+  int get_active () const { return m_active; }
+
+  // call from host.
+  //
+  // In debug builds, throw if any WSM of this arena took workspaces while not
+  // active, in any kernel run so far. In release builds, this is a no-op.
+  void validate () const;
+
+  int get_num_managers () const { return m_entries.size(); }
+  bool is_allocated () const { return m_allocated; }
+
+  // Bytes needed by the WSM with the given id
+  size_t get_bytes_needed (const int id) const;
+
+  // Bytes allocated by the arena (available before allocate too)
+  size_t get_total_bytes () const;
+
+  // Bytes the registered WSMs would allocate if they did not share memory
+  size_t get_separate_bytes () const;
+
+ private:
+
+  struct Entry {
+    std::string name;
+    size_t bytes;
+    // Set up the WSM on the arena memory. In debug builds, also hand it the arena guard.
+    std::function<void(const WorkspaceArena&)> setup;
+    // Re-initialize the WSM metadata, which other WSMs may have overwritten
+    std::function<void()> reset;
+  };
+
+  std::vector<Entry> m_entries;
+  bool m_allocated = false;
+  int m_active = -1;
+  view_1d<char> m_data;
+#ifndef NDEBUG
+  // The active id, and the (num conflicts, active id, offending id) record,
+  // shared by all the WSMs of the arena (see WorkspaceManager::check_arena)
+  view_1d<int> m_active_dev;
+  view_1d<int> m_conflicts;
+#endif
+};
+
+template <typename D>
+template <typename T>
+int WorkspaceArena<D>::
+add (const std::string& name, WorkspaceManager<T,Device>& wsm,
+     const std::vector<typename WorkspaceManager<T,Device>::BlockClass>& classes, TeamPolicy policy,
+     const double& overprov_factor, const WsSlotAssignment slot_assignment, const bool track_usage)
+{
+  using WSM = WorkspaceManager<T,Device>;
+
+  EKAT_REQUIRE_MSG (not m_allocated,
+      "Error! Cannot add WorkspaceManager '" + name + "' to a WorkspaceArena that was already allocated.\n");
+
+  const int id = m_entries.size();
+  Entry e;
+  e.name  = name;
+  e.bytes = WSM::get_total_bytes_needed(classes, policy, overprov_factor);
+  e.setup = [&wsm, classes, policy, overprov_factor, slot_assignment, track_usage, id] (const WorkspaceArena& arena) {
+    wsm.setup(reinterpret_cast<T*>(arena.m_data.data()), classes, policy, overprov_factor, slot_assignment, track_usage);
+#ifndef NDEBUG
+    wsm.m_arena_id        = id;
+    wsm.m_arena_active    = arena.m_active_dev;
+    wsm.m_arena_conflicts = arena.m_conflicts;
+#endif
+  };
+  e.reset = [&wsm] () {
+    wsm.reset_internals();
+  };
+  m_entries.push_back(e);
+  return id;
+}
+
+template <typename D>
+void WorkspaceArena<D>::allocate ()
+{
+  EKAT_REQUIRE_MSG (not m_allocated, "Error! WorkspaceArena was already allocated.\n");
+
+  m_data = view_1d<char>(Kokkos::ViewAllocateWithoutInitializing("WorkspaceArena.m_data"), get_total_bytes());
+#ifndef NDEBUG
+  m_active_dev = view_1d<int>("WorkspaceArena.m_active", 1);
+  m_conflicts  = view_1d<int>("WorkspaceArena.m_conflicts", 3);
+  Kokkos::deep_copy(m_active_dev, -1);
+#endif
+  for (const auto& e : m_entries) {
+    e.setup(*this);
+  }
+  // Each setup overwrote the metadata of the previous WSMs, so none is active yet
+  m_active = -1;
+  m_allocated = true;
+}
+
+template <typename D>
+void WorkspaceArena<D>::activate (const int id)
+{
+  EKAT_REQUIRE_MSG (m_allocated, "Error! WorkspaceArena not yet allocated.\n");
+  EKAT_REQUIRE_MSG (id >= 0 && id < get_num_managers(), "Error! Invalid WorkspaceArena id.\n");
+
+  if (id == m_active) {
+    return;
+  }
+
+  Kokkos::fence();
+  m_entries[id].reset();
+  m_active = id;
+#ifndef NDEBUG
+  Kokkos::deep_copy(m_active_dev, id);
+#endif
+}
+
+template <typename D>
+void WorkspaceArena<D>::validate () const
+{
+  EKAT_REQUIRE_MSG (m_allocated, "Error! WorkspaceArena not yet allocated.\n");
+#ifndef NDEBUG
+  Kokkos::fence();
+  const auto conflicts = Kokkos::create_mirror_view(m_conflicts);
+  Kokkos::deep_copy(conflicts, m_conflicts);
+  EKAT_REQUIRE_MSG (conflicts(0) == 0,
+      "Error! WorkspaceManager '" + m_entries[conflicts(2)].name + "' took workspaces from a WorkspaceArena while " +
+      (conflicts(1) < 0 ? std::string("no manager") : "'" + m_entries[conflicts(1)].name + "'") +
+      " was the active one (" + std::to_string(conflicts(0)) + " conflicting workspace acquisitions).\n");
+#endif
+}
+
+template <typename D>
+size_t WorkspaceArena<D>::get_bytes_needed (const int id) const
+{
+  EKAT_REQUIRE_MSG (id >= 0 && id < get_num_managers(), "Error! Invalid WorkspaceArena id.\n");
+  return m_entries[id].bytes;
+}
+
+template <typename D>
+size_t WorkspaceArena<D>::get_total_bytes () const
+{
+  size_t bytes = 0;
+  for (const auto& e : m_entries) {
+    bytes = std::max(bytes, e.bytes);
+  }
+  return bytes;
+}
+
+template <typename D>
+size_t WorkspaceArena<D>::get_separate_bytes () const
+{
+  size_t bytes = 0;
+  for (const auto& e : m_entries) {
+    bytes += e.bytes;
+  }
+  return bytes;
+}
+
+} // namespace ekat
+
+#endif // EKAT_WORKSPACE_ARENA_HPP
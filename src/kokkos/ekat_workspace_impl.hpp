@@ -11,6 +11,7 @@
 #include "ekat_math_utils.hpp"
 #include "ekat_assert.hpp"
 
+#include <algorithm>
 #include <map>
 
 namespace ekat {
@@ -22,48 +23,130 @@ namespace ekat {
 
 template <typename T, typename D>
 WorkspaceManager<T, D>::WorkspaceManager(int size, int max_used, TeamPolicy policy,
-                                         const double& overprov_factor)
+                                         const double& overprov_factor,
+                                         const WsSlotAssignment slot_assignment,
+                                         const bool track_usage)
 {
-  setup(size, max_used, policy, overprov_factor);
+  setup(size, max_used, policy, overprov_factor, slot_assignment, track_usage);
 }
 
 template <typename T, typename D>
 WorkspaceManager<T, D>::WorkspaceManager(T* data, int size, int max_used,
-                                         TeamPolicy policy, const double& overprov_factor)
+                                         TeamPolicy policy, const double& overprov_factor,
+                                         const WsSlotAssignment slot_assignment,
+                                         const bool track_usage)
 {
-  setup(data, size, max_used, policy, overprov_factor);
+  setup(data, size, max_used, policy, overprov_factor, slot_assignment, track_usage);
 }
 
 template <typename T, typename D>
-void WorkspaceManager<T, D>::compute_internals(const int size, const int max_used)
+WorkspaceManager<T, D>::WorkspaceManager(const std::vector<BlockClass>& classes,
+                                         TeamPolicy policy, const double& overprov_factor,
+                                         const WsSlotAssignment slot_assignment,
+                                         const bool track_usage)
 {
+  setup(classes, policy, overprov_factor, slot_assignment, track_usage);
+}
+
+template <typename T, typename D>
+WorkspaceManager<T, D>::WorkspaceManager(T* data, const std::vector<BlockClass>& classes,
+                                         TeamPolicy policy, const double& overprov_factor,
+                                         const WsSlotAssignment slot_assignment,
+                                         const bool track_usage)
+{
+  setup(data, classes, policy, overprov_factor, slot_assignment, track_usage);
+}
+
+template <typename T, typename D>
+void WorkspaceManager<T, D>::compute_internals(const std::vector<BlockClass>& classes)
+{
+  EKAT_REQUIRE_MSG (classes.size() > 0 && classes.size() <= MAX_BLOCK_CLASSES,
+      "Error! The number of workspace block classes must be in [1, " + std::to_string(MAX_BLOCK_CLASSES) + "].\n");
+
   m_max_ws_idx = m_tu.get_num_ws_slots();
-  m_reserve    = (sizeof(T) > 2*sizeof(int)) ?
-                  1 : (2*sizeof(int) + sizeof(T) - 1)/sizeof(T);
-  m_size       = size;
-  m_total      = m_size + m_reserve;
-  m_max_used   = max_used;
+  m_reserve    = get_reserve();
+  m_num_classes = classes.size();
+  m_num_slots   = 0;
+  int offset = 0;
+  for (int c = 0; c < m_num_classes; ++c) {
+    EKAT_REQUIRE_MSG (classes[c].size >= 0 && classes[c].max_used >= 0,
+        "Error! Invalid (negative) size or max_used for workspace block class " + std::to_string(c) + ".\n");
+    m_class_size[c]     = classes[c].size;
+    m_class_max_used[c] = classes[c].max_used;
+    m_class_offset[c]   = offset;
+    m_class_base[c]     = m_num_slots;
+    offset      += (classes[c].size + m_reserve + m_guard)*classes[c].max_used;
+    m_num_slots += classes[c].max_used;
+  }
+  m_size       = m_class_size[0];
+  m_total      = m_size + m_reserve + m_guard;
+  m_max_used   = m_class_max_used[0];
+  m_row_length = offset;
+  // Keep the free list heads of different workspaces on different cache lines on CPU
+  m_next_stride = m_num_classes > m_pad_factor ? m_num_classes : static_cast<int>(m_pad_factor);
 #ifndef NDEBUG
   m_num_used   = decltype(m_num_used)   ("Workspace.m_num_used",   m_max_ws_idx);
   m_high_water = decltype(m_high_water) ("Workspace.m_high_water", m_max_ws_idx);
-  m_active     = decltype(m_active)     ("Workspace.m_active",     m_max_ws_idx, m_max_used);
-  m_curr_names = decltype(m_curr_names) ("Workspace.m_curr_names", m_max_ws_idx, m_max_used, m_max_name_len);
+  m_active     = decltype(m_active)     ("Workspace.m_active",     m_max_ws_idx, m_num_slots);
+  m_curr_names = decltype(m_curr_names) ("Workspace.m_curr_names", m_max_ws_idx, m_num_slots, m_max_name_len);
   m_all_names  = decltype(m_all_names)  ("Workspace.m_all_names",  m_max_ws_idx, m_max_names, m_max_name_len);
   // A name's index in m_all_names is used to index into m_counts
   m_counts     = decltype(m_counts)     ("Workspace.m_counts",     m_max_ws_idx, m_max_names, 2);
 #endif
-  m_next_slot  = decltype(m_next_slot)  ("Workspace.m_next_slot",  m_max_ws_idx*m_pad_factor);
+  m_next_slot  = decltype(m_next_slot)  ("Workspace.m_next_slot",  m_max_ws_idx*m_next_stride);
+  m_usage      = decltype(m_usage)      ("Workspace.m_usage",      m_track_usage ? m_max_ws_idx : 0, m_num_classes, 2);
+}
+
+template <typename T, typename D>
+int WorkspaceManager<T, D>::get_row_length(const std::vector<BlockClass>& classes)
+{
+  int len = 0;
+  for (const auto& bc : classes) {
+    len += (bc.size + get_reserve() + m_guard)*bc.max_used;
+  }
+  return len;
 }
 
 template <typename T, typename D>
 int WorkspaceManager<T, D>::get_total_bytes_needed(int size, int max_used, TeamPolicy policy,
                                                    const double& overprov_factor)
+{
+  return get_total_bytes_needed({ {size, max_used} }, policy, overprov_factor);
+}
+
+template <typename T, typename D>
+int WorkspaceManager<T, D>::get_total_bytes_needed(const std::vector<BlockClass>& classes, TeamPolicy policy,
+                                                   const double& overprov_factor)
 {
   TeamUtils<T,ExeSpace> tu(policy, overprov_factor);
-  const int reserve_slots = (sizeof(T) > 2*sizeof(int)) ?
-                             1 : (2*sizeof(int) + sizeof(T) - 1)/sizeof(T);
-  const int total_slots = size + reserve_slots;
-  return tu.get_num_ws_slots()*total_slots*max_used*sizeof(T);
+  return tu.get_num_ws_slots()*get_row_length(classes)*sizeof(T);
+}
+
+template <typename T, typename D>
+typename WorkspaceManager<T, D>::UsageSummary
+WorkspaceManager<T, D>::get_usage_summary() const
+{
+  EKAT_REQUIRE_MSG (is_initialized, "Error! WorkspaceManager not yet inited.\n");
+  EKAT_REQUIRE_MSG (m_track_usage,
+      "Error! WorkspaceManager usage is not tracked. Call setup with track_usage=true.\n");
+
+  const auto host_usage = Kokkos::create_mirror_view(m_usage);
+  Kokkos::deep_copy(host_usage, m_usage);
+
+  UsageSummary summary;
+  summary.num_ws = m_max_ws_idx;
+  for (int c = 0; c < m_num_classes; ++c) {
+    typename UsageSummary::ClassUsage cu;
+    cu.size       = m_class_size[c];
+    cu.max_used   = m_class_max_used[c];
+    cu.high_water = 0;
+    for (int t = 0; t < m_max_ws_idx; ++t) {
+      cu.ws_high_water.push_back(host_usage(t, c, 1));
+      cu.high_water = std::max(cu.high_water, host_usage(t, c, 1));
+    }
+    summary.classes.push_back(cu);
+  }
+  return summary;
 }
 
 template <typename T, typename D>
@@ -71,13 +154,28 @@ void WorkspaceManager<T, D>::report() const
 {
   EKAT_ASSERT_MSG (is_initialized, "Error! WorkspaceManager not yet inited.\n");
 
+  if (m_track_usage) {
+    const auto summary = get_usage_summary();
+    std::cout << "\nWS block class usage (size, max_used, high-water over all workspaces):" << std::endl;
+    for (const auto& cu : summary.classes) {
+      std::cout << "  (" << cu.size << ", " << cu.max_used << ", " << cu.high_water << ")" << std::endl;
+    }
+  }
+
 #ifndef NDEBUG
   auto host_num_used   = Kokkos::create_mirror_view(m_num_used);
   auto host_high_water = Kokkos::create_mirror_view(m_high_water);
   auto host_all_names  = Kokkos::create_mirror_view(m_all_names);
   auto host_counts     = Kokkos::create_mirror_view(m_counts);
 
-  std::cout << "\nWS usage (capped at " << m_max_used << "): " << std::endl;
+  if (m_num_classes > 1) {
+    std::cout << "\nWS block classes (size, max_used):";
+    for (int c = 0; c < m_num_classes; ++c) {
+      std::cout << " (" << m_class_size[c] << ", " << m_class_max_used[c] << ")";
+    }
+    std::cout << std::endl;
+  }
+  std::cout << "\nWS usage (capped at " << m_num_slots << "): " << std::endl;
   for (int t = 0; t < m_max_ws_idx; ++t) {
     std::cout << "WS " << t << " currently using " << host_num_used(t) << std::endl;
     std::cout << "WS " << t << " high-water " << host_high_water(t) << std::endl;
@@ -129,42 +227,94 @@ void WorkspaceManager<T, D>::report() const
 
 template <typename T, typename D>
 void WorkspaceManager<T, D>::setup (int size, int max_used, TeamPolicy policy,
-                                    const double& overprov_factor)
+                                    const double& overprov_factor,
+                                    const WsSlotAssignment slot_assignment,
+                                    const bool track_usage)
+{
+  setup(std::vector<BlockClass>{ {size, max_used} }, policy, overprov_factor, slot_assignment, track_usage);
+}
+
+template <typename T, typename D>
+void WorkspaceManager<T, D>::setup (T* data, int size, int max_used, TeamPolicy policy,
+                                    const double& overprov_factor,
+                                    const WsSlotAssignment slot_assignment,
+                                    const bool track_usage)
 {
-  m_tu = TeamUtils<T,ExeSpace>(policy, overprov_factor);
+  setup(data, std::vector<BlockClass>{ {size, max_used} }, policy, overprov_factor, slot_assignment, track_usage);
+}
 
-  compute_internals(size, max_used);
+template <typename T, typename D>
+void WorkspaceManager<T, D>::setup (const std::vector<BlockClass>& classes, TeamPolicy policy,
+                                    const double& overprov_factor,
+                                    const WsSlotAssignment slot_assignment,
+                                    const bool track_usage)
+{
+  m_tu = TeamUtils<T,ExeSpace>(policy, overprov_factor, slot_assignment);
+  m_track_usage = track_usage;
+  m_use_scratch = false;
+
+  compute_internals(classes);
   m_data = decltype(m_data) (Kokkos::ViewAllocateWithoutInitializing("Workspace.m_data"),
-                             m_max_ws_idx, m_total*m_max_used);
-  init_all_metadata(m_max_ws_idx, m_max_used);
+                             m_max_ws_idx, get_row_length(classes));
+  init_all_metadata(m_max_ws_idx, m_num_slots);
 
   is_initialized = true;
 }
 
 template <typename T, typename D>
-void WorkspaceManager<T, D>::setup (T* data, int size, int max_used, TeamPolicy policy,
-                                    const double& overprov_factor)
+void WorkspaceManager<T, D>::setup (T* data, const std::vector<BlockClass>& classes, TeamPolicy policy,
+                                    const double& overprov_factor,
+                                    const WsSlotAssignment slot_assignment,
+                                    const bool track_usage)
 {
-  m_tu = TeamUtils<T,ExeSpace>(policy, overprov_factor);
+  m_tu = TeamUtils<T,ExeSpace>(policy, overprov_factor, slot_assignment);
+  m_track_usage = track_usage;
+  m_use_scratch = false;
 
-  compute_internals(size, max_used);
-  m_data = decltype(m_data) (data, m_max_ws_idx, m_total*m_max_used);
-  init_all_metadata(m_max_ws_idx, m_max_used);
+  compute_internals(classes);
+  m_data = decltype(m_data) (data, m_max_ws_idx, get_row_length(classes));
+  init_all_metadata(m_max_ws_idx, m_num_slots);
 
   is_initialized = true;
 }
 
+template <typename T, typename D>
+bool WorkspaceManager<T, D>::use_team_scratch(TeamPolicy& policy, const int level)
+{
+  EKAT_REQUIRE_MSG (is_initialized, "Error! WorkspaceManager not yet inited.\n");
+  EKAT_REQUIRE_MSG (level == 0 || level == 1, "Error! Invalid team scratch level " + std::to_string(level) + ".\n");
+
+  const size_t bytes = get_team_scratch_size();
+  if (bytes > static_cast<size_t>(TeamPolicy::scratch_size_max(level))) {
+    return false;
+  }
+
+  policy.set_scratch_size(level, Kokkos::PerTeam(bytes));
+  m_use_scratch   = true;
+  m_scratch_level = level;
+  m_data = decltype(m_data) ();
+  return true;
+}
+
+template <typename T, typename D>
+size_t WorkspaceManager<T, D>::get_team_scratch_size() const
+{
+  EKAT_REQUIRE_MSG (is_initialized, "Error! WorkspaceManager not yet inited.\n");
+  return scratch_view_1d<T>::shmem_size(m_row_length) + scratch_view_1d<int>::shmem_size(m_num_classes);
+}
+
 template <typename T, typename D>
 void WorkspaceManager<T, D>::reset_internals()
 {
 #ifndef NDEBUG
   Kokkos::deep_copy(m_active, false);
   Kokkos::deep_copy(m_counts, 0);
+  Kokkos::deep_copy(m_num_used, 0);
   Kokkos::deep_copy(m_high_water, 0);
   Kokkos::deep_copy(m_next_slot, 0);
 #endif
 
-  auto policy = TeamPolicyFactory<ExeSpace>::get_default_team_policy(m_max_ws_idx, m_max_used);
+  auto policy = TeamPolicyFactory<ExeSpace>::get_default_team_policy(m_max_ws_idx, m_num_slots);
   Kokkos::parallel_for(
     "WorkspaceManager reset",
     policy,
@@ -177,7 +327,22 @@ typename WorkspaceManager<T, D>::Workspace
 WorkspaceManager<T, D>::get_workspace(const MemberType& team, const char* ws_name) const
 {
   EKAT_KERNEL_ASSERT_MSG (is_initialized, "Error! WorkspaceManager not yet inited.\n");
-  return Workspace(*this, m_tu.get_workspace_idx(team), team, ws_name);
+  const int ws_idx = needs_ws_idx() ? m_tu.get_workspace_idx(team) : 0;
+#ifndef NDEBUG
+  if (m_arena_id >= 0) {
+    Kokkos::single(Kokkos::PerTeam(team), [&] () {
+      check_arena();
+    });
+  }
+#endif
+  if (m_use_scratch) {
+    // The team owns this memory for the duration of the kernel. Every thread of the
+    // team gets the same pointers, since they all make the same scratch allocations.
+    const scratch_view_1d<T>   row  (team.team_scratch(m_scratch_level), m_row_length);
+    const scratch_view_1d<int> heads(team.team_scratch(m_scratch_level), m_num_classes);
+    return Workspace(*this, ws_idx, team, ws_name, row.data(), heads.data());
+  }
+  return Workspace(*this, ws_idx, team, ws_name);
 }
 
 
@@ -186,9 +351,38 @@ KOKKOS_INLINE_FUNCTION
 void WorkspaceManager<T, D>::release_workspace(const MemberType& team, const Workspace& ws) const
 {
   EKAT_KERNEL_ASSERT_MSG (is_initialized, "Error! WorkspaceManager not yet inited.\n");
-  m_tu.release_workspace_idx(team, ws.m_ws_idx);
+  if (needs_ws_idx()) {
+    m_tu.release_workspace_idx(team, ws.m_ws_idx);
+  }
 }
 
+template <typename T, typename D>
+KOKKOS_FORCEINLINE_FUNCTION
+bool WorkspaceManager<T, D>::needs_ws_idx() const
+{
+#ifndef NDEBUG
+  return true;
+#else
+  return !m_use_scratch || m_track_usage;
+#endif
+}
+
+#ifndef NDEBUG
+template <typename T, typename D>
+KOKKOS_INLINE_FUNCTION
+void WorkspaceManager<T, D>::check_arena() const
+{
+  const int active = m_arena_active(0);
+  if (active != m_arena_id) {
+    // Record the first conflict, and keep going: the arena reports it on the host
+    if (Kokkos::atomic_fetch_add(&m_arena_conflicts(0), 1) == 0) {
+      m_arena_conflicts(1) = active;
+      m_arena_conflicts(2) = m_arena_id;
+    }
+  }
+}
+#endif
+
 template <typename T, typename D>
 void WorkspaceManager<T, D>::init_all_metadata(const int max_ws_idx, const int max_used)
 {
@@ -204,9 +398,24 @@ template <typename T, typename D>
 KOKKOS_INLINE_FUNCTION
 void WorkspaceManager<T, D>::operator() (const MemberType& team) const
 {
-  Kokkos::parallel_for(
-    Kokkos::TeamVectorRange(team, m_max_used), [&] (int i) {
-      init_slot_metadata(team.league_rank(), i);
+  const int ws_idx = team.league_rank();
+  // In team scratch mode, get_workspace sets up the workspace memory
+  if (!m_use_scratch) {
+    T* const row = m_data.data() + ws_idx*m_row_length;
+    Kokkos::parallel_for(
+      Kokkos::TeamVectorRange(team, m_num_slots), [&] (int i) {
+        init_slot_metadata(row, get_slot_class(i), i);
+    });
+  }
+  Kokkos::single(Kokkos::PerTeam(team), [&] () {
+    for (int c = 0; c < m_num_classes; ++c) {
+      m_next_slot(m_next_stride*ws_idx + c) = m_class_base[c];
+      // Only reset the number of sub-blocks in use, so that the high-water marks
+      // cover the whole run, even if reset_internals is called at every iteration.
+      if (m_track_usage) {
+        m_usage(ws_idx, c, 0) = 0;
+      }
+    }
   });
 }
 
@@ -226,16 +435,18 @@ template <typename T, typename D>
 template <typename S>
 KOKKOS_FORCEINLINE_FUNCTION
 Unmanaged<typename WorkspaceManager<T, D>::template view_1d<S> >
-WorkspaceManager<T, D>::get_space_in_slot(const int team_idx, const int slot) const
+WorkspaceManager<T, D>::get_space_in_slot(T* row, const int slot) const
 {
   EKAT_KERNEL_ASSERT_MSG (is_initialized, "Error! WorkspaceManager not yet inited.\n");
 
   Unmanaged<view_1d<S> > space(
-    reinterpret_cast<S*>(&m_data(team_idx, slot*m_total) + m_reserve),
+    reinterpret_cast<S*>(row + slot*m_total + m_reserve),
     sizeof(T) == sizeof(S) ?
     m_size :
     (m_size*sizeof(T))/sizeof(S));
-#ifndef NDEBUG
+#if defined(EKAT_WSM_GUARD)
+  poison(space.data(), space.size());
+#elif !defined(NDEBUG)
   for (size_t k=0; k<space.size(); ++k) {
     space(k) = invalid<S>();
   }
@@ -243,23 +454,169 @@ WorkspaceManager<T, D>::get_space_in_slot(const int team_idx, const int slot) co
   return space;
 }
 
+template <typename T, typename D>
+template <typename S>
+KOKKOS_FORCEINLINE_FUNCTION
+Unmanaged<typename WorkspaceManager<T, D>::template view_1d<S> >
+WorkspaceManager<T, D>::get_space_in_slot(T* row, const int c, const int slot, const int nelems) const
+{
+  EKAT_KERNEL_ASSERT_MSG (is_initialized, "Error! WorkspaceManager not yet inited.\n");
+
+  const int offset = m_class_offset[c] + (slot - m_class_base[c])*(m_class_size[c] + m_reserve + m_guard);
+  Unmanaged<view_1d<S> > space(
+    reinterpret_cast<S*>(row + offset + m_reserve), nelems);
+#if defined(EKAT_WSM_GUARD)
+  poison(space.data(), space.size());
+#elif !defined(NDEBUG)
+  for (size_t k=0; k<space.size(); ++k) {
+    space(k) = invalid<S>();
+  }
+#endif
+  return space;
+}
+
+template <typename T, typename D>
+template <typename S>
+KOKKOS_FORCEINLINE_FUNCTION
+constexpr int WorkspaceManager<T, D>::get_padded_len(const int n)
+{
+  if constexpr (sizeof(S) < sizeof(T) && sizeof(T) % sizeof(S) == 0) {
+    constexpr int k = sizeof(T) / sizeof(S);
+    return ((n + k - 1) / k) * k;
+  } else {
+    return n;
+  }
+}
+
+template <typename T, typename D>
+template <typename S>
+KOKKOS_FORCEINLINE_FUNCTION
+int WorkspaceManager<T, D>::get_num_sub_blocks(const int nelems) const
+{
+  // n contiguous sub-blocks span n*m_total-m_reserve-m_guard T's, since only the
+  // metadata of the first one (and the canary of the last one) is needed
+  const int nt = (nelems*sizeof(S) + sizeof(T) - 1) / sizeof(T);
+  const int n = (nt + m_reserve + m_guard + m_total - 1) / m_total;
+  return n > 0 ? n : 1;
+}
+
+template <typename T, typename D>
+KOKKOS_FORCEINLINE_FUNCTION
+int WorkspaceManager<T, D>::get_slot_class(const int slot) const
+{
+  int c = 0;
+  while (c+1 < m_num_classes && slot >= m_class_base[c+1]) {
+    ++c;
+  }
+  return c;
+}
+
 template <typename T, typename D>
 KOKKOS_INLINE_FUNCTION
-void WorkspaceManager<T, D>::init_slot_metadata(const int ws_idx, const int slot) const
+int WorkspaceManager<T, D>::get_fitting_class(const int* heads, const size_t nbytes) const
 {
-  int* const metadata = reinterpret_cast<int*>(&m_data(ws_idx, slot*m_total));
+  int best = -1;
+  for (int c = 0; c < m_num_classes; ++c) {
+    const bool fits = m_class_size[c]*sizeof(T) >= nbytes;
+    const bool free = heads[c] < m_class_base[c] + m_class_max_used[c];
+    if (fits && free && (best < 0 || m_class_size[c] < m_class_size[best])) {
+      best = c;
+    }
+  }
+  return best;
+}
+
+template <typename T, typename D>
+KOKKOS_INLINE_FUNCTION
+void WorkspaceManager<T, D>::init_slot_metadata(T* row, const int slot) const
+{
+  int* const metadata = reinterpret_cast<int*>(row + slot*m_total);
   metadata[0] = slot;     // idx
   metadata[1] = slot + 1; // next
+#ifdef EKAT_WSM_GUARD
+  set_canary(row + slot*m_total + m_reserve, 0);
+#endif
+}
+
+template <typename T, typename D>
+KOKKOS_INLINE_FUNCTION
+void WorkspaceManager<T, D>::init_slot_metadata(T* row, const int c, const int slot) const
+{
+  const int offset = m_class_offset[c] + (slot - m_class_base[c])*(m_class_size[c] + m_reserve + m_guard);
+  int* const metadata = reinterpret_cast<int*>(row + offset);
+  metadata[0] = slot;     // idx
+  metadata[1] = slot + 1; // next (for the last slot of class c, this is the end of its list)
+#ifdef EKAT_WSM_GUARD
+  set_canary(row + offset + m_reserve, c);
+#endif
+}
+
+#ifdef EKAT_WSM_GUARD
+template <typename T, typename D>
+template <typename S>
+KOKKOS_INLINE_FUNCTION
+void WorkspaceManager<T, D>::poison(S* data, const int nelems)
+{
+  using scalar_t = typename ScalarTraits<S>::scalar_type;
+  S val;
+  if constexpr (ScalarTraits<scalar_t>::is_floating_point) {
+    val = S(Kokkos::Experimental::signaling_NaN_v<scalar_t>);
+  } else {
+    val = invalid<S>();
+  }
+  for (int k = 0; k < nelems; ++k) {
+    data[k] = val;
+  }
 }
 
+template <typename T, typename D>
+KOKKOS_INLINE_FUNCTION
+void WorkspaceManager<T, D>::set_canary(T* data, const int c) const
+{
+  unsigned char* const canary = reinterpret_cast<unsigned char*>(data + m_class_size[c]);
+  for (size_t b = 0; b < m_guard*sizeof(T); ++b) {
+    canary[b] = m_canary;
+  }
+}
+
+template <typename T, typename D>
+KOKKOS_INLINE_FUNCTION
+bool WorkspaceManager<T, D>::is_canary_intact(const T* data, const int c) const
+{
+  const unsigned char* const canary = reinterpret_cast<const unsigned char*>(data + m_class_size[c]);
+  for (size_t b = 0; b < m_guard*sizeof(T); ++b) {
+    if (canary[b] != m_canary) {
+      return false;
+    }
+  }
+  return true;
+}
+#endif
+
 template <typename T, typename D>
 KOKKOS_INLINE_FUNCTION
 WorkspaceManager<T, D>::Workspace::Workspace(
   const WorkspaceManager& parent, int ws_idx, const MemberType& team, const char* ws_name) :
+  Workspace(parent, ws_idx, team, ws_name,
+            parent.m_data.data() + ws_idx*parent.m_row_length,
+            &parent.m_next_slot(parent.m_next_stride*ws_idx))
+{}
+
+template <typename T, typename D>
+KOKKOS_INLINE_FUNCTION
+WorkspaceManager<T, D>::Workspace::Workspace(
+  const WorkspaceManager& parent, int ws_idx, const MemberType& team, const char* ws_name,
+  T* row, int* heads) :
   m_parent(parent), m_team(team), m_ws_idx(ws_idx),
-  m_next_slot(parent.m_next_slot(m_pad_factor*ws_idx)),
+  m_row(row), m_heads(heads),
+  m_next_slot(heads[0]),
   m_ws_name (ws_name)
-{}
+{
+  // A team scratch workspace starts out uninitialized
+  if (m_parent.m_use_scratch) {
+    reset();
+  }
+}
 
 template <typename T, typename D>
 KOKKOS_INLINE_FUNCTION
@@ -278,13 +635,47 @@ Unmanaged<typename WorkspaceManager<T, D>::template view_1d<S> > WorkspaceManage
   change_num_used(1);
 #endif
 
-  const auto space = m_parent.get_space_in_slot<S>(m_ws_idx, m_next_slot);
+  const auto space = m_parent.get_space_in_slot<S>(m_row, m_next_slot);
 
   // We need a barrier here so get_space_in_slot returns consistent results
   // w/in the team.
   m_team.team_barrier();
   Kokkos::single(Kokkos::PerTeam(m_team), [&] () {
     m_next_slot = m_parent.get_next<S>(space);
+    change_usage(0, 1);
+#ifndef NDEBUG
+    change_indv_meta<S>(space, name);
+#endif
+  });
+  // We need a barrier here so that a subsequent call to take or release
+  // starts with the metadata in the correct state.
+  m_team.team_barrier();
+
+  return space;
+}
+
+template <typename T, typename D>
+template <typename S>
+KOKKOS_INLINE_FUNCTION
+Unmanaged<typename WorkspaceManager<T, D>::template view_1d<S> > WorkspaceManager<T, D>::Workspace::take(
+  const char* name, const int nelems) const
+{
+#ifndef NDEBUG
+  change_num_used(1);
+#endif
+
+  const int c = m_parent.get_fitting_class(m_heads, nelems*sizeof(S));
+  EKAT_KERNEL_REQUIRE_MSG(c >= 0, "Error! No free workspace sub-block is large enough.\n");
+
+  int& next = next_slot(c);
+  const auto space = m_parent.template get_space_in_slot<S>(m_row, c, next, nelems);
+
+  // We need a barrier here so get_fitting_class and get_space_in_slot return
+  // consistent results w/in the team.
+  m_team.team_barrier();
+  Kokkos::single(Kokkos::PerTeam(m_team), [&] () {
+    next = m_parent.get_next<S>(space);
+    change_usage(c, 1);
 #ifndef NDEBUG
     change_indv_meta<S>(space, name);
 #endif
@@ -307,13 +698,13 @@ void WorkspaceManager<T, D>::Workspace::take_many_contiguous_unsafe(
   change_num_used(N);
   // Verify contiguous
   for (int n = 0; n < static_cast<int>(N) - 1; ++n) {
-    const auto space = m_parent.get_space_in_slot<S>(m_ws_idx, m_next_slot + n);
+    const auto space = m_parent.get_space_in_slot<S>(m_row, m_next_slot + n);
     EKAT_KERNEL_ASSERT_MSG(m_parent.get_next<S>(space) == m_next_slot + n + 1,m_ws_name);
   }
 #endif
 
   for (int n = 0; n < static_cast<int>(N); ++n) {
-    const auto space = m_parent.get_space_in_slot<S>(m_ws_idx, m_next_slot+n);
+    const auto space = m_parent.get_space_in_slot<S>(m_row, m_next_slot+n);
     *ptrs[n] = space;
   }
 
@@ -322,6 +713,7 @@ void WorkspaceManager<T, D>::Workspace::take_many_contiguous_unsafe(
   m_team.team_barrier();
   Kokkos::single(Kokkos::PerTeam(m_team), [&] () {
     m_next_slot += N;
+    change_usage(0, N);
 #ifndef NDEBUG
     for (int n = 0; n < static_cast<int>(N); ++n) {
       change_indv_meta<S>(*ptrs[n], names[n]);
@@ -344,12 +736,17 @@ WorkspaceManager<T, D>::Workspace::take_macro_block(
   change_num_used(n_sub_blocks);
   // Verify contiguous
   for (int n = 0; n < n_sub_blocks - 1; ++n) {
-    const auto space = m_parent.get_space_in_slot<S>(m_ws_idx, m_next_slot + n);
+    const auto space = m_parent.get_space_in_slot<S>(m_row, m_next_slot + n);
     EKAT_KERNEL_ASSERT_MSG(m_parent.get_next<S>(space) == m_next_slot + n + 1, m_ws_name);
   }
 #endif
 
-  const auto space = m_parent.get_space_in_slot<S>(m_ws_idx, m_next_slot);
+  const auto space = m_parent.get_space_in_slot<S>(m_row, m_next_slot);
+#ifdef EKAT_WSM_GUARD
+  // Poison all the sub-blocks, not just the first one
+  const int ntot = n_sub_blocks*m_parent.m_total - m_parent.m_reserve - m_guard;
+  m_parent.poison(space.data(), (ntot*sizeof(T))/sizeof(S));
+#endif
 
   // We need a barrier here so get_space_in_slot above returns consistent results
   // w/in the team.
@@ -357,6 +754,7 @@ WorkspaceManager<T, D>::Workspace::take_macro_block(
 
   Kokkos::single(Kokkos::PerTeam(m_team), [&] () {
     m_next_slot += n_sub_blocks;
+    change_usage(0, n_sub_blocks);
 #ifndef NDEBUG
    change_indv_meta<S>(space, name);
 #endif
@@ -369,6 +767,30 @@ WorkspaceManager<T, D>::Workspace::take_macro_block(
   return space;
 }
 
+template <typename T, typename D>
+template <typename S>
+KOKKOS_INLINE_FUNCTION
+Unmanaged<typename WorkspaceManager<T, D>::template view_2d<S> >
+WorkspaceManager<T, D>::Workspace::take_2d(
+  const char* name, const int n0, const int n1) const
+{
+  const int ld = m_parent.template get_padded_len<S>(n1);
+  const auto space = take_macro_block<S>(name, m_parent.template get_num_sub_blocks<S>(n0*ld));
+  return Unmanaged<view_2d<S> >(space.data(), n0, ld);
+}
+
+template <typename T, typename D>
+template <typename S>
+KOKKOS_INLINE_FUNCTION
+Unmanaged<typename WorkspaceManager<T, D>::template view_3d<S> >
+WorkspaceManager<T, D>::Workspace::take_3d(
+  const char* name, const int n0, const int n1, const int n2) const
+{
+  const int ld = m_parent.template get_padded_len<S>(n2);
+  const auto space = take_macro_block<S>(name, m_parent.template get_num_sub_blocks<S>(n0*n1*ld));
+  return Unmanaged<view_3d<S> >(space.data(), n0, n1, ld);
+}
+
 template <typename T, typename D>
 template <size_t N, typename S>
 KOKKOS_INLINE_FUNCTION
@@ -383,7 +805,7 @@ void WorkspaceManager<T, D>::Workspace::take_many(
   int next_slot = m_next_slot;
   for (int n = 0; n < static_cast<int>(N); ++n) {
     auto& space = *ptrs[n];
-    space = m_parent.get_space_in_slot<S>(m_ws_idx, next_slot);
+    space = m_parent.get_space_in_slot<S>(m_row, next_slot);
     next_slot = m_parent.get_next<S>(space);
   }
 
@@ -392,6 +814,7 @@ void WorkspaceManager<T, D>::Workspace::take_many(
   m_team.team_barrier();
   Kokkos::single(Kokkos::PerTeam(m_team), [&] () {
     m_next_slot = next_slot;
+    change_usage(0, N);
 #ifndef NDEBUG
     for (int n = 0; n < static_cast<int>(N); ++n) {
       change_indv_meta<S>(*ptrs[n], names[n]);
@@ -439,23 +862,25 @@ void WorkspaceManager<T, D>::Workspace::take_many_and_reset(
 #endif
 
   for (int n = 0; n < static_cast<int>(N); ++n) {
-    const auto space = m_parent.get_space_in_slot<S>(m_ws_idx, n);
+    const auto space = m_parent.get_space_in_slot<S>(m_row, n);
     *ptrs[n] = space;
   }
 
   // We only need to reset the metadata for spaces that are being left free
   Kokkos::parallel_for(
     Kokkos::TeamVectorRange(m_team, m_parent.m_max_used - N), [&] (int i) {
-      m_parent.init_slot_metadata(m_ws_idx, i+N);
+      m_parent.init_slot_metadata(m_row, i+N);
     });
+  reset_non_default_classes();
 
   Kokkos::single(Kokkos::PerTeam(m_team), [&] () {
     m_next_slot = N;
+    reset_usage(N);
 #ifndef NDEBUG
     // Mark all old spaces as released
-    for (int a = 0; a < m_parent.m_max_used; ++a) {
+    for (int a = 0; a < m_parent.m_num_slots; ++a) {
       if (m_parent.m_active(m_ws_idx, a)) {
-        change_indv_meta<S>(m_parent.get_space_in_slot<S>(m_ws_idx, a), "", true);
+        change_indv_meta<S>(m_parent.template get_space_in_slot<S>(m_row, m_parent.get_slot_class(a), a, 0), "", true);
       }
     }
 
@@ -481,15 +906,19 @@ void WorkspaceManager<T, D>::Workspace::reset() const
   m_next_slot = 0;
   Kokkos::parallel_for(
     Kokkos::TeamVectorRange(m_team, m_parent.m_max_used), [&] (int i) {
-      m_parent.init_slot_metadata(m_ws_idx, i);
+      m_parent.init_slot_metadata(m_row, i);
     });
+  reset_non_default_classes();
+  Kokkos::single(Kokkos::PerTeam(m_team), [&] () {
+    reset_usage(0);
+  });
 
 #ifndef NDEBUG
   Kokkos::single(Kokkos::PerTeam(m_team), [&] () {
     // Mark all old spaces as released
-    for (int a = 0; a < m_parent.m_max_used; ++a) {
+    for (int a = 0; a < m_parent.m_num_slots; ++a) {
       if (m_parent.m_active(m_ws_idx, a)) {
-        change_indv_meta<T>(m_parent.get_space_in_slot<T>(m_ws_idx, a), "", true);
+        change_indv_meta<T>(m_parent.template get_space_in_slot<T>(m_row, m_parent.get_slot_class(a), a, 0), "", true);
       }
     }
   });
@@ -498,6 +927,59 @@ void WorkspaceManager<T, D>::Workspace::reset() const
   m_team.team_barrier();
 }
 
+template <typename T, typename D>
+KOKKOS_INLINE_FUNCTION
+void WorkspaceManager<T, D>::Workspace::reset_non_default_classes() const
+{
+  for (int c = 1; c < m_parent.m_num_classes; ++c) {
+    const int base = m_parent.m_class_base[c];
+    Kokkos::parallel_for(
+      Kokkos::TeamVectorRange(m_team, m_parent.m_class_max_used[c]), [&] (int i) {
+        m_parent.init_slot_metadata(m_row, c, base+i);
+      });
+    Kokkos::single(Kokkos::PerTeam(m_team), [&] () {
+      next_slot(c) = base;
+    });
+  }
+}
+
+template <typename T, typename D>
+KOKKOS_FORCEINLINE_FUNCTION
+void WorkspaceManager<T, D>::Workspace::change_usage(const int c, const int change_by) const
+{
+  // No atomics needed: while a team holds workspace m_ws_idx, no other team touches its counters
+  if (m_parent.m_track_usage) {
+    const int curr_used = m_parent.m_usage(m_ws_idx, c, 0) += change_by;
+    if (curr_used > m_parent.m_usage(m_ws_idx, c, 1)) {
+      m_parent.m_usage(m_ws_idx, c, 1) = curr_used;
+    }
+  }
+}
+
+template <typename T, typename D>
+KOKKOS_INLINE_FUNCTION
+void WorkspaceManager<T, D>::Workspace::reset_usage(const int num_used) const
+{
+  if (m_parent.m_track_usage) {
+    for (int c = 0; c < m_parent.m_num_classes; ++c) {
+      m_parent.m_usage(m_ws_idx, c, 0) = 0;
+    }
+    change_usage(0, num_used);
+  }
+}
+
+template <typename T, typename D>
+KOKKOS_INLINE_FUNCTION
+int WorkspaceManager<T, D>::Workspace::get_num_free(const int c) const
+{
+  const int end = m_parent.m_class_base[c] + m_parent.m_class_max_used[c];
+  int num_free = 0;
+  for (int slot = next_slot(c); slot < end; ++num_free) {
+    slot = m_parent.get_next<T>(m_parent.template get_space_in_slot<T>(m_row, c, slot, 0));
+  }
+  return num_free;
+}
+
 // Print the linked list. Obviously not a device function.
 template <typename T, typename D>
 void WorkspaceManager<T, D>::Workspace::print() const
@@ -507,13 +989,13 @@ void WorkspaceManager<T, D>::Workspace::print() const
     Kokkos::PerTeam(m_team), [&] () {
       std::stringstream ss;
       ss << m_ws_idx << ":";
-      auto space = m_parent.get_space_in_slot<T>(m_ws_idx, m_next_slot);
+      auto space = m_parent.get_space_in_slot<T>(m_row, m_next_slot);
       for (int cnt = 0, nmax = m_parent.m_max_used;
            cnt < nmax;
            ++cnt) {
         ss << " (" << m_parent.get_index<T>(space) << ", "
            << m_parent.get_next<T>(space) << ")";
-        space = m_parent.get_space_in_slot<T>(m_ws_idx, m_parent.get_next<T>(space));
+        space = m_parent.get_space_in_slot<T>(m_row, m_parent.get_next<T>(space));
       }
       ss << "\n";
       std::cout << ss.str();
@@ -536,7 +1018,7 @@ void WorkspaceManager<T, D>::Workspace::change_num_used(int change_by) const
 {
   Kokkos::single(Kokkos::PerTeam(m_team), [&] () {
     int curr_used = m_parent.m_num_used(m_ws_idx) += change_by;
-    EKAT_KERNEL_ASSERT_MSG(curr_used <= m_parent.m_max_used, m_ws_name);
+    EKAT_KERNEL_ASSERT_MSG(curr_used <= m_parent.m_num_slots, m_ws_name);
     EKAT_KERNEL_ASSERT_MSG(curr_used >= 0, m_ws_name);
     if (curr_used > m_parent.m_high_water(m_ws_idx)) {
       m_parent.m_high_water(m_ws_idx) = curr_used;
@@ -605,11 +1087,27 @@ void WorkspaceManager<T, D>::Workspace::release_impl(const Unmanaged<view_1d<S>
   // We don't need a barrier before this block b/c it's OK for metadata to
   // change while some threads in the team are still using the bulk data.
   Kokkos::single(Kokkos::PerTeam(m_team), [&] () {
-      m_next_slot = m_parent.set_next_and_get_index<S>(space, m_next_slot);
+      // Push the slot on top of the free list of its class
+      const int c = m_parent.m_num_classes == 1 ? 0 : m_parent.get_slot_class(m_parent.get_index<S>(space));
+#ifdef EKAT_WSM_GUARD
+      EKAT_KERNEL_REQUIRE_MSG(m_parent.is_canary_intact(reinterpret_cast<const T*>(space.data()), c),
+                              "Error! Workspace sub-block overrun detected on release (canary overwritten).\n");
+#endif
+      int& next = next_slot(c);
+      next = m_parent.set_next_and_get_index<S>(space, next);
+      change_usage(c, -1);
   });
   m_team.team_barrier();
 }
 
+template <typename T, typename D>
+template <typename S>
+KOKKOS_INLINE_FUNCTION
+void WorkspaceManager<T, D>::Workspace::release_nd_impl(S* data, const int nelems) const
+{
+  release_macro_block<S>(Unmanaged<view_1d<S> >(data, nelems), m_parent.template get_num_sub_blocks<S>(nelems));
+}
+
 template <typename T, typename D>
 template <size_t N, typename S>
 KOKKOS_INLINE_FUNCTION
@@ -626,7 +1124,14 @@ void WorkspaceManager<T, D>::Workspace::release_many_contiguous(
 #endif
 
   Kokkos::single(Kokkos::PerTeam(m_team), [&] () {
+#ifdef EKAT_WSM_GUARD
+    for (int n = 0; n < static_cast<int>(N); ++n) {
+      EKAT_KERNEL_REQUIRE_MSG(m_parent.is_canary_intact(reinterpret_cast<const T*>(ptrs[n]->data()), 0),
+                              "Error! Workspace sub-block overrun detected on release (canary overwritten).\n");
+    }
+#endif
     m_next_slot = m_parent.get_index<S>(*ptrs[0]);
+    change_usage(0, -static_cast<int>(N));
 #ifndef NDEBUG
     for (int n = 0; n < static_cast<int>(N); ++n) {
       change_indv_meta<S>(*ptrs[n], "", true);
@@ -649,7 +1154,14 @@ void WorkspaceManager<T, D>::Workspace::release_macro_block(
 #endif
 
   Kokkos::single(Kokkos::PerTeam(m_team), [&] () {
+#ifdef EKAT_WSM_GUARD
+    // The canaries of all but the last sub-block are part of the macro block
+    const T* last = reinterpret_cast<const T*>(space.data()) + (n_sub_blocks-1)*m_parent.m_total;
+    EKAT_KERNEL_REQUIRE_MSG(m_parent.is_canary_intact(last, 0),
+                            "Error! Workspace macro block overrun detected on release (canary overwritten).\n");
+#endif
     m_next_slot = m_parent.get_index<S>(space);
+    change_usage(0, -n_sub_blocks);
 
 #ifndef NDEBUG
     change_indv_meta<S>(space, "", true);
@@ -660,7 +1172,7 @@ void WorkspaceManager<T, D>::Workspace::release_macro_block(
   m_team.team_barrier();
   Kokkos::parallel_for(
     Kokkos::TeamVectorRange(m_team, n_sub_blocks), [&] (int i) {
-      m_parent.init_slot_metadata(m_ws_idx, i+m_next_slot);
+      m_parent.init_slot_metadata(m_row, i+m_next_slot);
   });
 
   // We need a barrier here so that a subsequent call to take or release
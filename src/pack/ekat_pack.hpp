@@ -6,9 +6,11 @@
 
 #include "ekat_math_utils.hpp"
 #include "ekat_pack_macros.hpp"
+#include "ekat_pack_simd.hpp"
 #include "ekat_scalar_traits.hpp"
 #include "ekat_type_traits.hpp"
 
+#include <cstdint>
 #include <iostream>
 #include <type_traits>
 
@@ -42,6 +44,33 @@ struct IsPack<T&&> : IsPack<T> {};
    so we want the caller to be explicit.
  */
 
+namespace impl {
+
+// The smallest unsigned integer type with at least N bits, used to store
+// a bit-packed Mask<N> (see EKAT_PACK_MASK_BITS).
+template<int N>
+struct MaskBits {
+  static_assert (N>0 && N<=64, "Error! Bit-packed Mask only supports up to 64 slots.\n");
+  using type = std::conditional_t<(N<=8),  std::uint8_t,
+               std::conditional_t<(N<=16), std::uint16_t,
+               std::conditional_t<(N<=32), std::uint32_t,
+                                           std::uint64_t>>>;
+  // The value with the N lowest bits set
+  static constexpr type full = N==64 ? ~type(0) : type((std::uint64_t(1)<<N)-1);
+};
+
+// Number of set bits in x. This is the usual SWAR bit count, which works on
+// any device and compiles to a single popcnt when the target has one.
+KOKKOS_FORCEINLINE_FUNCTION
+int popcount (std::uint64_t x) {
+  x = x - ((x >> 1) & 0x5555555555555555ULL);
+  x = (x & 0x3333333333333333ULL) + ((x >> 2) & 0x3333333333333333ULL);
+  x = (x + (x >> 4)) & 0x0F0F0F0F0F0F0F0FULL;
+  return static_cast<int>((x * 0x0101010101010101ULL) >> 56);
+}
+
+} // namespace impl
+
 template <int PackSize>
 struct Mask {
   // One tends to think a short boolean type would be useful here (e.g., bool or
@@ -53,32 +82,86 @@ struct Mask {
   // Pack and Mask sizes are the same, n.
   enum { n = PackSize };
 
+  // If EKAT_PACK_MASK_BITS is defined, the slots are stored as the bits of a
+  // single unsigned integer rather than as an array of int. This is what
+  // hardware mask registers (e.g., AVX-512 k registers) look like, so masks
+  // move in/out of them with a single instruction, and any/all/none/count
+  // become a single integer op.
+#ifdef EKAT_PACK_MASK_BITS
+  static constexpr bool is_bitmask = true;
+  using bits_type = typename impl::MaskBits<n>::type;
+#else
+  static constexpr bool is_bitmask = false;
+#endif
+
+  // With bit-packed storage, we zero the bits, so that the unused high bits
+  // are always zero (this is a single integer store anyways).
   KOKKOS_FORCEINLINE_FUNCTION
+#ifdef EKAT_PACK_MASK_BITS
+  Mask () : b(0) {}
+#else
   Mask () {}
+#endif
 
   // Init all slots of the Mask to 'init'.
   KOKKOS_FORCEINLINE_FUNCTION explicit Mask (const bool& init) {
+#ifdef EKAT_PACK_MASK_BITS
+    b = init ? impl::MaskBits<n>::full : bits_type(0);
+#else
     //vector_simd // Intel 18 is having an issue with this loop.
     vector_disabled for (int i = 0; i < n; ++i) d[i] = init;
+#endif
   }
 
+#ifdef EKAT_PACK_MASK_BITS
+  // Set slot i to val.
+  KOKKOS_FORCEINLINE_FUNCTION void set (const int& i, const bool& val) {
+    b = val ? bits_type(b | (bits_type(1) << i)) : bits_type(b & ~(bits_type(1) << i));
+  }
+  // Get slot i.
+  KOKKOS_FORCEINLINE_FUNCTION bool operator[] (const int& i) const { return (b >> i) & 1; }
+
+  // Access the underlying bits (bit i is slot i).
+  KOKKOS_FORCEINLINE_FUNCTION const bits_type& bits () const { return b; }
+  KOKKOS_FORCEINLINE_FUNCTION       bits_type& bits ()       { return b; }
+
+  KOKKOS_FORCEINLINE_FUNCTION bool any () const { return b!=0; }
+  KOKKOS_FORCEINLINE_FUNCTION bool all () const { return b==impl::MaskBits<n>::full; }
+  KOKKOS_FORCEINLINE_FUNCTION bool none () const { return b==0; }
+  KOKKOS_FORCEINLINE_FUNCTION int count () const { return impl::popcount(b); }
+
+private:
+  bits_type b;
+#else
   // Set slot i to val.
   KOKKOS_FORCEINLINE_FUNCTION void set (const int& i, const bool& val) { d[i] = val; }
   // Get slot i.
   KOKKOS_FORCEINLINE_FUNCTION bool operator[] (const int& i) const { return d[i]; }
 
+  // Access the underlying storage (e.g., for simd loads/stores).
+  KOKKOS_FORCEINLINE_FUNCTION const type* data () const { return d; }
+  KOKKOS_FORCEINLINE_FUNCTION       type* data ()       { return d; }
+
   // Is any slot true?
   KOKKOS_FORCEINLINE_FUNCTION bool any () const {
-    bool b = false;
-    vector_simd for (int i = 0; i < n; ++i) if (d[i]) b = true;
-    return b;
+    if constexpr (impl::MaskSimd<n>::enabled) {
+      return impl::MaskSimd<n>::any(impl::MaskSimd<n>::load(*this));
+    } else {
+      bool b = false;
+      vector_simd for (int i = 0; i < n; ++i) if (d[i]) b = true;
+      return b;
+    }
   }
 
   // Are all slots true?
   KOKKOS_FORCEINLINE_FUNCTION bool all () const {
-    bool b = true;
-    vector_simd for (int i = 0; i < n; ++i) if ( ! d[i]) b = false;
-    return b;
+    if constexpr (impl::MaskSimd<n>::enabled) {
+      return impl::MaskSimd<n>::all(impl::MaskSimd<n>::load(*this));
+    } else {
+      bool b = true;
+      vector_simd for (int i = 0; i < n; ++i) if ( ! d[i]) b = false;
+      return b;
+    }
   }
 
   // Are all slots false?
@@ -86,8 +169,16 @@ struct Mask {
     return !any();
   }
 
+  // Number of true slots.
+  KOKKOS_FORCEINLINE_FUNCTION int count () const {
+    int c = 0;
+    vector_simd for (int i = 0; i < n; ++i) if (d[i]) ++c;
+    return c;
+  }
+
 private:
   type d[n];
+#endif
 };
 
 template <int n>
@@ -108,45 +199,71 @@ operator << (std::ostream& os, const Mask<n>& m) {
   vector_novec for (int s = 0; s < mask.n; ++s) if (mask[s])
 
 // Implementation detail for generating binary ops for mask op mask.
-#define ekat_mask_gen_bin_op_mm(op, impl)                   \
+// bit_impl is the equivalent bitwise op, used for bit-packed masks.
+#define ekat_mask_gen_bin_op_mm(op, op_impl, bit_impl)      \
   template <int n> KOKKOS_INLINE_FUNCTION                     \
   Mask<n> operator op (const Mask<n>& a, const Mask<n>& b) {  \
     Mask<n> m;                                                \
-    vector_simd for (int i = 0; i < n; ++i)                   \
-      m.set(i, a[i] impl b[i]);                               \
+    if constexpr (Mask<n>::is_bitmask) {                      \
+      m.bits() = a.bits() bit_impl b.bits();                  \
+    } else if constexpr (impl::MaskSimd<n>::enabled) {        \
+      using simd = impl::MaskSimd<n>;                         \
+      simd::store(simd::load(a) op_impl simd::load(b), m);    \
+    } else {                                                  \
+      vector_simd for (int i = 0; i < n; ++i)                 \
+        m.set(i, a[i] op_impl b[i]);                          \
+    }                                                         \
     return m;                                                 \
   }
 
 // Implementation detail for generating binary ops for mask op bool.
-#define ekat_mask_gen_bin_op_mb(op, impl)                   \
+#define ekat_mask_gen_bin_op_mb(op, op_impl, bit_impl)      \
   template <int n> KOKKOS_INLINE_FUNCTION                     \
   Mask<n> operator op (const Mask<n>& a, const bool b) {      \
     Mask<n> m;                                                \
-    vector_simd for (int i = 0; i < n; ++i)                   \
-      m.set(i, a[i] impl b);                                  \
+    if constexpr (Mask<n>::is_bitmask) {                      \
+      m.bits() = a.bits() bit_impl Mask<n>(b).bits();         \
+    } else {                                                  \
+      vector_simd for (int i = 0; i < n; ++i)                 \
+        m.set(i, a[i] op_impl b);                             \
+    }                                                         \
     return m;                                                 \
   }
 
-ekat_mask_gen_bin_op_mm(&&, &&)
-ekat_mask_gen_bin_op_mm(||, ||)
-ekat_mask_gen_bin_op_mb(&&, &&)
-ekat_mask_gen_bin_op_mb(||, ||)
+ekat_mask_gen_bin_op_mm(&&, &&, &)
+ekat_mask_gen_bin_op_mm(||, ||, |)
+ekat_mask_gen_bin_op_mb(&&, &&, &)
+ekat_mask_gen_bin_op_mb(||, ||, |)
 
 // Negate the mask.
 template <int n> KOKKOS_INLINE_FUNCTION
 Mask<n> operator ! (const Mask<n>& m) {
   Mask<n> not_m;
-  vector_simd for (int i = 0; i < n; ++i) not_m.set(i, ! m[i]);
+  if constexpr (Mask<n>::is_bitmask) {
+    not_m.bits() = ~m.bits() & impl::MaskBits<n>::full;
+  } else if constexpr (impl::MaskSimd<n>::enabled) {
+    using simd = impl::MaskSimd<n>;
+    simd::store(!simd::load(m), not_m);
+  } else {
+    vector_simd for (int i = 0; i < n; ++i) not_m.set(i, ! m[i]);
+  }
   return not_m;
 }
 
 // Compare masks
 template <int n> KOKKOS_INLINE_FUNCTION
 bool operator == (const Mask<n>& m1, const Mask<n>& m2) {
-  Mask<n> out;
-  vector_simd for (int i=0; i<n; ++i)
-    out.set(i, m1[i]==m2[i]);
-  return out.all();
+  if constexpr (Mask<n>::is_bitmask) {
+    return m1.bits()==m2.bits();
+  } else if constexpr (impl::MaskSimd<n>::enabled) {
+    using simd = impl::MaskSimd<n>;
+    return simd::all(simd::load(m1)==simd::load(m2));
+  } else {
+    Mask<n> out;
+    vector_simd for (int i=0; i<n; ++i)
+      out.set(i, m1[i]==m2[i]);
+    return out.all();
+  }
 }
 
 // Implementation detail for generating Pack assignment operators. _p means the
@@ -159,7 +276,14 @@ bool operator == (const Mask<n>& m1, const Mask<n>& m2) {
 #define ekat_pack_gen_assign_op_p(op)                       \
   KOKKOS_FORCEINLINE_FUNCTION                               \
   Pack& operator op (const Pack& a) {                       \
-    vector_simd for (int i = 0; i < n; ++i) d[i] op a[i]; \
+    if constexpr (impl::PackSimd<scalar,n>::enabled) {      \
+      using simd = impl::PackSimd<scalar,n>;                \
+      auto v = simd::load(d);                               \
+      v op simd::load(a.d);                                 \
+      simd::store(v,d);                                     \
+    } else {                                                \
+      vector_simd for (int i = 0; i < n; ++i) d[i] op a[i]; \
+    }                                                       \
     return *this;                                           \
   }                                                         \
   KOKKOS_FORCEINLINE_FUNCTION                               \
@@ -208,7 +332,15 @@ bool operator == (const Mask<n>& m1, const Mask<n>& m2) {
     Pack&                                                   \
   >                                                         \
   operator op (const S& a) {                                \
-    vector_simd for (int i = 0; i < n; ++i) d[i] op a;      \
+    if constexpr (impl::PackSimd<scalar,n>::enabled and     \
+                  impl::SimdSameType<scalar,S>::value) {    \
+      using simd = impl::PackSimd<scalar,n>;                \
+      auto v = simd::load(d);                               \
+      v op a;                                               \
+      simd::store(v,d);                                     \
+    } else {                                                \
+      vector_simd for (int i = 0; i < n; ++i) d[i] op a;    \
+    }                                                       \
     return *this;                                           \
   }
 #define ekat_pack_gen_assign_op_all(op)       \
@@ -239,11 +371,18 @@ struct Pack {
     *this = v;
   }
 
-  // Init this Pack from another one.
+  // Init this Pack from another one, converting each slot (e.g., float to double).
+  // With the explicit-SIMD backend, arithmetic conversions are done in registers
+  // (e.g., one cvtps2pd/cvtpd2ps per register), rather than slot by slot.
   template <typename T>
   KOKKOS_FORCEINLINE_FUNCTION explicit
   constexpr Pack (const Pack<T,n>& v) {
-    vector_simd for (int i = 0; i < n; ++i) d[i] = v[i];
+    if constexpr (impl::PackSimd<scalar,n>::enabled and impl::PackSimd<T,n>::enabled) {
+      using simd = impl::PackSimd<scalar,n>;
+      simd::store(simd::convert(impl::PackSimd<T,n>::load(v.data())),d);
+    } else {
+      vector_simd for (int i = 0; i < n; ++i) d[i] = v[i];
+    }
   }
 
   // Init this Pack from another one.
@@ -294,6 +433,10 @@ struct Pack {
   KOKKOS_FORCEINLINE_FUNCTION const scalar& operator[] (const int& i) const { return d[i]; }
   KOKKOS_FORCEINLINE_FUNCTION scalar& operator[] (const int& i) { return d[i]; }
 
+  // Access the underlying storage (e.g., for simd loads/stores).
+  KOKKOS_FORCEINLINE_FUNCTION const scalar* data () const { return d; }
+  KOKKOS_FORCEINLINE_FUNCTION       scalar* data ()       { return d; }
+
   ekat_pack_gen_assign_op_all(=)
   ekat_pack_gen_assign_op_all(+=)
   ekat_pack_gen_assign_op_all(-=)
@@ -302,7 +445,12 @@ struct Pack {
 
   KOKKOS_FORCEINLINE_FUNCTION
   Pack& set (const Mask<n>& mask, const scalar& v) {
-    vector_simd for (int i = 0; i < n; ++i) if (mask[i]) d[i] = v;
+    if constexpr (impl::PackSimd<scalar,n>::enabled) {
+      using simd = impl::PackSimd<scalar,n>;
+      simd::store(simd::blend(simd::load_mask(mask),v,simd::load(d)),d);
+    } else {
+      vector_simd for (int i = 0; i < n; ++i) if (mask[i]) d[i] = v;
+    }
 
     return *this;
   }
@@ -313,19 +461,30 @@ struct Pack {
             typename std::enable_if<PackIn::packtag>::type* = nullptr) {
     static_assert(static_cast<int>(PackIn::n) == PackSize,
                   "Pack::n must be the same.");
-    vector_simd for (int i = 0; i < n; ++i) if (mask[i]) d[i] = p[i];
+    if constexpr (impl::PackSimd<scalar,n>::enabled and
+                  impl::SimdSameType<scalar,typename PackIn::scalar>::value) {
+      using simd = impl::PackSimd<scalar,n>;
+      simd::store(simd::blend(simd::load_mask(mask),simd::load(p.data()),simd::load(d)),d);
+    } else {
+      vector_simd for (int i = 0; i < n; ++i) if (mask[i]) d[i] = p[i];
+    }
 
     return *this;
   }
 
   KOKKOS_FORCEINLINE_FUNCTION
   Pack& set (const Mask<n>& mask, const scalar& v_true, const scalar& v_false) {
-    vector_simd
-    for (int i = 0; i < n; ++i) {
-      if (mask[i])
-        d[i] = v_true;
-      else
-        d[i] = v_false;
+    if constexpr (impl::PackSimd<scalar,n>::enabled) {
+      using simd = impl::PackSimd<scalar,n>;
+      simd::store(simd::blend(simd::load_mask(mask),v_true,v_false),d);
+    } else {
+      vector_simd
+      for (int i = 0; i < n; ++i) {
+        if (mask[i])
+          d[i] = v_true;
+        else
+          d[i] = v_false;
+      }
     }
 
     return *this;
@@ -334,12 +493,21 @@ struct Pack {
   template <typename T, typename S>
   KOKKOS_FORCEINLINE_FUNCTION
   Pack& set (const Mask<n>& mask, const Pack<T,n>& p_true, const Pack<S,n>& p_false) {
-    vector_simd
-    for (int i = 0; i < n; ++i) {
-      if (mask[i])
-        d[i] = p_true[i];
-      else
-        d[i] = p_false[i];
+    if constexpr (impl::PackSimd<scalar,n>::enabled and
+                  impl::SimdSameType<scalar,T>::value and
+                  impl::SimdSameType<scalar,S>::value) {
+      using simd = impl::PackSimd<scalar,n>;
+      simd::store(simd::blend(simd::load_mask(mask),
+                              simd::load(p_true.data()),
+                              simd::load(p_false.data())),d);
+    } else {
+      vector_simd
+      for (int i = 0; i < n; ++i) {
+        if (mask[i])
+          d[i] = p_true[i];
+        else
+          d[i] = p_false[i];
+      }
     }
 
     return *this;
@@ -352,12 +520,21 @@ struct Pack {
   //    (or set, for the overloads with a mask).
   //  - we return *this, so we can pipe calls: y.update(x,2,1)[2] performs the update and then
   //    extracts the 3rd entry
+  //  - whether beta*y + alpha*x is computed with an fma depends on compiler and flags. For
+  //    an explicit fma (BFB across targets), use y = fma(alpha,x,beta*y) (see ekat_pack_math.hpp).
   template<typename T, typename CoeffT = scalar>
   KOKKOS_FORCEINLINE_FUNCTION
   Pack& update (const Pack<T,n>& x, const CoeffT alpha = 1, const CoeffT beta = 0) {
-    vector_simd
-    for (int i=0; i<n; ++i) {
-      d[i] = beta*d[i] + alpha*x[i];
+    if constexpr (impl::PackSimd<scalar,n>::enabled and
+                  impl::SimdSameType<scalar,T>::value and
+                  impl::SimdCoeffType<scalar,CoeffT>::value) {
+      using simd = impl::PackSimd<scalar,n>;
+      simd::store(scalar(beta)*simd::load(d) + scalar(alpha)*simd::load(x.data()),d);
+    } else {
+      vector_simd
+      for (int i=0; i<n; ++i) {
+        d[i] = beta*d[i] + alpha*x[i];
+      }
     }
     return *this;
   }
@@ -365,20 +542,46 @@ struct Pack {
   template<typename T, typename CoeffT = scalar>
   KOKKOS_FORCEINLINE_FUNCTION
   Pack& update (const Mask<n>& m, const Pack<T,n>& x, const CoeffT alpha = 1, const CoeffT beta = 0) {
-    ekat_masked_loop(m,i)
-      d[i] = beta*d[i] + alpha*x[i];
+    if constexpr (impl::PackSimd<scalar,n>::enabled and
+                  impl::SimdSameType<scalar,T>::value and
+                  impl::SimdCoeffType<scalar,CoeffT>::value) {
+      using simd = impl::PackSimd<scalar,n>;
+      // Zero the operands in the inactive slots, so that they cannot raise
+      // FP exceptions that the scalar loop would not raise.
+      const auto mask = simd::load_mask(m);
+      const auto zero = typename simd::simd_t(0);
+      const auto y = simd::load(d);
+      simd::store(simd::blend(mask,
+                              scalar(beta)*simd::blend(mask,y,zero) +
+                              scalar(alpha)*simd::blend(mask,simd::load(x.data()),zero),
+                              y),d);
+    } else {
+      ekat_masked_loop(m,i)
+        d[i] = beta*d[i] + alpha*x[i];
+    }
     return *this;
   }
 
   template<typename T, typename S, typename CoeffT = scalar>
   KOKKOS_FORCEINLINE_FUNCTION
   Pack& update (const Mask<n>& m, const Pack<T,n>& x_true, const Pack<S,n>& x_false, const CoeffT alpha = 1, const CoeffT beta = 0) {
-    vector_simd
-    for (int i=0; i<n; ++i) {
-      if (m[i])
-        d[i] = beta*d[i] + alpha*x_true[i];
-      else
-        d[i] = beta*d[i] + alpha*x_false[i];
+    if constexpr (impl::PackSimd<scalar,n>::enabled and
+                  impl::SimdSameType<scalar,T>::value and
+                  impl::SimdSameType<scalar,S>::value and
+                  impl::SimdCoeffType<scalar,CoeffT>::value) {
+      using simd = impl::PackSimd<scalar,n>;
+      const auto x = simd::blend(simd::load_mask(m),
+                                 simd::load(x_true.data()),
+                                 simd::load(x_false.data()));
+      simd::store(scalar(beta)*simd::load(d) + scalar(alpha)*x,d);
+    } else {
+      vector_simd
+      for (int i=0; i<n; ++i) {
+        if (m[i])
+          d[i] = beta*d[i] + alpha*x_true[i];
+        else
+          d[i] = beta*d[i] + alpha*x_false[i];
+      }
     }
     return *this;
   }
@@ -430,8 +633,15 @@ struct IsPack<Pack<T,N>> : std::true_type {};
        >                                                                \
   {                                                                     \
     Pack<std::common_type_t<S,T>,n> c;                                  \
-    vector_simd                                                         \
-    for (int i = 0; i < n; ++i) c[i] = a[i] op b[i];                    \
+    if constexpr (impl::PackSimd<T,n>::enabled and                      \
+                  impl::SimdSameType<T,S>::value) {                     \
+      using simd = impl::PackSimd<T,n>;                                 \
+      simd::store(simd::load(a.data()) op simd::load(b.data()),         \
+                  c.data());                                            \
+    } else {                                                            \
+      vector_simd                                                       \
+      for (int i = 0; i < n; ++i) c[i] = a[i] op b[i];                  \
+    }                                                                   \
     return c;                                                           \
   }
 #define ekat_pack_gen_bin_op_ps(op)                                   \
@@ -443,8 +653,14 @@ struct IsPack<Pack<T,N>> : std::true_type {};
                    Pack<std::common_type_t<S,T>,n>>                     \
   operator op (const Pack<T,n>& a, const S& b) {                        \
     Pack<std::common_type_t<S,T>,n> c;                                  \
-    vector_simd                                                         \
-    for (int i = 0; i < n; ++i) c[i] = a[i] op b;                       \
+    if constexpr (impl::PackSimd<T,n>::enabled and                      \
+                  impl::SimdSameType<T,S>::value) {                     \
+      using simd = impl::PackSimd<T,n>;                                 \
+      simd::store(simd::load(a.data()) op b, c.data());                 \
+    } else {                                                            \
+      vector_simd                                                       \
+      for (int i = 0; i < n; ++i) c[i] = a[i] op b;                     \
+    }                                                                   \
     return c;                                                           \
   }
 #define ekat_pack_gen_bin_op_sp(op)                                   \
@@ -456,8 +672,14 @@ struct IsPack<Pack<T,N>> : std::true_type {};
                    Pack<std::common_type_t<S,T>,n>>                     \
   operator op (const S& a, const Pack<T,n>& b) {                        \
     Pack<std::common_type_t<S,T>,n> c;                                  \
-    vector_simd                                                         \
-    for (int i = 0; i < n; ++i) c[i] = a op b[i];                       \
+    if constexpr (impl::PackSimd<T,n>::enabled and                      \
+                  impl::SimdSameType<T,S>::value) {                     \
+      using simd = impl::PackSimd<T,n>;                                 \
+      simd::store(a op simd::load(b.data()), c.data());                 \
+    } else {                                                            \
+      vector_simd                                                       \
+      for (int i = 0; i < n; ++i) c[i] = a op b[i];                     \
+    }                                                                   \
     return c;                                                           \
   }
 #define ekat_pack_gen_bin_op_all(op)          \
@@ -476,44 +698,68 @@ ekat_pack_gen_bin_op_all(/)
   Pack<T,n>                                       \
   operator op (const Pack<T,n>& a) {              \
     Pack<T,n> b;                                  \
-    vector_simd                                   \
-    for (int i = 0; i < n; ++i) b[i] = op a[i];   \
+    if constexpr (impl::PackSimd<T,n>::enabled) { \
+      using simd = impl::PackSimd<T,n>;           \
+      simd::store(op simd::load(a.data()),        \
+                  b.data());                      \
+    } else {                                      \
+      vector_simd                                 \
+      for (int i = 0; i < n; ++i) b[i] = op a[i]; \
+    }                                             \
     return b;                                     \
   }
 
 ekat_pack_gen_unary_op(-)
 
-#define ekat_pack_gen_bin_fn_pp(fn, impl)                   \
-  template <typename T, int n> KOKKOS_INLINE_FUNCTION       \
-  Pack<T,n> fn (const Pack<T,n>& a, const Pack<T,n>& b) {   \
-    Pack<T,n> s;                                            \
-    vector_simd for (int i = 0; i < n; ++i)                 \
-      s[i] = impl(a[i], b[i]);                              \
-    return s;                                               \
-  }
-#define ekat_pack_gen_bin_fn_ps(fn, impl)                 \
-  template <typename T, int n, typename ScalarType>       \
-  KOKKOS_INLINE_FUNCTION                                  \
-  Pack<T,n>                                               \
-  fn (const Pack<T,n>& a, const ScalarType& b) {          \
-    Pack<T,n> s;                                          \
-    vector_simd for (int i = 0; i < n; ++i)               \
-      s[i] = impl<typename Pack<T,n>::scalar>(a[i], b);   \
-    return s;                                             \
-  }
-#define ekat_pack_gen_bin_fn_sp(fn, impl)                   \
-  template <typename T, int n, typename ScalarType>         \
-  KOKKOS_INLINE_FUNCTION                                    \
-  Pack<T,n> fn (const ScalarType& a, const Pack<T,n>& b) {  \
-    Pack<T,n> s;                                            \
-    vector_simd for (int i = 0; i < n; ++i)                 \
-      s[i] = impl<typename Pack<T,n>::scalar>(a, b[i]);     \
-    return s;                                               \
-  }
-#define ekat_pack_gen_bin_fn_all(fn, impl)    \
-  ekat_pack_gen_bin_fn_pp(fn, impl)           \
-  ekat_pack_gen_bin_fn_ps(fn, impl)           \
-  ekat_pack_gen_bin_fn_sp(fn, impl)
+#define ekat_pack_gen_bin_fn_pp(fn, fn_impl)                    \
+  template <typename T, int n> KOKKOS_INLINE_FUNCTION           \
+  Pack<T,n> fn (const Pack<T,n>& a, const Pack<T,n>& b) {       \
+    Pack<T,n> s;                                                \
+    if constexpr (impl::PackSimd<T,n>::enabled) {               \
+      using simd = impl::PackSimd<T,n>;                         \
+      simd::store(simd::fn(simd::load(a.data()),                \
+                           simd::load(b.data())), s.data());    \
+    } else {                                                    \
+      vector_simd for (int i = 0; i < n; ++i)                   \
+        s[i] = fn_impl(a[i], b[i]);                             \
+    }                                                           \
+    return s;                                                   \
+  }
+#define ekat_pack_gen_bin_fn_ps(fn, fn_impl)                    \
+  template <typename T, int n, typename ScalarType>             \
+  KOKKOS_INLINE_FUNCTION                                        \
+  Pack<T,n>                                                     \
+  fn (const Pack<T,n>& a, const ScalarType& b) {                \
+    Pack<T,n> s;                                                \
+    if constexpr (impl::PackSimd<T,n>::enabled) {               \
+      using simd = impl::PackSimd<T,n>;                         \
+      simd::store(simd::fn(simd::load(a.data()),                \
+                           T(b)), s.data());                    \
+    } else {                                                    \
+      vector_simd for (int i = 0; i < n; ++i)                   \
+        s[i] = fn_impl<typename Pack<T,n>::scalar>(a[i], b);    \
+    }                                                           \
+    return s;                                                   \
+  }
+#define ekat_pack_gen_bin_fn_sp(fn, fn_impl)                    \
+  template <typename T, int n, typename ScalarType>             \
+  KOKKOS_INLINE_FUNCTION                                        \
+  Pack<T,n> fn (const ScalarType& a, const Pack<T,n>& b) {      \
+    Pack<T,n> s;                                                \
+    if constexpr (impl::PackSimd<T,n>::enabled) {               \
+      using simd = impl::PackSimd<T,n>;                         \
+      simd::store(simd::fn(T(a),                                \
+                           simd::load(b.data())), s.data());    \
+    } else {                                                    \
+      vector_simd for (int i = 0; i < n; ++i)                   \
+        s[i] = fn_impl<typename Pack<T,n>::scalar>(a, b[i]);    \
+    }                                                           \
+    return s;                                                   \
+  }
+#define ekat_pack_gen_bin_fn_all(fn, fn_impl)   \
+  ekat_pack_gen_bin_fn_pp(fn, fn_impl)          \
+  ekat_pack_gen_bin_fn_ps(fn, fn_impl)          \
+  ekat_pack_gen_bin_fn_sp(fn, fn_impl)
 
 ekat_pack_gen_bin_fn_all(min, impl::min)
 ekat_pack_gen_bin_fn_all(max, impl::max)
@@ -522,8 +768,13 @@ template <typename T, int n>
 KOKKOS_INLINE_FUNCTION
 Pack<T,n> shift_right (const Pack<T,n>& pm1, const Pack<T,n>& p) {
   Pack<T,n> s;
-  s[0] = pm1[n-1];
-  vector_simd for (int i = 1; i < n; ++i) s[i] = p[i-1];
+  if constexpr (impl::PackSimd<T,n>::enabled) {
+    using simd = impl::PackSimd<T,n>;
+    simd::store(simd::shift_right(pm1[n-1],simd::load(p.data())),s.data());
+  } else {
+    s[0] = pm1[n-1];
+    vector_simd for (int i = 1; i < n; ++i) s[i] = p[i-1];
+  }
   return s;
 }
 
@@ -531,8 +782,13 @@ template <typename T, int n, typename ScalarType>
 KOKKOS_INLINE_FUNCTION
 Pack<T,n> shift_right (const ScalarType& pm1, const Pack<T,n>& p) {
   Pack<T,n> s;
-  s[0] = pm1;
-  vector_simd for (int i = 1; i < n; ++i) s[i] = p[i-1];
+  if constexpr (impl::PackSimd<T,n>::enabled) {
+    using simd = impl::PackSimd<T,n>;
+    simd::store(simd::shift_right(T(pm1),simd::load(p.data())),s.data());
+  } else {
+    s[0] = pm1;
+    vector_simd for (int i = 1; i < n; ++i) s[i] = p[i-1];
+  }
   return s;
 }
 
@@ -540,8 +796,13 @@ template <typename T, int n>
 KOKKOS_INLINE_FUNCTION
 Pack<T,n> shift_left (const Pack<T,n>& pp1, const Pack<T,n>& p) {
   Pack<T,n> s;
-  s[n-1] = pp1[0];
-  vector_simd for (int i = 0; i < n-1; ++i) s[i] = p[i+1];
+  if constexpr (impl::PackSimd<T,n>::enabled) {
+    using simd = impl::PackSimd<T,n>;
+    simd::store(simd::shift_left(pp1[0],simd::load(p.data())),s.data());
+  } else {
+    s[n-1] = pp1[0];
+    vector_simd for (int i = 0; i < n-1; ++i) s[i] = p[i+1];
+  }
   return s;
 }
 
@@ -549,8 +810,13 @@ template <typename T, int n, typename ScalarType>
 KOKKOS_INLINE_FUNCTION
 Pack<T,n> shift_left (const ScalarType& pp1, const Pack<T,n>& p) {
   Pack<T,n> s;
-  s[n-1] = pp1;
-  vector_simd for (int i = 0; i < n-1; ++i) s[i] = p[i+1];
+  if constexpr (impl::PackSimd<T,n>::enabled) {
+    using simd = impl::PackSimd<T,n>;
+    simd::store(simd::shift_left(T(pp1),simd::load(p.data())),s.data());
+  } else {
+    s[n-1] = pp1;
+    vector_simd for (int i = 0; i < n-1; ++i) s[i] = p[i+1];
+  }
   return s;
 }
 
@@ -560,8 +826,14 @@ Pack<T,n> shift_left (const ScalarType& pp1, const Pack<T,n>& p) {
   Mask<n>                                                 \
   operator op (const Pack<T,n>& a, const Pack<T,n>& b) {  \
     Mask<n> m;                                            \
-    vector_simd for (int i = 0; i < n; ++i)               \
-      m.set(i, a[i] op b[i]);                             \
+    if constexpr (impl::PackSimd<T,n>::enabled) {         \
+      using simd = impl::PackSimd<T,n>;                   \
+      simd::store_mask(simd::load(a.data()) op            \
+                       simd::load(b.data()), m);   \
+    } else {                                              \
+      vector_simd for (int i = 0; i < n; ++i)             \
+        m.set(i, a[i] op b[i]);                           \
+    }                                                     \
     return m;                                             \
   }
 #define ekat_mask_gen_bin_op_ps(op)                         \
@@ -570,8 +842,15 @@ Pack<T,n> shift_left (const ScalarType& pp1, const Pack<T,n>& p) {
   Mask<n>                                                   \
   operator op (const Pack<T,n>& a, const ScalarType& b) {   \
     Mask<n> m;                                              \
-    vector_simd for (int i = 0; i < n; ++i)                 \
-      m.set(i, a[i] op b);                                  \
+    if constexpr (impl::PackSimd<T,n>::enabled and          \
+                  impl::SimdSameType<T,ScalarType>::value) {\
+      using simd = impl::PackSimd<T,n>;                     \
+      simd::store_mask(simd::load(a.data()) op              \
+                       typename simd::simd_t(b), m); \
+    } else {                                                \
+      vector_simd for (int i = 0; i < n; ++i)               \
+        m.set(i, a[i] op b);                                \
+    }                                                       \
     return m;                                               \
   }
 #define ekat_mask_gen_bin_op_sp(op)                         \
@@ -580,8 +859,15 @@ Pack<T,n> shift_left (const ScalarType& pp1, const Pack<T,n>& p) {
   Mask<n>                                                   \
   operator op (const ScalarType& a, const Pack<T,n>& b) {   \
     Mask<n> m;                                              \
-    vector_simd for (int i = 0; i < n; ++i)                 \
-      m.set(i, a op b[i]);                                  \
+    if constexpr (impl::PackSimd<T,n>::enabled and          \
+                  impl::SimdSameType<T,ScalarType>::value) {\
+      using simd = impl::PackSimd<T,n>;                     \
+      simd::store_mask(typename simd::simd_t(a) op          \
+                       simd::load(b.data()), m);     \
+    } else {                                                \
+      vector_simd for (int i = 0; i < n; ++i)               \
+        m.set(i, a op b[i]);                                \
+    }                                                       \
     return m;                                               \
   }
 #define ekat_mask_gen_bin_op_all(op)          \
@@ -601,8 +887,13 @@ KOKKOS_INLINE_FUNCTION
 Mask<n>
 isnan (const Pack<T,n>& p) {
   Mask<n> m;
-  vector_simd for (int i = 0; i < n; ++i) {
-    m.set(i, impl::is_nan(p[i]));
+  if constexpr (impl::PackSimd<T,n>::enabled and std::is_floating_point<T>::value) {
+    using simd = impl::PackSimd<T,n>;
+    simd::store_mask(simd::isnan(simd::load(p.data())),m);
+  } else {
+    vector_simd for (int i = 0; i < n; ++i) {
+      m.set(i, impl::is_nan(p[i]));
+    }
   }
   return m;
 }
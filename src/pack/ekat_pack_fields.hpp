@@ -0,0 +1,115 @@
+#ifndef EKAT_PACK_FIELDS_HPP
+#define EKAT_PACK_FIELDS_HPP
+
+#include "ekat_pack.hpp"
+#include "ekat_pack_kokkos.hpp"
+#include "ekat_subview_utils.hpp"
+#include "ekat_kokkos_types.hpp"
+#include "ekat_assert.hpp"
+
+#include <string>
+
+namespace ekat {
+
+/*
+ * PackFields stores several fields (e.g., the tracers of a physics
+ * parameterization) defined on the same columns, in a single allocation,
+ * with all the fields of a column next to each other:
+ *
+ *   col 0: [field 0: pack 0 ... pack P-1][field 1: ...] ... [field F-1: ...]
+ *   col 1: [field 0: pack 0 ... pack P-1][field 1: ...] ... [field F-1: ...]
+ *   ...
+ *
+ * That is, the data is a (ncol, nfields, npacks) View of Pack<ScalarT,PackSize>,
+ * with LayoutRight. Compared to storing each field in a separate view_2d, a
+ * kernel that updates many fields in a column streams through one contiguous
+ * block of memory, rather than through nfields blocks scattered across the
+ * memory (which strains the TLB and the hardware prefetchers).
+ *
+ * The pack dimension is padded (see padded_extent in ekat_pack_kokkos.hpp), so
+ * that each field of each column starts at an aligned address. Hence, the
+ * views returned by column and field (which are just ekat::subview's of the
+ * underlying view) keep the Kokkos::Aligned trait, and can be scalarize-d or
+ * repack-ed as usual. Only the first npacks() packs of a field are used; the
+ * padding is zero-initialized.
+ *
+ * Example:
+ *   PackFields<Real,8> q("q",ncol,nq,nlev);
+ *   Kokkos::parallel_for(ncol, KOKKOS_LAMBDA (const int i) {
+ *     for (int k=0; k<q.npacks(); ++k) {
+ *       for (int f=0; f<q.nfields(); ++f) {
+ *         q(i,f,k) *= 2;
+ *       }
+ *     }
+ *   });
+ *   const auto q_if  = q.field(i,f);            // a 1d view of packs
+ *   const auto q_ifs = scalarize(q.field(i,f)); // a 1d view of scalars
+ */
+
+template<typename ScalarT, int PackSize, typename DeviceT = DefaultDevice>
+class PackFields {
+public:
+  using scalar_type = ScalarT;
+  using pack_type   = Pack<ScalarT,PackSize>;
+  using device_type = DeviceT;
+
+  using KT = KokkosTypes<DeviceT>;
+  using view_type = typename KT::template aligned_view_3d<pack_type>;
+
+  static constexpr int pack_size = PackSize;
+
+  PackFields () = default;
+
+  PackFields (const std::string& label, const int ncol, const int nfields, const int nlev)
+   : m_ncol    (ncol)
+   , m_nfields (nfields)
+   , m_nlev    (nlev)
+   , m_npacks  (PackInfo<PackSize>::num_packs(nlev))
+  {
+    EKAT_REQUIRE_MSG (ncol>=0 and nfields>=0 and nlev>=0,
+        "Error! Invalid (negative) PackFields dimensions.\n");
+    m_view = allocate_aligned<pack_type,DeviceT>(label,ncol,nfields,nlev);
+  }
+
+  // Dimensions. Note: npacks() is the number of packs needed for nlevs() scalars,
+  //                   which may be smaller than view().extent(2), due to padding.
+  KOKKOS_INLINE_FUNCTION int ncols   () const { return m_ncol; }
+  KOKKOS_INLINE_FUNCTION int nfields () const { return m_nfields; }
+  KOKKOS_INLINE_FUNCTION int nlevs   () const { return m_nlev; }
+  KOKKOS_INLINE_FUNCTION int npacks  () const { return m_npacks; }
+
+  // The underlying (ncol, nfields, padded npacks) view
+  KOKKOS_INLINE_FUNCTION const view_type& view () const { return m_view; }
+
+  // The k-th pack of field f in column icol
+  KOKKOS_FORCEINLINE_FUNCTION
+  pack_type& operator() (const int icol, const int f, const int k) const {
+    return m_view(icol,f,k);
+  }
+
+  // All the fields of column icol, as a (nfields, padded npacks) view
+  KOKKOS_INLINE_FUNCTION
+  auto column (const int icol) const { return ekat::subview(m_view,icol); }
+
+  // Field f of column icol, as a (padded npacks) view
+  KOKKOS_INLINE_FUNCTION
+  auto field (const int icol, const int f) const { return ekat::subview(m_view,icol,f); }
+
+  // Field f on all columns, as a (ncol, npacks) strided view (without padding),
+  // e.g., to deep_copy it from/to a separate view_2d
+  auto field (const int f) const {
+    return Kokkos::subview(m_view,Kokkos::ALL(),f,Kokkos::make_pair(0,m_npacks));
+  }
+
+protected:
+  view_type m_view;
+
+  int m_ncol    = 0;
+  int m_nfields = 0;
+  int m_nlev    = 0;
+  int m_npacks  = 0;
+};
+
+} // namespace ekat
+
+#endif // EKAT_PACK_FIELDS_HPP
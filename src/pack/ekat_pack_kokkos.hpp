@@ -4,10 +4,13 @@
 #include "ekat_pack.hpp"
 #include "ekat_pack_utils.hpp"
 #include "ekat_kokkos_meta.hpp"
+#include "ekat_kokkos_types.hpp"
 #include "ekat_kernel_assert.hpp"
 #include "ekat_scalar_traits.hpp"
 #include "ekat_assert.hpp"
 
+#include <numeric>
+#include <string>
 #include <vector>
 #include <type_traits>
 
@@ -16,12 +19,99 @@ namespace ekat {
 /* These functions combine Pack, Mask, and Kokkos::Views.
  */
 
+namespace impl {
+
+// Whether the entries of Array can be accessed via offsets from a.data(), computed
+// from the Array strides, using IdxPack offsets. This excludes views of Packs,
+// layouts without strides (e.g., tiled ones), and non-View arrays.
+template<typename Array, typename IdxPack, typename = void>
+struct HasStridedData : std::false_type {};
+
+template<typename Array, typename IdxPack>
+struct HasStridedData<Array,IdxPack,std::enable_if_t<Kokkos::is_view<Array>::value>>
+ : std::integral_constant<bool,
+     std::is_arithmetic<typename Array::non_const_value_type>::value and
+     std::is_integral<typename IdxPack::scalar>::value and
+     (std::is_same<typename Array::array_layout,Kokkos::LayoutRight>::value or
+      std::is_same<typename Array::array_layout,Kokkos::LayoutLeft>::value or
+      std::is_same<typename Array::array_layout,Kokkos::LayoutStride>::value)> {};
+
+// Whether the offsets of all entries of a fit in the scalar type of IdxPack
+template<typename IdxPack, typename Array>
+KOKKOS_INLINE_FUNCTION
+bool offsets_fit (const Array& a) {
+  using idx_t = typename IdxPack::scalar;
+  return a.span() <= static_cast<std::size_t>(Kokkos::Experimental::finite_max_v<idx_t>);
+}
+
+// Offsets of the entries a(i0[i],i1[i],...) from a.data()
+template<typename Array, typename IdxPack, typename... IdxPacks>
+KOKKOS_INLINE_FUNCTION
+IdxPack data_offsets (const Array& a, const IdxPack& i0, const IdxPacks&... is) {
+  using idx_t = typename IdxPack::scalar;
+  const IdxPack idx[] = {i0, is...};
+  IdxPack off(0);
+  for (int r = 0; r < static_cast<int>(Array::rank); ++r) {
+    EKAT_KERNEL_ASSERT_MSG (((idx[r] >= 0) && (idx[r] < static_cast<idx_t>(a.extent(r)))).all(),
+        "Error! Pack index out of bounds.\n");
+    off += idx[r]*static_cast<idx_t>(a.stride(r));
+  }
+  return off;
+}
+
+// Return p, with p[i] = data[off[i]]. If the offsets are contiguous, this is
+// a plain (unaligned) vector load, otherwise a gather. With the explicit-SIMD
+// backend, the gather uses the hardware gather instructions (if available).
+// Otherwise, we let the compiler decide whether to vectorize the gather loop,
+// since forcing it (via vector_simd) is often slower than scalar loads.
+template<typename T, typename IdxPack>
+KOKKOS_INLINE_FUNCTION
+Pack<std::remove_const_t<T>,IdxPack::n> gather (T* data, const IdxPack& off) {
+  using simd = PackSimd<std::remove_const_t<T>,IdxPack::n>;
+  Pack<std::remove_const_t<T>,IdxPack::n> p;
+  if ((off == range<IdxPack>(off[0])).all()) {
+    const T* start = data + off[0];
+    vector_simd for (int i = 0; i < IdxPack::n; ++i)
+      p[i] = start[i];
+  } else if constexpr (simd::enabled) {
+    simd::store(simd::gather(data, off.data()), p.data());
+  } else {
+    for (int i = 0; i < IdxPack::n; ++i)
+      p[i] = data[off[i]];
+  }
+  return p;
+}
+
+// Set data[off[i]] = v[i], where m[i] is true. As in gather, contiguous
+// offsets are detected, and result in a plain (masked) vector store.
+template<bool Masked, typename T, typename IdxPack>
+KOKKOS_INLINE_FUNCTION
+void scatter (T* data, const IdxPack& off, const Pack<T,IdxPack::n>& v,
+              const Mask<IdxPack::n>& m) {
+  if ((off == range<IdxPack>(off[0])).all()) {
+    T* start = data + off[0];
+    vector_simd for (int i = 0; i < IdxPack::n; ++i)
+      if (not Masked or m[i]) start[i] = v[i];
+  } else {
+    vector_simd for (int i = 0; i < IdxPack::n; ++i)
+      if (not Masked or m[i]) data[off[i]] = v[i];
+  }
+}
+
+} // namespace impl
+
 // Index a scalar array with Pack indices, returning a compatible Pack of array
-// values.
+// values. For Views of arithmetic types with strided layouts (e.g., LayoutRight)
+// and integer indices, the values are read directly from the View data, as a
+// single vector load if the indices are contiguous, and as a gather otherwise.
 template<typename Array1, typename IdxPack> KOKKOS_INLINE_FUNCTION
 OnlyPackReturn<IdxPack, Pack<typename Array1::non_const_value_type, IdxPack::n> >
 index (const Array1& a, const IdxPack& i0,
        typename std::enable_if<Array1::rank == 1>::type* = nullptr) {
+  if constexpr (impl::HasStridedData<Array1,IdxPack>::value) {
+    if (impl::offsets_fit<IdxPack>(a))
+      return impl::gather(a.data(), impl::data_offsets(a, i0));
+  }
   Pack<typename Array1::non_const_value_type, IdxPack::n> p;
   vector_simd for (int i = 0; i < IdxPack::n; ++i)
     p[i] = a(i0[i]);
@@ -32,6 +122,10 @@ template<typename Array2, typename IdxPack> KOKKOS_INLINE_FUNCTION
 OnlyPackReturn<IdxPack, Pack<typename Array2::non_const_value_type, IdxPack::n> >
 index (const Array2& a, const IdxPack& i0, const IdxPack& i1,
        typename std::enable_if<Array2::rank == 2>::type* = nullptr) {
+  if constexpr (impl::HasStridedData<Array2,IdxPack>::value) {
+    if (impl::offsets_fit<IdxPack>(a))
+      return impl::gather(a.data(), impl::data_offsets(a, i0, i1));
+  }
   Pack<typename Array2::non_const_value_type, IdxPack::n> p;
   vector_simd for (int i = 0; i < IdxPack::n; ++i)
     p[i] = a(i0[i], i1[i]);
@@ -42,6 +136,10 @@ template<typename Array3, typename IdxPack> KOKKOS_INLINE_FUNCTION
 OnlyPackReturn<IdxPack, Pack<typename Array3::non_const_value_type, IdxPack::n> >
 index (const Array3& a, const IdxPack& i0, const IdxPack& i1, const IdxPack& i2,
        typename std::enable_if<Array3::rank == 3>::type* = nullptr) {
+  if constexpr (impl::HasStridedData<Array3,IdxPack>::value) {
+    if (impl::offsets_fit<IdxPack>(a))
+      return impl::gather(a.data(), impl::data_offsets(a, i0, i1, i2));
+  }
   Pack<typename Array3::non_const_value_type, IdxPack::n> p;
   vector_simd for (int i = 0; i < IdxPack::n; ++i)
     p[i] = a(i0[i], i1[i], i2[i]);
@@ -52,6 +150,10 @@ template<typename Array4, typename IdxPack> KOKKOS_INLINE_FUNCTION
 OnlyPackReturn<IdxPack, Pack<typename Array4::non_const_value_type, IdxPack::n> >
 index (const Array4& a, const IdxPack& i0, const IdxPack& i1, const IdxPack& i2, const IdxPack& i3,
        typename std::enable_if<Array4::rank == 4>::type* = nullptr) {
+  if constexpr (impl::HasStridedData<Array4,IdxPack>::value) {
+    if (impl::offsets_fit<IdxPack>(a))
+      return impl::gather(a.data(), impl::data_offsets(a, i0, i1, i2, i3));
+  }
   Pack<typename Array4::non_const_value_type, IdxPack::n> p;
   vector_simd for (int i = 0; i < IdxPack::n; ++i)
     p[i] = a(i0[i], i1[i], i2[i], i3[i]);
@@ -62,12 +164,84 @@ template<typename Array5, typename IdxPack> KOKKOS_INLINE_FUNCTION
 OnlyPackReturn<IdxPack, Pack<typename Array5::non_const_value_type, IdxPack::n> >
 index (const Array5& a, const IdxPack& i0, const IdxPack& i1, const IdxPack& i2, const IdxPack& i3, const IdxPack& i4,
        typename std::enable_if<Array5::rank == 5>::type* = nullptr) {
+  if constexpr (impl::HasStridedData<Array5,IdxPack>::value) {
+    if (impl::offsets_fit<IdxPack>(a))
+      return impl::gather(a.data(), impl::data_offsets(a, i0, i1, i2, i3, i4));
+  }
   Pack<typename Array5::non_const_value_type, IdxPack::n> p;
   vector_simd for (int i = 0; i < IdxPack::n; ++i)
     p[i] = a(i0[i], i1[i], i2[i], i3[i], i4[i]);
   return p;
 }
 
+// The inverse of index: store the values of a compatible Pack in a scalar array
+// at Pack indices, i.e., a(i0[i]) = v[i]. The masked versions only store the
+// slots where the mask is true. Same as index, contiguous indices result in
+// a vector store, and non-contiguous ones in a scatter.
+// NOTE: if an index appears more than once (among the active slots), which
+//       of the corresponding values is stored is unspecified.
+template<typename Array1, typename IdxPack> KOKKOS_INLINE_FUNCTION
+OnlyPackReturn<IdxPack, void>
+scatter (const Array1& a, const IdxPack& i0,
+         const Pack<typename Array1::non_const_value_type, IdxPack::n>& v,
+         typename std::enable_if<Array1::rank == 1>::type* = nullptr) {
+  if constexpr (impl::HasStridedData<Array1,IdxPack>::value) {
+    if (impl::offsets_fit<IdxPack>(a)) {
+      impl::scatter<false>(a.data(), impl::data_offsets(a, i0), v, Mask<IdxPack::n>(true));
+      return;
+    }
+  }
+  vector_simd for (int i = 0; i < IdxPack::n; ++i)
+    a(i0[i]) = v[i];
+}
+
+template<typename Array1, typename IdxPack> KOKKOS_INLINE_FUNCTION
+OnlyPackReturn<IdxPack, void>
+scatter (const Array1& a, const IdxPack& i0,
+         const Pack<typename Array1::non_const_value_type, IdxPack::n>& v,
+         const Mask<IdxPack::n>& m,
+         typename std::enable_if<Array1::rank == 1>::type* = nullptr) {
+  if constexpr (impl::HasStridedData<Array1,IdxPack>::value) {
+    if (impl::offsets_fit<IdxPack>(a)) {
+      impl::scatter<true>(a.data(), impl::data_offsets(a, i0), v, m);
+      return;
+    }
+  }
+  vector_simd for (int i = 0; i < IdxPack::n; ++i)
+    if (m[i]) a(i0[i]) = v[i];
+}
+
+template<typename Array2, typename IdxPack> KOKKOS_INLINE_FUNCTION
+OnlyPackReturn<IdxPack, void>
+scatter (const Array2& a, const IdxPack& i0, const IdxPack& i1,
+         const Pack<typename Array2::non_const_value_type, IdxPack::n>& v,
+         typename std::enable_if<Array2::rank == 2>::type* = nullptr) {
+  if constexpr (impl::HasStridedData<Array2,IdxPack>::value) {
+    if (impl::offsets_fit<IdxPack>(a)) {
+      impl::scatter<false>(a.data(), impl::data_offsets(a, i0, i1), v, Mask<IdxPack::n>(true));
+      return;
+    }
+  }
+  vector_simd for (int i = 0; i < IdxPack::n; ++i)
+    a(i0[i], i1[i]) = v[i];
+}
+
+template<typename Array2, typename IdxPack> KOKKOS_INLINE_FUNCTION
+OnlyPackReturn<IdxPack, void>
+scatter (const Array2& a, const IdxPack& i0, const IdxPack& i1,
+         const Pack<typename Array2::non_const_value_type, IdxPack::n>& v,
+         const Mask<IdxPack::n>& m,
+         typename std::enable_if<Array2::rank == 2>::type* = nullptr) {
+  if constexpr (impl::HasStridedData<Array2,IdxPack>::value) {
+    if (impl::offsets_fit<IdxPack>(a)) {
+      impl::scatter<true>(a.data(), impl::data_offsets(a, i0, i1), v, m);
+      return;
+    }
+  }
+  vector_simd for (int i = 0; i < IdxPack::n; ++i)
+    if (m[i]) a(i0[i], i1[i]) = v[i];
+}
+
 // Index a scalar array with Pack indices, returning a two compatible Packs of array
 // values, one with the indexes shifted by Shift. This is useful for implementing
 // functions like:
@@ -85,6 +259,18 @@ index_and_shift (const Array1& a, const IdxPack& i0, Pack<typename Array1::non_c
   // happen if client tries to use values that fall outside of valid range.
   using scalar_t = typename Array1::non_const_value_type;
   index_shift = Pack<scalar_t, IdxPack::n>(invalid<scalar_t>());
+#else
+  // Same as index, read from the View data, if possible. In debug, we need
+  // to check each shifted index instead (see below).
+  if constexpr (impl::HasStridedData<Array1,IdxPack>::value) {
+    if (impl::offsets_fit<IdxPack>(a)) {
+      using idx_t = typename IdxPack::scalar;
+      const IdxPack off = impl::data_offsets(a, i0);
+      index       = impl::gather(a.data(), off);
+      index_shift = impl::gather(a.data(), off + static_cast<idx_t>(Shift*a.stride(0)));
+      return;
+    }
+  }
 #endif
   vector_simd for (int i = 0; i < IdxPack::n; ++i) {
     const auto i0i = i0[i];
@@ -278,6 +464,127 @@ auto repack (const Kokkos::View<DT,Props...>& src)
   return dst_view_t(packed_data,layout);
 }
 
+// Copy src into dst, converting each entry to the value type of dst, e.g., from
+// a View of Pack<float,N> to a View of Pack<double,N> (or vice versa), or from a
+// View of float to a View of double. The arguments order is the same as in
+// Kokkos::deep_copy. The two views must have the same rank, extents and strides,
+// contiguous data, and be accessible from the execution space of dst.
+// For Pack entries, the conversion is vectorized (see the Pack converting ctor).
+// E.g., the state can be stored in single precision (halving memory traffic),
+// and converted to double precision only where the accuracy is needed.
+template<typename DstView, typename SrcView>
+void convert_copy (const DstView& dst, const SrcView& src)
+{
+  using dst_value_t = typename DstView::non_const_value_type;
+  using src_value_t = typename SrcView::non_const_value_type;
+  using exe_space_t = typename DstView::execution_space;
+  constexpr int rank = DstView::rank;
+
+  static_assert (static_cast<int>(SrcView::rank)==rank,
+      "Error! convert_copy requires views of the same rank.\n");
+  static_assert (IsPack<dst_value_t>::value==IsPack<src_value_t>::value,
+      "Error! convert_copy cannot convert between scalars and packs (use repack/scalarize).\n");
+  static_assert (Kokkos::SpaceAccessibility<exe_space_t,typename SrcView::memory_space>::accessible,
+      "Error! The src view of convert_copy must be accessible from the execution space of dst.\n");
+
+  for (int r=0; r<rank; ++r) {
+    EKAT_REQUIRE_MSG (dst.extent(r)==src.extent(r) and dst.stride(r)==src.stride(r),
+        "Error! convert_copy requires views with the same extents and strides.\n");
+  }
+  EKAT_REQUIRE_MSG (dst.span_is_contiguous() and src.span_is_contiguous(),
+      "Error! convert_copy requires views with contiguous data.\n");
+
+  const auto d = dst.data();
+  const auto s = src.data();
+  Kokkos::parallel_for ("ekat::convert_copy",
+                        Kokkos::RangePolicy<exe_space_t>(0,dst.span()),
+                        KOKKOS_LAMBDA (const int i) {
+    d[i] = dst_value_t(s[i]);
+  });
+}
+
+//
+// Aligned, padded views
+//
+
+// Alignment (in bytes) guaranteed for the data of Views with the Kokkos::Aligned
+// memory trait (see AlignedMemoryTrait in ekat_kokkos_types.hpp). Kokkos checks
+// it when the View is constructed (64 bytes, unless Kokkos is configured otherwise).
+constexpr int view_alignment = static_cast<int>(Kokkos::Impl::MEMORY_ALIGNMENT);
+
+// Whether the data of ViewT is guaranteed to be aligned to view_alignment bytes.
+// NOTE: scalarize and repack preserve the memory traits of the input view,
+//       hence this trait too.
+template<typename ViewT>
+struct IsAlignedView
+ : std::integral_constant<bool,ViewT::traits::memory_traits::is_aligned> {};
+
+// Number of entries of type ValueT (a scalar or a Pack) that the last dimension
+// of an aligned view must have, to store n scalars, and be such that its size
+// in bytes is a multiple of view_alignment. If ValueT is not a Pack, the result
+// is also a multiple of PackSize, so that the view can be repack-ed.
+// E.g., for n=50 and view_alignment=64, padded_extent<Pack<double,4>>(n)=14,
+// padded_extent<Pack<double,16>>(n)=4, and padded_extent<double,16>(n)=64.
+template<typename ValueT, int PackSize = 1>
+constexpr int padded_extent (const int n)
+{
+  static_assert (not IsPack<ValueT>::value or PackSize==1,
+      "Error! PackSize is only meaningful for scalar ValueT.\n");
+  using scalar_t = typename ScalarTraits<ValueT>::scalar_type;
+  constexpr int pack_size = IsPack<ValueT>::value ? sizeof(ValueT)/sizeof(scalar_t) : PackSize;
+  constexpr int pack_bytes = pack_size*sizeof(scalar_t);
+
+  // Number of packs in the smallest aligned chunk made of whole packs
+  constexpr int chunk = std::lcm(pack_bytes,view_alignment) / pack_bytes;
+  const int npacks = (PackInfo<pack_size>::num_packs(n) + chunk - 1) / chunk * chunk;
+  return IsPack<ValueT>::value ? npacks : npacks*pack_size;
+}
+
+// Allocate a View of ValueT (a scalar or a Pack), with the Kokkos::Aligned memory
+// trait. The last input dimension is the number of *scalars* along the last
+// (i.e., contiguous) dimension, which is padded as in padded_extent. Hence, all
+// the slices along the last dimension (e.g., subview(v,i,Kokkos::ALL)) are
+// aligned too, and the view (or any of its slices) can be scalarize-d, or
+// repack-ed to Pack<scalar,PackSize>, keeping the alignment guarantee.
+// Padding entries are zero-initialized, like the rest of the view.
+// Example (v.extent(1)=14, v.extent(2)=16, v.extent(3)=4 for view_alignment=64):
+//   auto v = allocate_aligned<Pack<double,4>>("v",ncol,50);
+//   auto w = allocate_aligned<double,DefaultDevice,16>("w",ncol,50);
+//   auto p = allocate_aligned<Pack<double,16>>("p",ncol,50);
+template<typename ValueT, typename DeviceT = DefaultDevice, int PackSize = 1, typename... Dims>
+typename KokkosTypes<DeviceT>::template view_ND<ValueT,sizeof...(Dims),AlignedMemoryTrait>
+allocate_aligned (const std::string& label, const Dims... dims)
+{
+  using view_t = typename KokkosTypes<DeviceT>::template view_ND<ValueT,sizeof...(Dims),AlignedMemoryTrait>;
+  constexpr int rank = sizeof...(Dims);
+  static_assert (rank>=1 and rank<=7, "Error! allocate_aligned only supports rank-1 to rank-7 views.\n");
+
+  const int d[] = {static_cast<int>(dims)...};
+  typename view_t::array_layout layout;
+  for (int i=0; i<rank-1; ++i) {
+    layout.dimension[i] = d[i];
+  }
+  layout.dimension[rank-1] = padded_extent<ValueT,PackSize>(d[rank-1]);
+
+  return view_t(label,layout);
+}
+
+// Return v.data(). If v has the Kokkos::Aligned memory trait, also let the compiler
+// know that the pointer is aligned, so that loops over the entries of v can use
+// aligned loads/stores, without peeling or runtime alignment checks.
+template<typename ViewT>
+KOKKOS_FORCEINLINE_FUNCTION
+typename ViewT::pointer_type aligned_data (const ViewT& v)
+{
+#if defined(__GNUC__) || defined(__clang__)
+  if constexpr (IsAlignedView<ViewT>::value) {
+    using ptr_t = typename ViewT::pointer_type;
+    return static_cast<ptr_t>(__builtin_assume_aligned(v.data(),view_alignment));
+  }
+#endif
+  return v.data();
+}
+
 //
 // Take an array of Host scalar pointers and turn them into device pack views
 //
@@ -3,62 +3,257 @@
 
 #include "ekat.hpp"
 #include "ekat_math_utils.hpp"
+#include "ekat_pack_vmath.hpp"
 
 #include <Kokkos_MathematicalFunctions.hpp>
 
 namespace ekat {
 
+// The accuracy A selects between libm and the vector kernels
+// in ekat_pack_vmath.hpp. E.g., exp<vmath::Accuracy::Fast>(p).
+// Without A, the default (see EKAT_PACK_MATH_ACCURACY) is used.
 #define ekat_pack_gen_unary_fn(fn)                  \
-  template <typename ScalarT, int N>                \
+  template <vmath::Accuracy A, typename ScalarT, int N> \
   KOKKOS_INLINE_FUNCTION                            \
   Pack<ScalarT,N> fn (const Pack<ScalarT,N>& p) {   \
     Pack<ScalarT,N> s;                              \
     vector_simd                                     \
     for (int i = 0; i < N; ++i) {                   \
-      s[i] = Kokkos::fn(p[i]);                      \
+      s[i] = vmath::fn<A>(p[i]);                    \
     }                                               \
     return s;                                       \
+  }                                                 \
+  template <typename ScalarT, int N>                \
+  KOKKOS_INLINE_FUNCTION                            \
+  Pack<ScalarT,N> fn (const Pack<ScalarT,N>& p) {   \
+    return fn<vmath::default_accuracy>(p);          \
   }
 
-ekat_pack_gen_unary_fn(abs)
+// Same as above, but for functions that the explicit-SIMD backend
+// can compute exactly (i.e., BFB with the scalar impl) in simd registers.
+#define ekat_pack_gen_unary_simd_fn(fn)             \
+  template <typename ScalarT, int N>                \
+  KOKKOS_INLINE_FUNCTION                            \
+  Pack<ScalarT,N> fn (const Pack<ScalarT,N>& p) {   \
+    Pack<ScalarT,N> s;                              \
+    if constexpr (impl::PackSimd<ScalarT,N>::enabled) { \
+      using simd = impl::PackSimd<ScalarT,N>;       \
+      simd::store(simd::fn(simd::load(p.data())),   \
+                  s.data());                        \
+    } else {                                        \
+      vector_simd                                   \
+      for (int i = 0; i < N; ++i) {                 \
+        s[i] = Kokkos::fn(p[i]);                    \
+      }                                             \
+    }                                               \
+    return s;                                       \
+  }
+
+ekat_pack_gen_unary_simd_fn(abs)
 ekat_pack_gen_unary_fn(exp)
 ekat_pack_gen_unary_fn(expm1)
 ekat_pack_gen_unary_fn(log)
 ekat_pack_gen_unary_fn(log10)
 ekat_pack_gen_unary_fn(tgamma)
-ekat_pack_gen_unary_fn(sqrt)
+ekat_pack_gen_unary_simd_fn(sqrt)
 ekat_pack_gen_unary_fn(cbrt)
 ekat_pack_gen_unary_fn(tanh)
 ekat_pack_gen_unary_fn(erf)
 
 // Cleanup the macros we used simply to generate code
 #undef ekat_pack_gen_unary_fn
+#undef ekat_pack_gen_unary_simd_fn
+
+// ------------------------- Reductions over the slots ------------------------- //
+//
+// If Serialize=true, the slots are reduced one after the other, from the first
+// to the last. Otherwise, they are reduced as a tree of depth log2(N) (see
+// impl::tree_reduce), which shortens the dependency chain, and, with the
+// explicit-SIMD backend, is done with in-register shuffles. The two orders can
+// give different sums/products (not BFB), and also different min/max if p
+// contains NaNs (with NaNs, the result is not well defined either way).
+// The masked versions only reduce the slots where the mask is true.
+
+namespace impl {
+
+// Reduce the N values in v with op, as a tree: at each level, the first half
+// of the values is combined with the second half, as v[i] = op(v[i],v[i+h])
+// (for an odd number of values, the middle one is carried to the next level).
+// NOTE: the levels are unrolled at compile time, so that each one is a
+//       fixed-length loop that the compiler can vectorize.
+template <int M, typename T, typename Op>
+KOKKOS_FORCEINLINE_FUNCTION
+void tree_reduce_levels (T* v, const Op& op) {
+  if constexpr (M > 1) {
+    constexpr int h = (M+1)/2;
+    vector_simd for (int i = 0; i < M-h; ++i) v[i] = op(v[i],v[i+h]);
+    tree_reduce_levels<h>(v,op);
+  }
+}
+
+template <int N, typename T, typename Op>
+KOKKOS_FORCEINLINE_FUNCTION
+T tree_reduce (const T* in, const Op& op) {
+  T v[N];
+  vector_simd for (int i = 0; i < N; ++i) v[i] = in[i];
+  tree_reduce_levels<N>(v,op);
+  return v[0];
+}
+
+struct SumOp {
+  template <typename T> KOKKOS_FORCEINLINE_FUNCTION
+  T operator() (const T& a, const T& b) const { return a + b; }
+
+  // Note: x + (-0) == x for all x (including x=-0), while x + 0 != x for x=-0
+  template <typename T> KOKKOS_FORCEINLINE_FUNCTION
+  static constexpr T identity () { return -T(0); }
+
+  template <typename T, int N> KOKKOS_FORCEINLINE_FUNCTION
+  static T simd_reduce (const T* v) { return PackSimd<T,N>::reduce_sum(PackSimd<T,N>::load(v)); }
+};
+
+struct ProdOp {
+  template <typename T> KOKKOS_FORCEINLINE_FUNCTION
+  T operator() (const T& a, const T& b) const { return a * b; }
+
+  template <typename T> KOKKOS_FORCEINLINE_FUNCTION
+  static constexpr T identity () { return T(1); }
+
+  template <typename T, int N> KOKKOS_FORCEINLINE_FUNCTION
+  static T simd_reduce (const T* v) { return PackSimd<T,N>::reduce_prod(PackSimd<T,N>::load(v)); }
+};
+
+struct MinOp {
+  template <typename T> KOKKOS_FORCEINLINE_FUNCTION
+  T operator() (const T& a, const T& b) const { return impl::min(a,b); }
+
+  template <typename T> KOKKOS_FORCEINLINE_FUNCTION
+  static constexpr T identity () {
+    if constexpr (std::is_floating_point<T>::value) { return  Kokkos::Experimental::infinity_v<T>; }
+    else                                             { return  Kokkos::Experimental::finite_max_v<T>; }
+  }
+
+  template <typename T, int N> KOKKOS_FORCEINLINE_FUNCTION
+  static T simd_reduce (const T* v) { return PackSimd<T,N>::reduce_min(PackSimd<T,N>::load(v)); }
+};
+
+struct MaxOp {
+  template <typename T> KOKKOS_FORCEINLINE_FUNCTION
+  T operator() (const T& a, const T& b) const { return impl::max(a,b); }
+
+  template <typename T> KOKKOS_FORCEINLINE_FUNCTION
+  static constexpr T identity () {
+    if constexpr (std::is_floating_point<T>::value) { return -Kokkos::Experimental::infinity_v<T>; }
+    else                                             { return  Kokkos::Experimental::finite_min_v<T>; }
+  }
+
+  template <typename T, int N> KOKKOS_FORCEINLINE_FUNCTION
+  static T simd_reduce (const T* v) { return PackSimd<T,N>::reduce_max(PackSimd<T,N>::load(v)); }
+};
+
+// Reduce the slots of p with Op, in the order selected by Serialize (see above)
+template <bool Serialize, typename Op, typename PackType>
+KOKKOS_FORCEINLINE_FUNCTION
+typename PackType::scalar reduce (const PackType& p) {
+  using scalar = typename PackType::scalar;
+  constexpr int N = PackType::n;
+  const Op op;
+  if constexpr (Serialize) {
+    scalar v(p[0]);
+    for (int i = 1; i < N; ++i) v = op(v,p[i]);
+    return v;
+  } else if constexpr (PackSimd<scalar,N>::enabled and (N & (N-1))==0) {
+    return Op::template simd_reduce<scalar,N>(p.data());
+  } else {
+    return tree_reduce<N>(p.data(),op);
+  }
+}
+
+// Same as above, but only for the slots where m is true. If none is, return Op's identity.
+template <bool Serialize, typename Op, typename PackType>
+KOKKOS_FORCEINLINE_FUNCTION
+typename PackType::scalar reduce (const Mask<PackType::n>& m, const PackType& p) {
+  using scalar = typename PackType::scalar;
+  constexpr scalar id = Op::template identity<scalar>();
+  if constexpr (Serialize) {
+    const Op op;
+    scalar v = id;
+    for (int i = 0; i < PackType::n; ++i) {
+      if (m[i]) v = op(v,p[i]);
+    }
+    return v;
+  } else {
+    // Replace the inactive slots with the identity (which also keeps any
+    // NaN/Inf in there out of the result), and reduce all of them
+    return reduce<false,Op>(PackType(m,p,PackType(id)));
+  }
+}
+
+} // namespace impl
+
+// min/max over the slots of p
+template <bool Serialize, typename PackType> KOKKOS_INLINE_FUNCTION
+OnlyPackReturn<PackType, typename PackType::scalar> reduce_min (const PackType& p) {
+  return impl::reduce<Serialize,impl::MinOp>(p);
+}
+template <typename PackType, bool Serialize = ekatBFB> KOKKOS_INLINE_FUNCTION
+OnlyPackReturn<PackType, typename PackType::scalar> reduce_min (const PackType& p) {
+  return reduce_min<Serialize>(p);
+}
+
+template <bool Serialize, typename PackType> KOKKOS_INLINE_FUNCTION
+OnlyPackReturn<PackType, typename PackType::scalar> reduce_max (const PackType& p) {
+  return impl::reduce<Serialize,impl::MaxOp>(p);
+}
+template <typename PackType, bool Serialize = ekatBFB> KOKKOS_INLINE_FUNCTION
+OnlyPackReturn<PackType, typename PackType::scalar> reduce_max (const PackType& p) {
+  return reduce_max<Serialize>(p);
+}
 
 template <typename PackType> KOKKOS_INLINE_FUNCTION
 OnlyPackReturn<PackType, typename PackType::scalar> min (const PackType& p) {
-  typename PackType::scalar v(p[0]);
-  vector_disabled for (int i = 0; i < PackType::n; ++i) v = impl::min(v, p[i]);
-  return v;
+  return reduce_min(p);
 }
 
 template <typename PackType> KOKKOS_INLINE_FUNCTION
 OnlyPackReturn<PackType, typename PackType::scalar> max (const PackType& p) {
-  typename PackType::scalar v(p[0]);
-  vector_simd for (int i = 0; i < PackType::n; ++i) v = impl::max(v, p[i]);
-  return v;
+  return reduce_max(p);
+}
+
+// return p[0]*p[1]*..., or the product of the slots where m is true (1 if none is)
+template <bool Serialize, typename PackType> KOKKOS_INLINE_FUNCTION
+OnlyPackReturn<PackType, typename PackType::scalar> reduce_prod (const PackType& p) {
+  return impl::reduce<Serialize,impl::ProdOp>(p);
+}
+template <typename PackType, bool Serialize = ekatBFB> KOKKOS_INLINE_FUNCTION
+OnlyPackReturn<PackType, typename PackType::scalar> reduce_prod (const PackType& p) {
+  return reduce_prod<Serialize>(p);
+}
+
+template <bool Serialize, typename PackType> KOKKOS_INLINE_FUNCTION
+OnlyPackReturn<PackType, typename PackType::scalar>
+reduce_prod (const Mask<PackType::n>& m, const PackType& p) {
+  return impl::reduce<Serialize,impl::ProdOp>(m,p);
+}
+template <typename PackType, bool Serialize = ekatBFB> KOKKOS_INLINE_FUNCTION
+OnlyPackReturn<PackType, typename PackType::scalar>
+reduce_prod (const Mask<PackType::n>& m, const PackType& p) {
+  return reduce_prod<Serialize>(m,p);
 }
 
 // sum = sum+p[0]+p[1]+...
 // NOTE: f<bool,T> and f<T,bool> are *guaranteed* to be different overloads.
 //       The latter is better when bool needs a default, the former is
 //       better when bool must be specified, but we want T to be deduced.
+// NOTE: if Serialize=true, the slots are added to sum one at a time; otherwise,
+//       the slots are first reduced as a tree, and the result is added to sum.
 template <bool Serialize, typename PackType>
 KOKKOS_INLINE_FUNCTION
 void reduce_sum (const PackType& p, typename PackType::scalar& sum) {
-  if (Serialize) {
+  if constexpr (Serialize) {
     for (int i = 0; i < PackType::n; ++i) sum += p[i];
   } else {
-    vector_simd for (int i = 0; i < PackType::n; ++i) sum += p[i];
+    sum += impl::reduce<false,impl::SumOp>(p);
   }
 }
 
@@ -82,73 +277,354 @@ OnlyPackReturn<PackType, typename PackType::scalar> reduce_sum (const PackType&
   return reduce_sum<Serialize>(p);
 }
 
+// Same as above, but only for the slots where m is true
+template <bool Serialize, typename PackType>
+KOKKOS_INLINE_FUNCTION
+OnlyPackReturn<PackType,void>
+reduce_sum (const Mask<PackType::n>& m, const PackType& p, typename PackType::scalar& sum) {
+  if constexpr (Serialize) {
+    for (int i = 0; i < PackType::n; ++i) {
+      if (m[i]) sum += p[i];
+    }
+  } else {
+    sum += impl::reduce<false,impl::SumOp>(m,p);
+  }
+}
+template <typename PackType, bool Serialize = ekatBFB>
+KOKKOS_INLINE_FUNCTION
+OnlyPackReturn<PackType,void>
+reduce_sum (const Mask<PackType::n>& m, const PackType& p, typename PackType::scalar& sum) {
+  reduce_sum<Serialize>(m,p,sum);
+}
+
+template <bool Serialize, typename PackType>
+KOKKOS_INLINE_FUNCTION
+OnlyPackReturn<PackType, typename PackType::scalar>
+reduce_sum (const Mask<PackType::n>& m, const PackType& p) {
+  typename PackType::scalar sum = typename PackType::scalar(0);
+  reduce_sum<Serialize>(m,p,sum);
+  return sum;
+}
+template <typename PackType, bool Serialize = ekatBFB>
+KOKKOS_INLINE_FUNCTION
+OnlyPackReturn<PackType, typename PackType::scalar>
+reduce_sum (const Mask<PackType::n>& m, const PackType& p) {
+  return reduce_sum<Serialize>(m,p);
+}
+
+// Mixed precision versions of the above: the pack entries are accumulated into
+// a scalar of a different type AccT (e.g., double, for a Pack<float,N>). The pack
+// is first converted to Pack<AccT,N> (vectorized, see the Pack converting ctor),
+// so that all the additions are done in AccT. E.g.:
+//   double sum = 0;
+//   reduce_sum<Serialize>(pf,sum);            // sum += pf[0]+pf[1]+...
+//   const double s = reduce_sum<double>(pf);  // s = pf[0]+pf[1]+...
+template <typename PackType, typename AccT>
+using OnlyMixedSum =
+  typename std::enable_if<IsPack<PackType>::value and std::is_arithmetic<AccT>::value and
+                          not std::is_same<AccT,typename PackType::scalar>::value>::type;
+
+template <bool Serialize, typename PackType, typename AccT>
+KOKKOS_INLINE_FUNCTION
+OnlyMixedSum<PackType,AccT> reduce_sum (const PackType& p, AccT& sum) {
+  reduce_sum<Serialize>(Pack<AccT,PackType::n>(p),sum);
+}
+
+template <typename PackType, typename AccT, bool Serialize = ekatBFB>
+KOKKOS_INLINE_FUNCTION
+OnlyMixedSum<PackType,AccT> reduce_sum (const PackType& p, AccT& sum) {
+  reduce_sum<Serialize>(p,sum);
+}
+
+template <typename AccT, bool Serialize = ekatBFB, typename PackType>
+KOKKOS_INLINE_FUNCTION
+typename std::enable_if<std::is_arithmetic<AccT>::value, OnlyPackReturn<PackType,AccT>>::type
+reduce_sum (const PackType& p) {
+  AccT sum = AccT(0);
+  reduce_sum<Serialize>(Pack<AccT,PackType::n>(p),sum);
+  return sum;
+}
+
 // min(init, min(p(mask)))
+template <bool Serialize, typename PackType> KOKKOS_INLINE_FUNCTION
+OnlyPackReturn<PackType, typename PackType::scalar>
+reduce_min (const Mask<PackType::n>& mask, const typename PackType::scalar init, const PackType& p) {
+  if constexpr (Serialize) {
+    auto v = init;
+    for (int i = 0; i < PackType::n; ++i)
+      if (mask[i]) v = impl::min(v, p[i]);
+    return v;
+  } else {
+    return impl::min(init, impl::reduce<false,impl::MinOp>(mask,p));
+  }
+}
+template <typename PackType, bool Serialize = ekatBFB> KOKKOS_INLINE_FUNCTION
+OnlyPackReturn<PackType, typename PackType::scalar>
+reduce_min (const Mask<PackType::n>& mask, const typename PackType::scalar init, const PackType& p) {
+  return reduce_min<Serialize>(mask,init,p);
+}
+
 template <typename PackType> KOKKOS_INLINE_FUNCTION
 OnlyPackReturn<PackType, typename PackType::scalar>
 min (const Mask<PackType::n>& mask, typename PackType::scalar init, const PackType& p) {
-  vector_disabled for (int i = 0; i < PackType::n; ++i)
-    if (mask[i]) init = impl::min(init, p[i]);
-  return init;
+  return reduce_min(mask,init,p);
 }
 
 // max(init, max(p(mask)))
+template <bool Serialize, typename PackType> KOKKOS_INLINE_FUNCTION
+OnlyPackReturn<PackType, typename PackType::scalar>
+reduce_max (const Mask<PackType::n>& mask, const typename PackType::scalar init, const PackType& p) {
+  if constexpr (Serialize) {
+    auto v = init;
+    for (int i = 0; i < PackType::n; ++i)
+      if (mask[i]) v = impl::max(v, p[i]);
+    return v;
+  } else {
+    return impl::max(init, impl::reduce<false,impl::MaxOp>(mask,p));
+  }
+}
+template <typename PackType, bool Serialize = ekatBFB> KOKKOS_INLINE_FUNCTION
+OnlyPackReturn<PackType, typename PackType::scalar>
+reduce_max (const Mask<PackType::n>& mask, const typename PackType::scalar init, const PackType& p) {
+  return reduce_max<Serialize>(mask,init,p);
+}
+
 template <typename PackType> KOKKOS_INLINE_FUNCTION
 OnlyPackReturn<PackType, typename PackType::scalar>
 max (const Mask<PackType::n>& mask, typename PackType::scalar init, const PackType& p) {
-  vector_simd for (int i = 0; i < PackType::n; ++i)
-    if (mask[i]) init = impl::max(init, p[i]);
-  return init;
+  return reduce_max(mask,init,p);
 }
 
 // On Intel 17 for KNL, I'm getting a ~1-ulp diff on const Scalar& b. I don't
 // understand its source. But, in any case, I'm writing a separate impl here to
 // get around that.
 //ekat_pack_gen_bin_fn_all(pow, std::pow)
-template <typename PackType, typename ScalarType>
+// As for the unary fcns above, A selects libm (Exact) or the vector kernel.
+template <vmath::Accuracy A, typename PackType, typename ScalarType>
 KOKKOS_INLINE_FUNCTION
 OnlyPack<PackType> pow (const PackType& a, const ScalarType/*&*/ b) {
   PackType s;
   vector_simd for (int i = 0; i < PackType::n; ++i)
-    s[i] = std::pow(a[i], b);
+    s[i] = vmath::pow<A>(a[i], b);
   return s;
 }
 
-template <typename ScalarType, typename PackType>
+template <vmath::Accuracy A, typename ScalarType, typename PackType>
 KOKKOS_INLINE_FUNCTION
 OnlyPack<PackType> pow (const ScalarType a, const PackType& b) {
   PackType s;
   vector_simd for (int i = 0; i < PackType::n; ++i)
-    s[i] = std::pow(a, b[i]);
+    s[i] = vmath::pow<A>(a, b[i]);
   return s;
 }
 
-template <typename PackType>
+template <vmath::Accuracy A, typename PackType>
 KOKKOS_INLINE_FUNCTION
 OnlyPack<PackType> pow (const PackType& a, const PackType& b) {
   PackType s;
   vector_simd for (int i = 0; i < PackType::n; ++i)
-    s[i] = std::pow(a[i], b[i]);
+    s[i] = vmath::pow<A>(a[i], b[i]);
   return s;
 }
 
+template <typename PackType, typename ScalarType>
+KOKKOS_INLINE_FUNCTION
+OnlyPack<PackType> pow (const PackType& a, const ScalarType/*&*/ b) {
+  return pow<vmath::default_accuracy>(a, b);
+}
+
+template <typename ScalarType, typename PackType>
+KOKKOS_INLINE_FUNCTION
+OnlyPack<PackType> pow (const ScalarType a, const PackType& b) {
+  return pow<vmath::default_accuracy>(a, b);
+}
+
+template <typename PackType>
+KOKKOS_INLINE_FUNCTION
+OnlyPack<PackType> pow (const PackType& a, const PackType& b) {
+  return pow<vmath::default_accuracy>(a, b);
+}
+
 template <typename PackType>
 KOKKOS_INLINE_FUNCTION
 OnlyPack<PackType> square (const PackType& a) {
+  using simd = impl::PackSimd<typename PackType::scalar,PackType::n>;
   PackType s;
-  vector_simd for (int i = 0; i < PackType::n; ++i)
-    s[i] = a[i] * a[i];
+  if constexpr (simd::enabled) {
+    const auto v = simd::load(a.data());
+    simd::store(v*v,s.data());
+  } else {
+    vector_simd for (int i = 0; i < PackType::n; ++i)
+      s[i] = a[i] * a[i];
+  }
   return s;
 }
 
 template <typename PackType>
 KOKKOS_INLINE_FUNCTION
 OnlyPack<PackType> cube (const PackType& a) {
+  using simd = impl::PackSimd<typename PackType::scalar,PackType::n>;
   PackType s;
-  vector_simd for (int i = 0; i < PackType::n; ++i)
-    s[i] = a[i] * a[i] * a[i];
+  if constexpr (simd::enabled) {
+    const auto v = simd::load(a.data());
+    simd::store(v*v*v,s.data());
+  } else {
+    vector_simd for (int i = 0; i < PackType::n; ++i)
+      s[i] = a[i] * a[i] * a[i];
+  }
+  return s;
+}
+
+// ---------------------- Fused multiply-add and friends ---------------------- //
+//
+//   fma(a,b,c)  = a*b + c
+//   fms(a,b,c)  = a*b - c
+//   fnma(a,b,c) = c - a*b
+//   horner(x,c0,c1,...,cn) = c0 + x*(c1 + x*(... + x*cn)), i.e., n fma's
+//
+// The args can be scalars, or a mix of packs (of the same type) and scalars;
+// scalar args are converted to the pack scalar type.
+//
+// With hardware fma (which includes all GPUs), each op is rounded once, as by
+// std::fma, regardless of whether the compiler contracts a*b+c expressions
+// (which depends on compiler and flags). Without hardware fma (e.g., x86 builds
+// w/o -mfma), a correctly rounded fma must be emulated in software, which is
+// much slower, and does not vectorize. In that case, if BFB (by default,
+// ekatBFB) is false we use a*b+c (two roundings); otherwise we use the software
+// fma, so that results are BFB with those on targets with hardware fma.
+
+namespace impl {
+
+// Whether the target has hardware fma for T
+template <typename T> struct HasFastFma : std::false_type {};
+#if defined(__CUDA_ARCH__) || defined(__HIP_DEVICE_COMPILE__) || defined(__SYCL_DEVICE_ONLY__)
+template <> struct HasFastFma<double> : std::true_type {};
+template <> struct HasFastFma<float>  : std::true_type {};
+#else
+# ifdef __FP_FAST_FMA
+template <> struct HasFastFma<double> : std::true_type {};
+# endif
+# ifdef __FP_FAST_FMAF
+template <> struct HasFastFma<float>  : std::true_type {};
+# endif
+#endif
+
+// The first Pack type in Ts (void if none)
+template <typename... Ts> struct FirstPack { using type = void; };
+template <typename T, typename... Ts>
+struct FirstPack<T,Ts...> {
+  using type = typename std::conditional<IsPack<T>::value,T,typename FirstPack<Ts...>::type>::type;
+};
+
+// The pack type of the args of a mixed pack/scalar op, if all packs are of the same type,
+// and all other args are arithmetic types
+template <typename... Ts>
+using OnlyPackArgs =
+  typename std::enable_if<not std::is_void<typename FirstPack<Ts...>::type>::value and
+                          ((std::is_same<Ts,typename FirstPack<Ts...>::type>::value or
+                            std::is_arithmetic<Ts>::value) and ...),
+                          typename FirstPack<Ts...>::type>::type;
+
+// Slot i of a pack arg, or a scalar arg (converted to the pack scalar type)
+template <typename PackType, typename T>
+KOKKOS_FORCEINLINE_FUNCTION
+typename PackType::scalar pack_arg (const T& x, const int i) {
+  if constexpr (IsPack<T>::value) { return x[i]; }
+  else                            { return typename PackType::scalar(x); }
+}
+
+} // namespace impl
+
+template <bool BFB, typename ScalarT>
+KOKKOS_FORCEINLINE_FUNCTION
+typename std::enable_if<std::is_floating_point<ScalarT>::value,ScalarT>::type
+fma (const ScalarT a, const ScalarT b, const ScalarT c) {
+  if constexpr (BFB or impl::HasFastFma<ScalarT>::value) {
+    return Kokkos::fma(a,b,c);
+  } else {
+    return a*b + c;
+  }
+}
+
+template <bool BFB, typename A, typename B, typename C>
+KOKKOS_FORCEINLINE_FUNCTION
+impl::OnlyPackArgs<A,B,C> fma (const A& a, const B& b, const C& c) {
+  using PackType = impl::OnlyPackArgs<A,B,C>;
+  using scalar = typename PackType::scalar;
+  using simd = impl::PackSimd<scalar,PackType::n>;
+  constexpr bool fast = impl::HasFastFma<scalar>::value;
+  PackType s;
+  if constexpr (simd::enabled and (fast or not BFB)) {
+    const auto load = [](const auto& x) {
+      if constexpr (IsPack<std::decay_t<decltype(x)>>::value) { return simd::load(x.data()); }
+      else { return typename simd::simd_t(scalar(x)); }
+    };
+    if constexpr (fast) {
+      simd::store(simd::fma(load(a),load(b),load(c)),s.data());
+    } else {
+      simd::store(load(a)*load(b) + load(c),s.data());
+    }
+  } else {
+    vector_simd for (int i = 0; i < PackType::n; ++i) {
+      s[i] = fma<BFB>(impl::pack_arg<PackType>(a,i),
+                      impl::pack_arg<PackType>(b,i),
+                      impl::pack_arg<PackType>(c,i));
+    }
+  }
   return s;
 }
 
+template <bool BFB, typename A, typename B, typename C>
+KOKKOS_FORCEINLINE_FUNCTION
+auto fms (const A& a, const B& b, const C& c) -> decltype(fma<BFB>(a,b,c)) {
+  return fma<BFB>(a,b,-c);
+}
+
+template <bool BFB, typename A, typename B, typename C>
+KOKKOS_FORCEINLINE_FUNCTION
+auto fnma (const A& a, const B& b, const C& c) -> decltype(fma<BFB>(a,b,c)) {
+  return fma<BFB>(-a,b,c);
+}
+
+template <bool BFB, typename T, typename C0>
+KOKKOS_FORCEINLINE_FUNCTION
+typename std::enable_if<IsPack<T>::value or std::is_floating_point<T>::value,T>::type
+horner (const T& /* x */, const C0 c0) {
+  return T(c0);
+}
+
+template <bool BFB, typename T, typename C0, typename... Cs>
+KOKKOS_FORCEINLINE_FUNCTION
+typename std::enable_if<IsPack<T>::value or std::is_floating_point<T>::value,T>::type
+horner (const T& x, const C0 c0, const Cs... cs) {
+  return fma<BFB>(x,horner<BFB>(x,cs...),T(c0));
+}
+
+// Same as above, with BFB=ekatBFB
+template <typename A, typename B, typename C, bool BFB = ekatBFB>
+KOKKOS_FORCEINLINE_FUNCTION
+auto fma (const A& a, const B& b, const C& c) -> decltype(fma<BFB>(a,b,c)) {
+  return fma<BFB>(a,b,c);
+}
+
+template <typename A, typename B, typename C, bool BFB = ekatBFB>
+KOKKOS_FORCEINLINE_FUNCTION
+auto fms (const A& a, const B& b, const C& c) -> decltype(fma<BFB>(a,b,c)) {
+  return fms<BFB>(a,b,c);
+}
+
+template <typename A, typename B, typename C, bool BFB = ekatBFB>
+KOKKOS_FORCEINLINE_FUNCTION
+auto fnma (const A& a, const B& b, const C& c) -> decltype(fma<BFB>(a,b,c)) {
+  return fnma<BFB>(a,b,c);
+}
+
+template <typename T, typename... Cs>
+KOKKOS_FORCEINLINE_FUNCTION
+auto horner (const T& x, const Cs... cs) -> decltype(horner<ekatBFB>(x,cs...)) {
+  return horner<ekatBFB>(x,cs...);
+}
+
 } // namespace ekat
 
 #endif // EKAT_PACK_MATH_HPP
@@ -0,0 +1,255 @@
+#ifndef EKAT_PACK_SIMD_HPP
+#define EKAT_PACK_SIMD_HPP
+
+#include <type_traits>
+
+#ifdef EKAT_PACK_SIMD_STDSIMD
+# include <experimental/simd>
+# include <bitset>
+# include <tuple>
+# if defined(__AVX2__) || defined(__AVX512F__)
+#  include <immintrin.h>
+# endif
+#endif
+
+namespace ekat {
+namespace impl {
+
+/*
+ * Explicit-SIMD backend for Pack and Mask.
+ *
+ * Pack always stores its slots in a plain C array, so that operator[] can
+ * keep returning a reference to a single slot. Mask stores its slots in an
+ * int array, or as bits if EKAT_PACK_MASK_BITS is defined; MaskSimd hides the
+ * difference when moving a Mask in/out of a mask register. By default,
+ * all operators are plain loops annotated with vector_simd, which means
+ * vectorization is entirely up to the compiler heuristics.
+ *
+ * If EKAT is configured with EKAT_PACK_SIMD_BACKEND=STDSIMD, the operators
+ * in ekat_pack.hpp (and a few in ekat_pack_math.hpp) instead load the array
+ * in a std::experimental::simd register, operate on it, and store it back,
+ * so that native vector instructions are used regardless of the compiler
+ * heuristics. Pack code selects the simd path via
+ *
+ *   if constexpr (impl::PackSimd<T,N>::enabled) { ... }
+ *
+ * so that when the backend is off (or T/N cannot be mapped to a simd
+ * register, e.g., N=1 or T=Pack<...>) nothing in here is ever instantiated.
+ *
+ * NOTE: the simd path is only used when it produces the same result as the
+ *       scalar loop. E.g., Pack<float,N> op double is NOT routed through the
+ *       simd path, since rounding the double to float first would change
+ *       the result. See SimdSameType below.
+ */
+
+template<typename T, int N, typename = void>
+struct PackSimd {
+  static constexpr bool enabled = false;
+};
+
+template<int N, typename = void>
+struct MaskSimd {
+  static constexpr bool enabled = false;
+};
+
+// Whether an operation between T and S can be performed on T simd registers
+// without changing the result of the scalar loop.
+template<typename T, typename S>
+struct SimdSameType : std::is_same<std::remove_cv_t<T>,std::remove_cv_t<S>> {};
+
+// Whether a coefficient of type C can be converted to T before multiplying
+// it with a T, without changing the result of the scalar loop.
+template<typename T, typename C>
+struct SimdCoeffType
+ : std::integral_constant<bool,SimdSameType<T,C>::value or
+                               (std::is_integral<C>::value and std::is_floating_point<T>::value)> {};
+
+#ifdef EKAT_PACK_SIMD_STDSIMD
+
+namespace stdx = std::experimental;
+
+template<int N>
+struct MaskSimd<N,std::enable_if_t<(N>1)>>
+{
+  static constexpr bool enabled = true;
+
+  // Masks of fixed_size simd types are implicitly convertible to each
+  // other, so we expose the mask of an int simd register, which can then be
+  // used directly with any PackSimd<T,N>.
+  using int_simd_t = stdx::fixed_size_simd<int,N>;
+  using mask_t = typename int_simd_t::mask_type;
+
+  // Convert between the bits of a bit-packed Mask (see EKAT_PACK_MASK_BITS)
+  // and a mask register MT. With libstdc++ we can use the bitset extension,
+  // which maps to a single kmov on targets with mask registers (AVX-512).
+  template<typename MT, typename B>
+  static MT from_bits (const B bits) {
+#ifdef __GLIBCXX__
+    return MT::__from_bitset(std::bitset<N>(bits));
+#else
+    return MT(int_simd_t([&](auto i) { return int((bits>>int(i)) & 1); })!=0);
+#endif
+  }
+  template<typename B, typename MT>
+  static B to_bits (const MT& m) {
+#ifdef __GLIBCXX__
+    return static_cast<B>(m.__to_bitset().to_ullong());
+#else
+    B bits = 0;
+    for (int i = 0; i < N; ++i) if (m[i]) bits |= B(1) << i;
+    return bits;
+#endif
+  }
+
+  // Load/store a Mask<N> from/to a mask register MT, regardless of
+  // how the Mask stores its slots.
+  template<typename MT, typename M>
+  static MT load (const M& m) {
+    if constexpr (M::is_bitmask) {
+      return from_bits<MT>(m.bits());
+    } else {
+      return MT(int_simd_t(m.data(),stdx::element_aligned)!=0);
+    }
+  }
+  template<typename MT, typename M>
+  static void store (const MT& sm, M& m) {
+    if constexpr (M::is_bitmask) {
+      m.bits() = to_bits<typename M::bits_type>(sm);
+    } else {
+      int_simd_t v(0);
+      stdx::where(mask_t(sm),v) = 1;
+      v.copy_to(m.data(),stdx::element_aligned);
+    }
+  }
+  template<typename M> static mask_t load (const M& m) { return load<mask_t>(m); }
+
+  static bool any (const mask_t& m) { return stdx::any_of(m); }
+  static bool all (const mask_t& m) { return stdx::all_of(m); }
+};
+
+template<typename T, int N>
+struct PackSimd<T,N,std::enable_if_t<std::is_arithmetic<T>::value and
+                                     not std::is_same<T,bool>::value and
+                                     (N>1)>>
+{
+  static constexpr bool enabled = true;
+
+  using simd_t = stdx::fixed_size_simd<T,N>;
+  using mask_t = typename simd_t::mask_type;
+
+  static simd_t load (const T* p) { return simd_t(p,stdx::element_aligned); }
+  static void store (const simd_t& v, T* p) { v.copy_to(p,stdx::element_aligned); }
+
+  // Load/store a Mask<N> from/to a mask register for this simd type
+  template<typename M>
+  static mask_t load_mask (const M& m) { return MaskSimd<N>::template load<mask_t>(m); }
+  template<typename M>
+  static void store_mask (const mask_t& sm, M& m) { MaskSimd<N>::store(sm,m); }
+
+  // Return m ? t : f
+  static simd_t blend (const mask_t& m, const simd_t& t, const simd_t& f) {
+    simd_t r = f;
+    stdx::where(m,r) = t;
+    return r;
+  }
+
+  // Convert a register of another arithmetic type, slot by slot, as static_cast<T> would
+  template<typename S>
+  static simd_t convert (const stdx::fixed_size_simd<S,N>& v) { return stdx::static_simd_cast<simd_t>(v); }
+
+  static simd_t abs  (const simd_t& v) { return stdx::abs(v); }
+  static simd_t sqrt (const simd_t& v) { return stdx::sqrt(v); }
+
+  // Same semantic (including NaN and signed zero handling) as std::min/max,
+  // which is what impl::min/max resolve to on host
+  static simd_t min (const simd_t& a, const simd_t& b) { return blend(b<a,b,a); }
+  static simd_t max (const simd_t& a, const simd_t& b) { return blend(a<b,b,a); }
+
+  // a*b+c with a single rounding. Only use if the target has hardware fma
+  // (see HasFastFma in ekat_pack_math.hpp), or it is done in software, slot by slot.
+  static simd_t fma (const simd_t& a, const simd_t& b, const simd_t& c) { return stdx::fma(a,b,c); }
+
+  // Only valid for floating point T
+  static mask_t isnan (const simd_t& v) { return stdx::isnan(v); }
+
+  // Return [a, b[0], ..., b[N-2]]
+  static simd_t shift_right (const T a, const simd_t& b) {
+    return simd_t([&](auto i) {
+      constexpr int k = i;
+      if constexpr (k==0) { return a; }
+      else                { return T(b[k-1]); }
+    });
+  }
+  // Return [b[1], ..., b[N-1], a]
+  static simd_t shift_left (const T a, const simd_t& b) {
+    return simd_t([&](auto i) {
+      constexpr int k = i;
+      if constexpr (k==N-1) { return a; }
+      else                  { return T(b[k+1]); }
+    });
+  }
+
+  // Reduce the slots of v as a tree, using in-register shuffles: at each level,
+  // the lower half of the register is combined with the upper half, slot by
+  // slot. For power-of-2 N, this is the same order as impl::tree_reduce, so
+  // the result does not depend on the backend.
+  static T reduce_sum  (const simd_t& v) { return reduce_halves(v,[](const auto& a, const auto& b) { return a+b; }); }
+  static T reduce_prod (const simd_t& v) { return reduce_halves(v,[](const auto& a, const auto& b) { return a*b; }); }
+  static T reduce_min  (const simd_t& v) {
+    return reduce_halves(v,[](const auto& a, const auto& b) { auto r = a; stdx::where(b<a,r) = b; return r; });
+  }
+  static T reduce_max  (const simd_t& v) {
+    return reduce_halves(v,[](const auto& a, const auto& b) { auto r = a; stdx::where(a<b,r) = b; return r; });
+  }
+
+  template<typename V, typename Op>
+  static T reduce_halves (const V& v, const Op& op) {
+    constexpr int m = V::size();
+    if constexpr (m==1) {
+      return v[0];
+    } else {
+      static_assert (m%2==0, "Error! reduce_halves requires a power-of-2 simd size.\n");
+      const auto halves = stdx::split<m/2,m/2>(v);
+      return reduce_halves(op(std::get<0>(halves),std::get<1>(halves)),op);
+    }
+  }
+
+  // Return [p[idx[0]], ..., p[idx[N-1]]]. std::experimental::simd has no gather,
+  // and compilers rarely emit gather instructions for loops (or the generator
+  // ctor), so, for int indices, we use the AVX-512/AVX2 gathers directly.
+  template<typename I>
+  static simd_t gather (const T* p, const I* idx) {
+#if defined(__AVX512F__) || defined(__AVX2__)
+    if constexpr (std::is_same<I,int>::value and
+                  (std::is_same<T,double>::value or std::is_same<T,float>::value)) {
+      alignas(64) T v[N];
+      int k = 0;
+      if constexpr (std::is_same<T,double>::value) {
+# ifdef __AVX512F__
+        for (; k+8 <= N; k += 8)
+          _mm512_store_pd(v+k, _mm512_i32gather_pd(_mm256_loadu_si256((const __m256i*)(idx+k)), p, 8));
+# endif
+        for (; k+4 <= N; k += 4)
+          _mm256_store_pd(v+k, _mm256_i32gather_pd(p, _mm_loadu_si128((const __m128i*)(idx+k)), 8));
+      } else {
+# ifdef __AVX512F__
+        for (; k+16 <= N; k += 16)
+          _mm512_store_ps(v+k, _mm512_i32gather_ps(_mm512_loadu_si512(idx+k), p, 4));
+# endif
+        for (; k+8 <= N; k += 8)
+          _mm256_store_ps(v+k, _mm256_i32gather_ps(p, _mm256_loadu_si256((const __m256i*)(idx+k)), 4));
+      }
+      for (; k < N; ++k) v[k] = p[idx[k]];
+      return simd_t(v,stdx::element_aligned);
+    }
+#endif
+    return simd_t([&](auto i) { return p[idx[int(i)]]; });
+  }
+};
+
+#endif // EKAT_PACK_SIMD_STDSIMD
+
+} // namespace impl
+} // namespace ekat
+
+#endif // EKAT_PACK_SIMD_HPP
@@ -0,0 +1,223 @@
+#ifndef EKAT_PACK_TUNER_HPP
+#define EKAT_PACK_TUNER_HPP
+
+#include "ekat_assert.hpp"
+
+#include <Kokkos_Core.hpp>
+
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <limits>
+#include <map>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace ekat {
+
+/*
+ * PackSizeTuner picks the best pack size for a kernel at runtime.
+ *
+ * The kernel is a callable templated on the pack size, which it receives as
+ * a std::integral_constant<int,N>, so that all the candidate pack sizes are
+ * compiled. E.g.:
+ *
+ *   auto& tuner = pack_size_tuner();
+ *   tuner.run("lin_interp", {ncol,km1,km2}, [&](auto pack_size) {
+ *     constexpr int N = decltype(pack_size)::value;
+ *     LinInterp<Real,N> li(ncol,km1,km2);
+ *     ...
+ *   });
+ *
+ * The first time a kernel is run for a given shape (i.e., the problem sizes,
+ * or whatever else the performance depends on), each candidate pack size is
+ * run and timed (nreps times, keeping the fastest), and the winner is stored.
+ * Later calls (with the same name and shape) only run the winner. Therefore,
+ * the kernel must be safe to run several times (e.g., compute its outputs
+ * only from its inputs), and the shape should be kept coarse enough that the
+ * tuning cost is amortized.
+ *
+ * Decisions are also stored in a small text file (one "key pack_size time"
+ * line per decision, later lines override earlier ones), so that subsequent
+ * runs on the same machine skip the tuning. The key includes the name of the
+ * Kokkos default execution space, but NOT the machine, so use a separate
+ * cache file for each machine/build. The default tuner uses the file in the
+ * EKAT_PACK_TUNER_CACHE environment variable, if set; otherwise, decisions
+ * are only kept in memory. In MPI runs, each rank tunes independently; the
+ * timings may differ among ranks, so one may want to broadcast the choice.
+ *
+ * All decisions are available via decisions(), so that one can log which
+ * variant ran (and whether it was timed in this run or read from the cache).
+ */
+
+// Pack sizes tried by default
+using DefaultTunedPackSizes = std::integer_sequence<int,1,2,4,8,16>;
+
+class PackSizeTuner {
+public:
+  struct Decision {
+    int    pack_size;   // The pack size used for this kernel/shape
+    double time;        // Time of the fastest run with pack_size (in seconds)
+    bool   from_cache;  // Whether the decision was read from the cache file
+  };
+
+  // If cache_file is empty, decisions are only kept in memory
+  explicit PackSizeTuner (const std::string& cache_file = "")
+   : m_cache_file (cache_file)
+  {
+    load_cache();
+  }
+
+  // Number of timed runs for each pack size (after one warmup run)
+  void set_num_reps (const int nreps) {
+    EKAT_REQUIRE_MSG (nreps>0, "Error! Number of tuning repetitions must be positive.\n");
+    m_nreps = nreps;
+  }
+
+  // Run kernel with the best of the pack sizes Ns (DefaultTunedPackSizes, if not
+  // specified) for this name/shape, tuning first if needed, and return the pack size used.
+  template<typename Kernel>
+  int run (const std::string& name, const std::vector<long long>& shape, const Kernel& kernel) {
+    return run(name,shape,kernel,DefaultTunedPackSizes{});
+  }
+
+  template<typename Kernel, int... Ns>
+  int run (const std::string& name, const std::vector<long long>& shape,
+           const Kernel& kernel, std::integer_sequence<int,Ns...>)
+  {
+    static_assert (sizeof...(Ns)>0, "Error! No pack size to choose from.\n");
+    const auto key = make_key(name,shape);
+
+    auto it = m_decisions.find(key);
+    if (it!=m_decisions.end() and not is_candidate<Ns...>(it->second.pack_size)) {
+      // E.g., a cache file from a run with a different set of candidates
+      m_decisions.erase(it);
+      it = m_decisions.end();
+    }
+
+    if (it==m_decisions.end()) {
+      Decision d {0, std::numeric_limits<double>::max(), false};
+      (time_candidate<Ns>(kernel,d), ...);
+      it = m_decisions.emplace(key,d).first;
+      store(key,d);
+    } else {
+      // Run the chosen variant
+      (run_if<Ns>(kernel,it->second.pack_size), ...);
+    }
+    return it->second.pack_size;
+  }
+
+  // Whether a decision exists for this name/shape, and the decision itself
+  bool has_decision (const std::string& name, const std::vector<long long>& shape) const {
+    return m_decisions.count(make_key(name,shape))==1;
+  }
+  const Decision& get_decision (const std::string& name, const std::vector<long long>& shape) const {
+    const auto key = make_key(name,shape);
+    EKAT_REQUIRE_MSG (m_decisions.count(key)==1,
+        "Error! No pack size decision for '" + key + "'.\n");
+    return m_decisions.at(key);
+  }
+
+  // All decisions, keyed by "name|exe_space|shape"
+  const std::map<std::string,Decision>& decisions () const { return m_decisions; }
+
+  // Forget all decisions (in memory only; the cache file is not touched)
+  void clear () { m_decisions.clear(); }
+
+  const std::string& cache_file () const { return m_cache_file; }
+
+  static std::string make_key (const std::string& name, const std::vector<long long>& shape) {
+    // Keys are stored as a single whitespace-free token in the cache file
+    std::string key = name + "|" + Kokkos::DefaultExecutionSpace::name() + "|";
+    for (size_t i=0; i<shape.size(); ++i) {
+      key += (i>0 ? "," : "") + std::to_string(shape[i]);
+    }
+    for (auto& c : key) {
+      if (std::isspace(static_cast<unsigned char>(c))) c = '_';
+    }
+    return key;
+  }
+
+protected:
+
+  template<int... Ns>
+  static bool is_candidate (const int n) {
+    return ((n==Ns) or ...);
+  }
+
+  template<int N, typename Kernel>
+  static void run_if (const Kernel& kernel, const int n) {
+    if (n==N) {
+      kernel(std::integral_constant<int,N>{});
+    }
+  }
+
+  template<int N, typename Kernel>
+  void time_candidate (const Kernel& kernel, Decision& d) const {
+    using clock = std::chrono::steady_clock;
+
+    // Warmup (first touch, instantiation of lazily allocated resources, ...)
+    kernel(std::integral_constant<int,N>{});
+    Kokkos::fence();
+
+    double best = std::numeric_limits<double>::max();
+    for (int r=0; r<m_nreps; ++r) {
+      const auto t0 = clock::now();
+      kernel(std::integral_constant<int,N>{});
+      Kokkos::fence();
+      const auto t1 = clock::now();
+      best = std::min(best,std::chrono::duration<double>(t1-t0).count());
+    }
+    if (best<d.time) {
+      d.pack_size = N;
+      d.time = best;
+    }
+  }
+
+  void load_cache () {
+    if (m_cache_file=="") return;
+
+    std::ifstream ifs(m_cache_file);
+    std::string line;
+    while (std::getline(ifs,line)) {
+      std::istringstream iss(line);
+      std::string key;
+      Decision d {0, 0, true};
+      if (iss >> key >> d.pack_size >> d.time and d.pack_size>0) {
+        m_decisions[key] = d;
+      }
+    }
+  }
+
+  void store (const std::string& key, const Decision& d) const {
+    if (m_cache_file=="") return;
+
+    // Append, so that concurrent processes do not clobber each other's entries
+    std::ofstream ofs(m_cache_file,std::ios::app);
+    EKAT_REQUIRE_MSG (ofs.good(),
+        "Error! Could not open pack size tuner cache file '" + m_cache_file + "'.\n");
+    ofs << key << " " << d.pack_size << " " << d.time << "\n";
+  }
+
+  std::string                     m_cache_file;
+  std::map<std::string,Decision>  m_decisions;
+  int                             m_nreps = 3;
+};
+
+// A process-wide tuner, whose cache file is the one in the EKAT_PACK_TUNER_CACHE
+// environment variable (if set) at the time of the first call
+inline PackSizeTuner& pack_size_tuner () {
+  static PackSizeTuner tuner ([]() -> std::string {
+    const char* f = std::getenv("EKAT_PACK_TUNER_CACHE");
+    return f==nullptr ? "" : f;
+  }());
+  return tuner;
+}
+
+} // namespace ekat
+
+#endif // EKAT_PACK_TUNER_HPP
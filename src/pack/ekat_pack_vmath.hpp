@@ -0,0 +1,623 @@
+#ifndef EKAT_PACK_VMATH_HPP
+#define EKAT_PACK_VMATH_HPP
+
+#include <Kokkos_MathematicalFunctions.hpp>
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <type_traits>
+
+namespace ekat {
+namespace vmath {
+
+/*
+ * Vector math kernels for the math functions of Pack (see ekat_pack_math.hpp).
+ *
+ * Calling Kokkos::exp (and friends) on each slot of a Pack results in one libm
+ * call per slot, which prevents the pack loop from vectorizing. The kernels in
+ * this file are branch-free polynomial approximations (SLEEF-style: argument
+ * reduction, polynomial, reconstruction via exponent bit manipulation, special
+ * values handled with selects), written as plain inline scalar code, so that
+ * a vector_simd loop over a pack compiles to a single vector kernel on CPU,
+ * while GPU threads simply run them as scalar code.
+ *
+ * Three accuracy levels are available:
+ *  - Exact: call Kokkos::fn (i.e., libm) on each slot. This is BFB with the
+ *    scalar code, but does not vectorize.
+ *  - Accurate: max error of about 1 ulp. Uses extended precision (double-double)
+ *    in the critical steps of the reconstruction.
+ *  - Fast: max error of a few ulps. Same polynomials (or slightly shorter ones),
+ *    without the extended precision steps.
+ * The default for Pack math functions is set at configure time via the CMake
+ * option EKAT_PACK_MATH_ACCURACY (Exact, unless specified otherwise), but any
+ * call can select an accuracy explicitly, e.g., ekat::exp<vmath::Accuracy::Fast>(p).
+ *
+ * NOTES:
+ *  - the kernels are written for double. float arguments are computed with the
+ *    double kernels and rounded to float, which is still vectorizable, and
+ *    gives (nearly) correctly rounded float results.
+ *  - only float and double have kernels; other types always use Kokkos::fn.
+ *  - tgamma always uses Kokkos::tgamma: there is no branch-free approximation
+ *    with an accuracy comparable to libm over its whole domain (the reflection
+ *    formula for negative arguments alone would need a vector sinpi kernel).
+ *  - pow has no Fast variant: exp(y*log(x)) in plain double loses about
+ *    |y*log(x)| ulps, so the Fast pow is the same as the Accurate one.
+ *  - the kernels pay off when vectorized (i.e., for packs with more than one
+ *    slot). Evaluated one slot at a time, the extended precision steps make
+ *    the Accurate kernels slower than libm for the more expensive fcns (e.g., pow).
+ *  - the kernels rely on IEEE semantics (e.g., x+c-c is NOT x), so they must
+ *    not be compiled with value-unsafe optimizations (e.g., -ffast-math).
+ */
+
+enum class Accuracy {
+  Exact,
+  Accurate,
+  Fast
+};
+
+#if defined(EKAT_PACK_MATH_ACCURACY_FAST)
+constexpr Accuracy default_accuracy = Accuracy::Fast;
+#elif defined(EKAT_PACK_MATH_ACCURACY_ACCURATE)
+constexpr Accuracy default_accuracy = Accuracy::Accurate;
+#else
+constexpr Accuracy default_accuracy = Accuracy::Exact;
+#endif
+
+namespace impl {
+
+// Whether there are vector kernels for T
+template<typename T>
+struct HasKernel : std::integral_constant<bool,std::is_same<T,double>::value or
+                                               std::is_same<T,float>::value> {};
+
+// ------------------------- Bit manipulation helpers ------------------------ //
+
+KOKKOS_FORCEINLINE_FUNCTION
+std::int64_t as_int (const double x) {
+  std::int64_t i;
+  memcpy(&i,&x,sizeof(double));
+  return i;
+}
+
+KOKKOS_FORCEINLINE_FUNCTION
+double as_double (const std::int64_t i) {
+  double x;
+  memcpy(&x,&i,sizeof(double));
+  return x;
+}
+
+// 2^q, for q in [-1022,1023]. Any other q (e.g., the huge n that round_k
+// gives for a NaN) gives garbage, but the shift is done on the unsigned bits,
+// so it is not UB.
+KOKKOS_FORCEINLINE_FUNCTION
+double pow2i (const std::int64_t q) {
+  return as_double(static_cast<std::int64_t>(static_cast<std::uint64_t>(q + 1023) << 52));
+}
+
+// x*2^q, for q in [-2044,2046]. Splitting the scaling in two steps allows
+// to produce subnormal and overflowing results with a single rounding.
+KOKKOS_FORCEINLINE_FUNCTION
+double ldexp2k (const double x, const std::int64_t q) {
+  const std::int64_t h = q >> 1;
+  return x*pow2i(h)*pow2i(q-h);
+}
+
+// |x| with the sign of s
+KOKKOS_FORCEINLINE_FUNCTION
+double copysign_k (const double x, const double s) {
+  constexpr std::int64_t sign = std::int64_t(1) << 63;
+  return as_double((as_int(x) & ~sign) | (as_int(s) & sign));
+}
+
+// Round x to the nearest integer, returned both as double and int64.
+// Valid for |x|<2^51 (for a NaN x, xi is garbage, but the subtraction cannot
+// overflow). This avoids float<->int conversions, which do not vectorize on
+// many targets.
+KOKKOS_FORCEINLINE_FUNCTION
+double round_k (const double x, std::int64_t& xi) {
+  constexpr double magic = 6755399441055744.0; // 1.5*2^52
+  const double t = x + magic;
+  xi = as_int(t) - as_int(magic);
+  return t - magic;
+}
+
+// For x>0, decompose x=m*2^e, with m in [sqrt(2)/2,sqrt(2)), and return e.
+// The exponent is extracted as a double, to avoid int->float conversions.
+KOKKOS_FORCEINLINE_FUNCTION
+double frexp_k (const double x, double& m) {
+  constexpr double min_normal = 2.2250738585072014e-308;
+  constexpr double two54 = 18014398509481984.0;
+  constexpr double two52 = 4503599627370496.0;
+  // NOTE: select the operands, rather than the results, of the conditional
+  //       ops, so the compiler cannot sink the ops in a branch (see pow_k)
+  const bool sub = x < min_normal;
+  const std::int64_t ix = as_int(x*(sub ? two54 : 1.0));
+  // Place the biased exponent in the mantissa of 2^52, to read it as a double
+  const double e = as_double(((ix >> 52) & 0x7ff) | as_int(two52)) - (two52 + 1023.0);
+  m = as_double((ix & 0x000fffffffffffffLL) | 0x3ff0000000000000LL);
+  const bool big = m > 1.4142135623730951;
+  m = m*(big ? 0.5 : 1.0);
+  return e + ((big ? 1.0 : 0.0) - (sub ? 54.0 : 0.0));
+}
+
+// Horner evaluation of c0 + x*(c1 + x*(c2 + ...))
+KOKKOS_FORCEINLINE_FUNCTION
+double horner (const double /* x */, const double c0) {
+  return c0;
+}
+template<typename... Cs>
+KOKKOS_FORCEINLINE_FUNCTION
+double horner (const double x, const double c0, const Cs... cs) {
+  return c0 + x*horner(x,cs...);
+}
+
+// ------------------------- Double-double arithmetic ------------------------ //
+
+// An unevaluated sum hi+lo, with |lo| <= ulp(hi)/2
+struct dd {
+  double hi, lo;
+};
+
+// Exact a+b
+KOKKOS_FORCEINLINE_FUNCTION
+dd two_sum (const double a, const double b) {
+  const double s = a + b;
+  const double bb = s - a;
+  return dd{s, (a - (s - bb)) + (b - bb)};
+}
+
+// Exact a+b, for |a|>=|b|
+KOKKOS_FORCEINLINE_FUNCTION
+dd fast_two_sum (const double a, const double b) {
+  const double s = a + b;
+  return dd{s, b - (s - a)};
+}
+
+// Exact a*b. If the target has no fma, use Dekker's product, since a
+// software fma would be much slower (and would not vectorize).
+KOKKOS_FORCEINLINE_FUNCTION
+dd two_prod (const double a, const double b) {
+  const double p = a*b;
+#if defined(__FP_FAST_FMA) || defined(__CUDA_ARCH__) || defined(__HIP_DEVICE_COMPILE__) || defined(__SYCL_DEVICE_ONLY__)
+  return dd{p, Kokkos::fma(a,b,-p)};
+#else
+  constexpr double split = 134217729.0; // 2^27+1
+  const double ca = split*a, cb = split*b;
+  const double ah = ca - (ca - a), bh = cb - (cb - b);
+  const double al = a - ah, bl = b - bh;
+  return dd{p, ((ah*bh - p) + ah*bl + al*bh) + al*bl};
+#endif
+}
+
+KOKKOS_FORCEINLINE_FUNCTION
+dd dd_add (const dd& a, const dd& b) {
+  const dd s = two_sum(a.hi,b.hi);
+  return fast_two_sum(s.hi, s.lo + a.lo + b.lo);
+}
+
+KOKKOS_FORCEINLINE_FUNCTION
+dd dd_mul (const dd& a, const dd& b) {
+  const dd p = two_prod(a.hi,b.hi);
+  return fast_two_sum(p.hi, p.lo + (a.hi*b.lo + a.lo*b.hi));
+}
+
+KOKKOS_FORCEINLINE_FUNCTION
+dd dd_mul (const dd& a, const double b) {
+  const dd p = two_prod(a.hi,b);
+  return fast_two_sum(p.hi, p.lo + a.lo*b);
+}
+
+// ------------------------------- Constants -------------------------------- //
+
+// ln2 = ln2_hi + ln2_lo, where ln2_hi has its 32 lowest bits zeroed, so that
+// n*ln2_hi is exact for any exponent n.
+constexpr double ln2_hi = 0.6931467056274414;
+constexpr double ln2_lo = 4.7493250390316726e-07;
+constexpr double ln2    = 0.6931471805599453;
+constexpr double log2e  = 1.4426950408889634;
+
+// Beyond these, exp overflows or underflows to 0
+constexpr double exp_max_arg = 709.782712893384;
+constexpr double exp_min_arg = -745.1332191019412;
+
+// ---------------------------------- Kernels ------------------------------- //
+
+// Approximation of (e^r-1-r)/r^2 on [-ln2/2,ln2/2]
+template<Accuracy A>
+KOKKOS_FORCEINLINE_FUNCTION
+double expm1_poly (const double r) {
+  if constexpr (A==Accuracy::Accurate) {
+    return horner(r, 0.5, 0.1666666666666667, 0.04166666666666667, 0.00833333333332614,
+                  0.0013888888888883752, 0.00019841269874804214, 2.4801587325536023e-05,
+                  2.7557255421023506e-06, 2.7557273657975953e-07, 2.5105208339987698e-08,
+                  2.0914680780540267e-09);
+  } else {
+    return horner(r, 0.5000000000000001, 0.16666666666666669, 0.04166666666662416,
+                  0.008333333333330063, 0.0013888888917199863, 0.00019841269863042963,
+                  2.4801521317484083e-05, 2.7557268476553695e-06, 2.7620078203806394e-07,
+                  2.5100377619606372e-08);
+  }
+}
+
+// Reduce x = n*ln2 + r, with |r|<=ln2/2, and return e^r-1.
+// x must be in [-746,710]. For a NaN x, the result is NaN and n is garbage,
+// which pow2i and ldexp2k accept. With Accurate, the result is returned as
+// hi+lo, which carries the rounding errors of the reduction.
+template<Accuracy A>
+KOKKOS_FORCEINLINE_FUNCTION
+dd exp_reduce (const double x, std::int64_t& n) {
+  const double nd = round_k(x*log2e,n);
+  if constexpr (A==Accuracy::Accurate) {
+    const dd r = two_sum(x - nd*ln2_hi, -nd*ln2_lo);
+    return fast_two_sum(r.hi, r.hi*r.hi*expm1_poly<A>(r.hi) + r.lo);
+  } else {
+    const double r = (x - nd*ln2_hi) - nd*ln2_lo;
+    return dd{r + r*r*expm1_poly<A>(r), 0.0};
+  }
+}
+
+template<Accuracy A>
+KOKKOS_FORCEINLINE_FUNCTION
+double exp_k (const double x) {
+  const double xc = x < -746.0 ? -746.0 : (x > 710.0 ? 710.0 : x);
+  std::int64_t n;
+  const dd em = exp_reduce<A>(xc,n);
+  const dd s = fast_two_sum(1.0,em.hi);
+  const double y = ldexp2k(s.hi + (s.lo + em.lo), n);
+  return x > exp_max_arg ? Kokkos::Experimental::infinity_v<double>
+                         : (x < exp_min_arg ? 0.0 : y);
+}
+
+// e^x-1, as hi+lo, for x in [-40,710] (a NaN x gives NaN, see exp_reduce)
+template<Accuracy A>
+KOKKOS_FORCEINLINE_FUNCTION
+dd expm1_dd (const double x) {
+  std::int64_t n;
+  const dd em = exp_reduce<A>(x,n);
+  // e^x-1 = 2^n*em + (2^n-1), where 2^n-1 is exact for n in [-53,53].
+  // For n>53, 2^n may overflow, but the -1 is below the ulp of the result,
+  // so we can just scale em+1 instead.
+  const double t = pow2i(n > 53 ? 0 : n);
+  const dd s = two_sum(t - 1.0, t*em.hi);
+  const dd y = fast_two_sum(s.hi, s.lo + t*em.lo);
+  return dd{n > 53 ? ldexp2k(1.0 + em.hi, n) - 1.0 : y.hi,
+            n > 53 ? 0.0 : y.lo};
+}
+
+template<Accuracy A>
+KOKKOS_FORCEINLINE_FUNCTION
+double expm1_k (const double x) {
+  // For x<-40, e^x-1 rounds to -1
+  const dd y = expm1_dd<A>(x < -40.0 ? -40.0 : (x > 710.0 ? 710.0 : x));
+  return x > exp_max_arg ? Kokkos::Experimental::infinity_v<double>
+                         : (x == 0 ? x : y.hi + y.lo);
+}
+
+// Approximation of (2*atanh(s)/s-2)/s^2, for z=s^2 in [0,0.0295]
+KOKKOS_FORCEINLINE_FUNCTION
+double log_poly (const double z) {
+  return horner(z, 0.666666666666667, 0.39999999999899444, 0.2857142862600327,
+                0.22222211130259878, 0.18182889455674947, 0.15331710618210773,
+                0.14616585424888623);
+}
+
+// Handle special values of log-like functions: x<0 or NaN -> NaN, 0 -> -inf, inf -> inf
+KOKKOS_FORCEINLINE_FUNCTION
+double log_special (const double x, const double y) {
+  constexpr double inf = Kokkos::Experimental::infinity_v<double>;
+  const double r = x == inf ? x : (x == 0 ? -inf : y);
+  return (x < 0 or x != x) ? Kokkos::Experimental::quiet_NaN_v<double> : r;
+}
+
+template<Accuracy A>
+KOKKOS_FORCEINLINE_FUNCTION
+double log_k (const double x) {
+  // x = 2^e*(1+f), log(1+f) = 2*atanh(s) = f - s*(f-R), with s=f/(2+f), R=s^2*P(s^2)
+  double m;
+  const double e = frexp_k(x,m);
+  const double f = m - 1.0;
+  const double s = f/(2.0 + f);
+  const double z = s*s;
+  const double R = z*log_poly(z);
+  double y;
+  if constexpr (A==Accuracy::Accurate) {
+    // Same as fdlibm: delay the rounding errors of the largest terms
+    const double hfsq = 0.5*f*f;
+    y = e*ln2_hi - ((hfsq - (s*(hfsq + R) + e*ln2_lo)) - f);
+  } else {
+    y = e*ln2 + (f - s*(f - R));
+  }
+  return log_special(x,y);
+}
+
+template<Accuracy A>
+KOKKOS_FORCEINLINE_FUNCTION
+double log10_k (const double x) {
+  constexpr double ivln10 = 0.4342944819032518;
+  if constexpr (A==Accuracy::Accurate) {
+    // Same as fdlibm: compute log(1+f) as hi+lo, where hi has only 21 bits,
+    // so that multiplying by the hi parts of the constants is exact.
+    constexpr double ivln10_hi  = 0.4342944622039795;
+    constexpr double ivln10_lo  = 1.9699272335463627e-08;
+    constexpr double log10_2_hi = 0.30102999566361177;
+    constexpr double log10_2_lo = 3.694239077158931e-13;
+    double m;
+    const double e = frexp_k(x,m);
+    const double f = m - 1.0;
+    const double s = f/(2.0 + f);
+    const double z = s*s;
+    const double R = z*log_poly(z);
+    const double hfsq = 0.5*f*f;
+    const double hi = as_double(as_int(f - hfsq) & ~std::int64_t(0xffffffff));
+    const double lo = (f - hi) - hfsq + s*(hfsq + R);
+    const double y2 = e*log10_2_hi;
+    double val_hi = hi*ivln10_hi;
+    double val_lo = e*log10_2_lo + (lo + hi)*ivln10_lo + lo*ivln10_hi;
+    const double w = y2 + val_hi;
+    val_lo += (y2 - w) + val_hi;
+    val_hi = w;
+    return log_special(x,val_lo + val_hi);
+  } else {
+    return log_k<A>(x)*ivln10;
+  }
+}
+
+// log(x) in double-double, for finite x>0
+KOKKOS_FORCEINLINE_FUNCTION
+dd log_dd (const double x) {
+  double m;
+  const double e = frexp_k(x,m);
+  const double f = m - 1.0;
+
+  // s = f/(2+f), in double-double. The residual is exact, so s_hi=f*(1/u)
+  // is good enough, and saves a division.
+  const dd u = two_sum(2.0,f);
+  const double u_inv = 1.0/u.hi;
+  const double s_hi = f*u_inv;
+  const dd p = two_prod(s_hi,u.hi);
+  const dd s {s_hi, ((f - p.hi) - p.lo - s_hi*u.lo)*u_inv};
+
+  // log(1+f) = 2*atanh(s) = 2s + 2s*z*(1/3 + z*W(z)), with z=s^2
+  const dd s2 {2*s.hi, 2*s.lo};
+  const dd z = dd_mul(s,s);
+  const double w = z.hi*horner(z.hi, 0.2, 0.14285714285714282, 0.11111111111114215,
+                               0.09090909089828463, 0.07692307880585086, 0.06666648267216471,
+                               0.058834065605171064, 0.05228163634742257, 0.053812122097824);
+  const dd third {0.3333333333333333, 1.850371707708594e-17};
+  const dd t = dd_mul(dd_mul(s2,z), dd_add(third,dd{w,0.0}));
+
+  // e*ln2_hi is exact
+  return dd_add(dd{e*ln2_hi, e*ln2_lo}, dd_add(s2,t));
+}
+
+// x^y
+KOKKOS_FORCEINLINE_FUNCTION
+double pow_k (const double x, const double y) {
+  constexpr double inf = Kokkos::Experimental::infinity_v<double>;
+  constexpr double nan = Kokkos::Experimental::quiet_NaN_v<double>;
+  constexpr double two52 = 4503599627370496.0;
+  constexpr double two53 = 9007199254740992.0;
+
+  const double ax = Kokkos::abs(x);
+  const double ay = Kokkos::abs(y);
+
+  // log|x| in double-double, with the limits for 0 and inf
+  dd l = log_dd(ax);
+  l.hi = ax == 0 ? -inf : (ax == inf ? inf : l.hi);
+  l.lo = (ax == 0 or ax == inf) ? 0.0 : l.lo;
+
+  // y*log|x| in double-double. Since the dd product of an inf is a NaN,
+  // over/underflow and NaN are detected on the plain product.
+  const double yl = l.hi*y;
+  const dd ylog = dd_mul(l,y);
+
+  // exp(ylog.hi+ylog.lo). The reduction r = ylog - n*ln2 is done with
+  // r_hi+r_lo, and the rounding error of r_hi+r_lo is added back at the end.
+  const double h = yl < -746.0 ? -746.0 : (yl > 710.0 ? 710.0 : ylog.hi);
+  std::int64_t n;
+  const double nd = round_k(h*log2e,n);
+  const dd r = two_sum(h - nd*ln2_hi, ylog.lo - nd*ln2_lo);
+  const dd em = fast_two_sum(r.hi, r.hi*r.hi*expm1_poly<Accuracy::Accurate>(r.hi));
+  const dd e = fast_two_sum(1.0,em.hi);
+  double z = ldexp2k(e.hi + (e.lo + em.lo + r.lo*(1.0 + em.hi)), n);
+  z = yl > exp_max_arg ? inf : (yl < exp_min_arg ? 0.0 : z);
+
+  // Sign and special cases. NOTE: the compiler may turn these selects into
+  // branches, and, with -ftrapping-math, it cannot if-convert them back if they
+  // contain ops that may raise FP exceptions. So we only use selects, bitwise
+  // ops on bools, and quiet comparisons (==, !=, or integer ones) below.
+  const bool y_int = (ay >= two52) | (((ay + two52) - two52) == ay);
+  const double hay = 0.5*ay;
+  const bool y_odd = y_int & (ay < two53) & (((hay + two52) - two52) != hay);
+  // With the bits of x as int64, x is -0 at the min int64, and -inf/-NaNs
+  // are at/above the bits of -inf.
+  const std::int64_t ix = as_int(x);
+  const bool x_neg = ix < 0;
+  const bool x_neg_finite = (ix > std::numeric_limits<std::int64_t>::min()) &
+                            (ix < as_int(-inf));
+  z = x_neg & y_odd ? -z : z;
+  z = x_neg_finite & !y_int ? nan : z;
+  z = x != x ? x : (y != y ? y : z);
+  return (y == 0) | (x == 1) | ((x == -1) & (ay == inf)) ? 1.0 : z;
+}
+
+// Approximation of cbrt(m) for m in [1,2], to about 1e-4
+KOKKOS_FORCEINLINE_FUNCTION
+double cbrt_k_approx (const double m) {
+  return horner(m, 0.5557909602691388, 0.5808263911380952, -0.1586624600531909,
+                0.022148699208245193);
+}
+
+template<Accuracy A>
+KOKKOS_FORCEINLINE_FUNCTION
+double cbrt_k (const double x) {
+  constexpr double inf = Kokkos::Experimental::infinity_v<double>;
+  const double ax = Kokkos::abs(x);
+
+  // ax = m*2^e, with m in [1,2), and e = 3q+k, with k in {0,1,2}
+  double m;
+  double e = frexp_k(ax,m);
+  const bool low = m < 1.0;
+  m = low ? 2.0*m : m;
+  e = low ? e - 1.0 : e;
+  const double e3 = e / 3.0;
+  std::int64_t qi;
+  double q = round_k(e3,qi);
+  qi = q > e3 ? qi - 1 : qi;
+  q = q > e3 ? q - 1.0 : q;
+  const double k = e - 3.0*q;
+
+  // cbrt(a), with a = m*2^k in [1,8), via a Halley step and a Newton step
+  const double a = k == 0 ? m : (k == 1 ? 2.0*m : 4.0*m);
+  double y = cbrt_k_approx(m)*(k == 0 ? 1.0 : (k == 1 ? 1.2599210498948732 : 1.5874010519681996));
+  const double y3 = y*y*y;
+  y = y*(y3 + 2.0*a)/(2.0*y3 + a);
+  if constexpr (A==Accuracy::Accurate) {
+    // Compute the residual y^3-a in double-double
+    const dd c = dd_mul(two_prod(y,y),y);
+    y = y - ((c.hi - a) + c.lo)/(3.0*y*y);
+  } else {
+    y = y - (y*y*y - a)/(3.0*y*y);
+  }
+
+  y = copysign_k(y*pow2i(qi),x);
+  return (x == 0 or ax == inf or x != x) ? x : y;
+}
+
+template<Accuracy A>
+KOKKOS_FORCEINLINE_FUNCTION
+double tanh_k (const double x) {
+  const double ax = Kokkos::abs(x);
+  if constexpr (A==Accuracy::Accurate) {
+    // Small args: x + x^3*P(x^2). Otherwise, 1 - 2/(e^(2|x|)+1)
+    const double u = x*x;
+    const double ys = copysign_k(ax + ax*(u*horner(u, -0.3333333333333333, 0.13333333333332714,
+                                      -0.053968253967434016, 0.021869488493666944,
+                                      -0.008863234397814355, 0.003592110378689024,
+                                      -0.001455661830100716, 0.0005889360520074057,
+                                      -0.0002346347410887237, 8.511313685577671e-05,
+                                      -2.0602765376366337e-05)),x);
+    // For |x|>20, tanh(x) rounds to 1. Do the division in double-double.
+    const dd t = expm1_dd<A>(ax >= 20.0 ? 40.0 : 2.0*ax);
+    const dd d = fast_two_sum(2.0, t.hi);
+    const double d_lo = d.lo + t.lo;
+    const double q = 2.0/d.hi;
+    const dd p = two_prod(q,d.hi);
+    const double q_lo = ((2.0 - p.hi) - p.lo - q*d_lo)/d.hi;
+    const dd z = two_sum(1.0,-q);
+    const double yl = copysign_k(z.hi + (z.lo - q_lo),x);
+    return ax < 0.55 ? ys : yl;
+  } else {
+    // tanh|x| = -t/(t+2), with t = e^(-2|x|)-1
+    const double t = expm1_k<A>(-2.0*ax);
+    return copysign_k(-t/(t + 2.0),x);
+  }
+}
+
+template<Accuracy A>
+KOKKOS_FORCEINLINE_FUNCTION
+double erf_k (const double x) {
+  const double ax = Kokkos::abs(x);
+  const double u = x*x;
+
+  // |x|<1: erf(x) = x + x*E(x^2)
+  double E;
+  if constexpr (A==Accuracy::Accurate) {
+    E = horner(u, 0.1283791670955126, -0.3761263890318375, 0.11283791670954879,
+               -0.026866170645076792, 0.0052239776248180145, -0.000854832698083379,
+               0.0001205533111164271, -1.4925595266831182e-05, 1.6461000484121368e-06,
+               -1.6350312701054695e-07, 1.4659775274047436e-08, -1.1372848856791674e-09,
+               5.957176147748911e-11);
+  } else {
+    E = horner(u, 0.12837916709551256, -0.37612638903183543, 0.11283791670945006,
+               -0.02686617064323777, 0.0052239776071164225, -0.0008548325975389692,
+               0.00012055294904839707, -1.492473690741966e-05, 1.6447424703317362e-06,
+               -1.6208483801871705e-07, 1.3720064546777686e-08, -7.795898827002142e-10);
+  }
+  const double ys = x + x*E;
+
+  // 1<=|x|<6: erf(x) = 1 - e^(-x^2)*G(x), with G(x)=erfc(x)*e^(x^2) approximated
+  // on [1,2], [2,3.5] and [3.5,6]. Select the coefficients of each slot's interval.
+  const bool i0 = ax < 2.0;
+  const bool i1 = ax < 3.5;
+  const auto c = [&](const double c0, const double c1, const double c2) {
+    return i0 ? c0 : (i1 ? c1 : c2);
+  };
+  const double v = ax - c(1.5, 2.75, 4.75);
+  const double G =
+    horner(v, c(0.3215854164543175,      0.1936620962790687,     0.11630270721024731),
+              c(-0.16362291773256005,   -0.06323763756063479,   -0.023503448598162904),
+              c(0.0761510398554774,      0.019758592987322854,   0.0046613263689723),
+              c(-0.03293090529956527,   -0.005934337897002171,  -0.0009080988970373065),
+              c(0.013377340953067394,    0.0017195818852900986,  0.00017392830404186873),
+              c(-0.0051459575478377826, -0.00048219508487679243,-3.2775781066528116e-05),
+              c(0.0018861348769919975,   0.0001311818005084561,  6.081114539531e-06),
+              c(-0.0006619300701084315, -3.469861074039318e-05, -1.1115679931156728e-06),
+              c(0.0002233099453004411,   8.94015629298454e-06,   2.002920135090727e-07),
+              c(-7.265887301589559e-05, -2.247366566986457e-06, -3.5595168000590696e-08),
+              c(2.2864299608127746e-05,  5.519743740073735e-07,  6.242341780249905e-09),
+              c(-6.97536222785843e-06,  -1.3264839014463818e-07,-1.081455682633195e-09),
+              c(2.0670657912156654e-06,  3.121415013712102e-08,  1.849140276993934e-10),
+              c(-5.944961119917664e-07, -7.156467021431838e-09, -3.0750980426473406e-11),
+              c(1.6714292901928126e-07,  1.6207327188991067e-09, 5.138680596045611e-12),
+              c(-4.9545807838901603e-08,-4.056754880659121e-10, -1.0277932486024302e-12),
+              c(1.3242541506849584e-08,  8.831959586426475e-11,  1.672245719005653e-13));
+  const double yl = copysign_k(1.0 - exp_k<A>(-(ax < 6.0 ? u : 36.0))*G,x);
+
+  const double y = ax < 1.0 ? ys : (ax < 6.0 ? yl : copysign_k(1.0,x));
+  return x != x ? x : y;
+}
+
+} // namespace impl
+
+// ----------------------- Scalar interface to the kernels ----------------------- //
+
+// Implementation detail for generating fn<A>(x). With A=Exact (or a type
+// without kernels), call Kokkos::fn, otherwise run the double kernel.
+#define ekat_vmath_gen_unary_fn(fn)                                     \
+  template<Accuracy A = default_accuracy, typename T>                   \
+  KOKKOS_FORCEINLINE_FUNCTION                                           \
+  T fn (const T x) {                                                    \
+    if constexpr (A==Accuracy::Exact or not impl::HasKernel<T>::value) { \
+      return Kokkos::fn(x);                                             \
+    } else {                                                            \
+      return static_cast<T>(impl::fn##_k<A>(static_cast<double>(x)));   \
+    }                                                                   \
+  }
+
+ekat_vmath_gen_unary_fn(exp)
+ekat_vmath_gen_unary_fn(expm1)
+ekat_vmath_gen_unary_fn(log)
+ekat_vmath_gen_unary_fn(log10)
+ekat_vmath_gen_unary_fn(cbrt)
+ekat_vmath_gen_unary_fn(tanh)
+ekat_vmath_gen_unary_fn(erf)
+
+#undef ekat_vmath_gen_unary_fn
+
+// No kernel for tgamma (see above)
+template<Accuracy A = default_accuracy, typename T>
+KOKKOS_FORCEINLINE_FUNCTION
+T tgamma (const T x) {
+  return Kokkos::tgamma(x);
+}
+
+// NOTE: Exact uses std::pow, rather than Kokkos::pow, for consistency with
+//       the Pack pow overloads, which have always used std::pow.
+template<Accuracy A = default_accuracy, typename T, typename S>
+KOKKOS_FORCEINLINE_FUNCTION
+auto pow (const T x, const S y) -> decltype(std::pow(x,y)) {
+  using R = decltype(std::pow(x,y));
+  if constexpr (A==Accuracy::Exact or not impl::HasKernel<R>::value) {
+    return std::pow(x,y);
+  } else {
+    return static_cast<R>(impl::pow_k(static_cast<double>(x),static_cast<double>(y)));
+  }
+}
+
+} // namespace vmath
+} // namespace ekat
+
+#endif // EKAT_PACK_VMATH_HPP
@@ -43,73 +43,53 @@ public:
     return m_value;
   }
 
-  template<typename S>
-  KOKKOS_FORCEINLINE_FUNCTION
-  typename std::enable_if<std::is_convertible<V,S>::value,value_t&>::type
-  operator+=(const S rhs)  {
-    ekat_masked_loop(m_mask,i)
-      m_value[i] += rhs;
-    return m_value;
-  }
-  template<typename S>
-  KOKKOS_FORCEINLINE_FUNCTION
-  typename std::enable_if<std::is_convertible<V,S>::value,value_t&>::type
-  operator+=(const Pack<S,N>& rhs)  {
-    ekat_masked_loop(m_mask,i)
-      m_value[i] += rhs[i];
-    return m_value;
-  }
-
-  template<typename S>
-  KOKKOS_FORCEINLINE_FUNCTION
-  typename std::enable_if<std::is_convertible<V,S>::value,value_t&>::type
-  operator-=(const S rhs)  {
-    ekat_masked_loop(m_mask,i)
-      m_value[i] -= rhs;
-    return m_value;
-  }
-  template<typename S>
-  KOKKOS_FORCEINLINE_FUNCTION
-  typename std::enable_if<std::is_convertible<V,S>::value,value_t&>::type
-  operator-=(const Pack<S,N>& rhs)  {
-    ekat_masked_loop(m_mask,i)
-      m_value[i] -= rhs[i];
-    return m_value;
+  // With the explicit-SIMD backend, the inactive slots of the rhs are set to
+  // the identity of the op, so that the op can be applied to the whole pack
+  // register at once: inactive slots are left untouched (signed zeros and NaNs
+  // included), and cannot raise FP exceptions the masked loop would not raise.
+#define ekat_where_gen_update_op(op, identity)                          \
+  template<typename S>                                                  \
+  KOKKOS_FORCEINLINE_FUNCTION                                           \
+  typename std::enable_if<std::is_convertible<V,S>::value,value_t&>::type \
+  operator op (const S rhs)  {                                          \
+    if constexpr (impl::PackSimd<V,N>::enabled and                      \
+                  impl::SimdSameType<V,S>::value) {                     \
+      using simd = impl::PackSimd<V,N>;                                 \
+      using simd_t = typename simd::simd_t;                             \
+      auto y = simd::load(m_value.data());                              \
+      y op simd::blend(simd::load_mask(m_mask),simd_t(rhs),simd_t(V(identity))); \
+      simd::store(y,m_value.data());                                    \
+    } else {                                                            \
+      ekat_masked_loop(m_mask,i)                                        \
+        m_value[i] op rhs;                                              \
+    }                                                                   \
+    return m_value;                                                     \
+  }                                                                     \
+  template<typename S>                                                  \
+  KOKKOS_FORCEINLINE_FUNCTION                                           \
+  typename std::enable_if<std::is_convertible<V,S>::value,value_t&>::type \
+  operator op (const Pack<S,N>& rhs)  {                                 \
+    if constexpr (impl::PackSimd<V,N>::enabled and                      \
+                  impl::SimdSameType<V,S>::value) {                     \
+      using simd = impl::PackSimd<V,N>;                                 \
+      using simd_t = typename simd::simd_t;                             \
+      auto y = simd::load(m_value.data());                              \
+      y op simd::blend(simd::load_mask(m_mask),simd::load(rhs.data()),simd_t(V(identity))); \
+      simd::store(y,m_value.data());                                    \
+    } else {                                                            \
+      ekat_masked_loop(m_mask,i)                                        \
+        m_value[i] op rhs[i];                                           \
+    }                                                                   \
+    return m_value;                                                     \
   }
 
-  template<typename S>
-  KOKKOS_FORCEINLINE_FUNCTION
-  typename std::enable_if<std::is_convertible<V,S>::value,value_t&>::type
-  operator*=(const S rhs)  {
-    ekat_masked_loop(m_mask,i)
-      m_value[i] *= rhs;
-    return m_value;
-  }
-  template<typename S>
-  KOKKOS_FORCEINLINE_FUNCTION
-  typename std::enable_if<std::is_convertible<V,S>::value,value_t&>::type
-  operator*=(const Pack<S,N>& rhs)  {
-    ekat_masked_loop(m_mask,i)
-      m_value[i] *= rhs[i];
-    return m_value;
-  }
+  // Note: x + (-0) == x for all x (including x=-0), while x + 0 != x for x=-0
+  ekat_where_gen_update_op(+=, -0.0)
+  ekat_where_gen_update_op(-=, 0)
+  ekat_where_gen_update_op(*=, 1)
+  ekat_where_gen_update_op(/=, 1)
 
-  template<typename S>
-  KOKKOS_FORCEINLINE_FUNCTION
-  typename std::enable_if<std::is_convertible<V,S>::value,value_t&>::type
-  operator/=(const S rhs)  {
-    ekat_masked_loop(m_mask,i)
-      m_value[i] /= rhs;
-    return m_value;
-  }
-  template<typename S>
-  KOKKOS_FORCEINLINE_FUNCTION
-  typename std::enable_if<std::is_convertible<V,S>::value,value_t&>::type
-  operator/=(const Pack<S,N>& rhs)  {
-    ekat_masked_loop(m_mask,i)
-      m_value[i] /= rhs[i];
-    return m_value;
-  }
+#undef ekat_where_gen_update_op
 
   KOKKOS_FORCEINLINE_FUNCTION
   scalar_t max (const scalar_t& v) const {
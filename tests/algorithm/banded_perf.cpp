@@ -0,0 +1,250 @@
+#include "ekat_banded.hpp"
+#include "ekat_tridiag.hpp"
+#include "ekat_pack_kokkos.hpp"
+#include "ekat_kokkos_session.hpp"
+#include "ekat_kokkos_types.hpp"
+#include "ekat_team_policy_utils.hpp"
+#include "ekat_test_utils.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+
+/*
+ * Benchmark of the banded solver on pentadiagonal systems, against repeated
+ * tridiagonal splitting.
+ *
+ * Each team solves the systems of its columns, interleaved in the lanes of packs
+ * (problem format 3 of ekat_banded.hpp), with
+ *
+ *   banded: ekat::banded::pentadiag, a direct solve;
+ *   split:  the splitting A = T + R, where T is the tridiagonal part of A and R
+ *           the outer two diagonals: T is factored once with
+ *           tridiag::thomas_factor, then x <- T \ (b - R x), starting from x = 0,
+ *           is iterated I times with tridiag::thomas_solve_factored.
+ *
+ * The time per column (averaged over the repetitions) and the relative residual
+ * max|A x - b|/max|b| of each method are reported. The splitting only converges
+ * for diagonally dominant enough matrices, and its error decreases with I, while
+ * its cost grows with I.
+ *
+ * Usage: banded_perf [-c|--ncol C] [-n|--nrow N] [-i|--niter I] [-t|--team-size T]
+ *                    [-r|--nrep R] [-p|--pack 1|2|4|8|16]
+ */
+
+namespace ekat {
+namespace test {
+namespace perf {
+
+struct Input {
+  int ncol = 4096;
+  int nrow = 128;
+  int niter = 4;
+  int team_size = 1;
+  int nrep = 10;
+  int pack = 8;
+
+  bool parse (int argc, char** argv) {
+    for (int i = 1; i < argc; ++i) {
+      if (argv_matches(argv[i], "-c", "--ncol")) {
+        if (i == argc-1) return false;
+        ncol = std::atoi(argv[++i]);
+      } else if (argv_matches(argv[i], "-n", "--nrow")) {
+        if (i == argc-1) return false;
+        nrow = std::atoi(argv[++i]);
+      } else if (argv_matches(argv[i], "-i", "--niter")) {
+        if (i == argc-1) return false;
+        niter = std::atoi(argv[++i]);
+      } else if (argv_matches(argv[i], "-t", "--team-size")) {
+        if (i == argc-1) return false;
+        team_size = std::atoi(argv[++i]);
+      } else if (argv_matches(argv[i], "-r", "--nrep")) {
+        if (i == argc-1) return false;
+        nrep = std::atoi(argv[++i]);
+      } else if (argv_matches(argv[i], "-p", "--pack")) {
+        if (i == argc-1) return false;
+        pack = std::atoi(argv[++i]);
+      } else {
+        std::cout << "Unexpected arg: " << argv[i] << "\n";
+        return false;
+      }
+    }
+    const bool valid_pack = pack==1 or pack==2 or pack==4 or pack==8 or pack==16;
+    return ncol>0 and nrow>0 and niter>0 and team_size>0 and nrep>0 and valid_pack;
+  }
+};
+
+template <int N>
+void run (const Input& in) {
+  using clock = std::chrono::steady_clock;
+  using ExeSpace = typename DefaultDevice::execution_space;
+  using TeamPolicy = Kokkos::TeamPolicy<ExeSpace>;
+  using MT = typename TeamPolicy::member_type;
+  using ColPack = Pack<double, N>;
+  using BandArrays = Kokkos::View<ColPack****, Kokkos::LayoutRight>;
+  using DataArrays = Kokkos::View<ColPack***, Kokkos::LayoutRight>;
+  using Band = Kokkos::View<ColPack***, Kokkos::LayoutRight, Kokkos::MemoryUnmanaged>;
+  using Data = Kokkos::View<ColPack**, Kokkos::LayoutRight, Kokkos::MemoryUnmanaged>;
+
+  const bool on_gpu = OnGpu<ExeSpace>::value;
+  const int team_size = on_gpu ? std::max(in.team_size, 32) : in.team_size;
+  // Each thread of a team gets a pack of columns.
+  const int npack_team = team_size;
+  const int nteam = (npack<ColPack>(in.ncol) + npack_team - 1)/npack_team;
+  const int nrow = in.nrow, niter = in.niter;
+
+  // A(team, 0:4, row, pack) holds the diagonals of the matrices of the team's columns.
+  const BandArrays A("A", nteam, 5, nrow, npack_team), Acopy("Acopy", nteam, 5, nrow, npack_team);
+  const DataArrays B("B", nteam, nrow, npack_team), X("X", nteam, nrow, npack_team),
+    Y("Y", nteam, nrow, npack_team);
+
+  // Fill all the lanes, so that every system is nonsingular.
+  {
+    const auto Am = Kokkos::create_mirror_view(Acopy);
+    const auto Bm = Kokkos::create_mirror_view(B);
+    const auto As = scalarize(Am);
+    const auto Bs = scalarize(Bm);
+    for (int t = 0; t < As.extent_int(0); ++t)
+      for (int i = 0; i < nrow; ++i)
+        for (int c = 0; c < As.extent_int(3); ++c) {
+          double sum = 0;
+          for (int k = 0; k < 5; ++k) {
+            if (k == 2) continue;
+            const int m = 7*t + 3*i + 5*k + c;
+            As(t,k,i,c) = (m % 5 == 0 ? -1 : 1) * (0.1 + ((m*m) % 11));
+            sum += std::abs(As(t,k,i,c));
+          }
+          As(t,2,i,c) = (i % 3 == 0 ? -1 : 1) * (1 + sum + (t + c) % 17);
+          Bs(t,i,c) = ((7*i + 11*c) % 3 == 0 ? -1 : 1) * (1 + (17*i + 13*c + t) % 47);
+        }
+    Kokkos::deep_copy(Acopy, Am);
+    Kokkos::deep_copy(B, Bm);
+  }
+
+  const auto band = KOKKOS_LAMBDA (const int t) {
+    return Band(&A(t,0,0,0), 5, nrow, npack_team);
+  };
+  const auto diag = KOKKOS_LAMBDA (const int t, const int k) {
+    return Data(&A(t,k,0,0), nrow, npack_team);
+  };
+  const auto data = KOKKOS_LAMBDA (const DataArrays& v, const int t) {
+    return Data(&v(t,0,0), nrow, npack_team);
+  };
+
+  const auto f_banded = KOKKOS_LAMBDA (const MT& team) {
+    const int t = team.league_rank();
+    banded::pentadiag(team, band(t), data(X,t));
+  };
+
+  const auto f_split = KOKKOS_LAMBDA (const MT& team) {
+    const int t = team.league_rank();
+    const auto x = data(X,t);
+    const auto y = data(Y,t);
+    const auto l2 = diag(t,0), u2 = diag(t,4);
+    tridiag::thomas_factor(team, diag(t,1), diag(t,2), diag(t,3));
+    Kokkos::parallel_for(Kokkos::TeamVectorRange(team, npack_team), [&] (const int c) {
+      for (int i = 0; i < nrow; ++i)
+        x(i,c) = 0;
+    });
+    for (int it = 0; it < niter; ++it) {
+      team.team_barrier();
+      Kokkos::parallel_for(Kokkos::TeamVectorRange(team, npack_team), [&] (const int c) {
+        for (int i = 0; i < nrow; ++i) {
+          ColPack v = B(t,i,c);
+          if (i >= 2)     v -= l2(i,c)*x(i-2,c);
+          if (i+2 < nrow) v -= u2(i,c)*x(i+2,c);
+          y(i,c) = v;
+        }
+      });
+      team.team_barrier();
+      tridiag::thomas_solve_factored(team, diag(t,1), diag(t,2), diag(t,3), y);
+      team.team_barrier();
+      Kokkos::parallel_for(Kokkos::TeamVectorRange(team, npack_team), [&] (const int c) {
+        for (int i = 0; i < nrow; ++i)
+          x(i,c) = y(i,c);
+      });
+    }
+  };
+
+  const auto policy = TeamPolicyFactory<ExeSpace>::get_team_policy_force_team_size(nteam, team_size);
+
+  // Time kernel f, restoring A and X before each run, and return the time per
+  // column and the relative residual.
+  const auto time_op = [&] (const auto& f, double& ns_per_col, double& resid) {
+    double elapsed = 0;
+    for (int r = 0; r <= in.nrep; ++r) {
+      Kokkos::deep_copy(A, Acopy);
+      Kokkos::deep_copy(X, B);
+      Kokkos::fence();
+      const auto t0 = clock::now();
+      Kokkos::parallel_for(policy, f);
+      Kokkos::fence();
+      const auto t1 = clock::now();
+      // The first run is a warmup.
+      if (r > 0) elapsed += std::chrono::duration<double,std::nano>(t1-t0).count();
+    }
+    ns_per_col = elapsed/(double(in.nrep)*in.ncol);
+
+    const auto Am = Kokkos::create_mirror_view(Acopy);
+    const auto Bm = Kokkos::create_mirror_view(B);
+    const auto Xm = Kokkos::create_mirror_view(X);
+    Kokkos::deep_copy(Am, Acopy);
+    Kokkos::deep_copy(Bm, B);
+    Kokkos::deep_copy(Xm, X);
+    const auto As = scalarize(Am);
+    const auto Bs = scalarize(Bm);
+    const auto Xs = scalarize(Xm);
+    double num = 0, den = 0;
+    for (int col = 0; col < in.ncol; ++col) {
+      const int t = col/(npack_team*N), c = col % (npack_team*N);
+      for (int i = 0; i < nrow; ++i) {
+        double y = 0;
+        for (int k = 0; k < 5; ++k)
+          if (i+k-2 >= 0 && i+k-2 < nrow)
+            y += As(t,k,i,c)*Xs(t,i+k-2,c);
+        num = std::max(num, std::abs(y - Bs(t,i,c)));
+        den = std::max(den, std::abs(Bs(t,i,c)));
+      }
+    }
+    resid = num/den;
+  };
+
+  double ns_banded, ns_split, re_banded, re_split;
+  time_op(f_banded, ns_banded, re_banded);
+  time_op(f_split, ns_split, re_split);
+
+  printf("banded_perf: exe space %s, ncol %d, nrow %d, pack %d, team size %d, niter %d, nrep %d\n",
+         ExeSpace::name(), in.ncol, nrow, N, policy.team_size(), niter, in.nrep);
+  printf("  %-8s %12s %12s   (ns/column, max|Ax-b|/max|b|)\n", "method", "time", "residual");
+  printf("  %-8s %12.4f %12.4e\n", "banded", ns_banded, re_banded);
+  printf("  %-8s %12.4f %12.4e\n", "split", ns_split, re_split);
+  printf("  split/banded time %1.3f\n", ns_split/ns_banded);
+}
+
+} // namespace perf
+} // namespace test
+} // namespace ekat
+
+int main (int argc, char** argv) {
+  ekat::test::perf::Input in;
+  if (not in.parse(argc,argv)) {
+    std::cout << "Usage: " << argv[0] << " [-c|--ncol C] [-n|--nrow N] [-i|--niter I]"
+              << " [-t|--team-size T] [-r|--nrep R] [-p|--pack 1|2|4|8|16]\n";
+    return 1;
+  }
+
+  ekat::initialize_kokkos_session(false); {
+    switch (in.pack) {
+      case 1:  ekat::test::perf::run<1>(in);  break;
+      case 2:  ekat::test::perf::run<2>(in);  break;
+      case 4:  ekat::test::perf::run<4>(in);  break;
+      case 8:  ekat::test::perf::run<8>(in);  break;
+      case 16: ekat::test::perf::run<16>(in); break;
+    }
+  } ekat::finalize_kokkos_session();
+
+  return 0;
+}
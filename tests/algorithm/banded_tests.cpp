@@ -0,0 +1,193 @@
+#include <catch2/catch.hpp>
+
+#include "ekat_banded.hpp"
+#include "ekat_pack_kokkos.hpp"
+
+#include "ekat_test_config.h"
+
+#include <cmath>
+#include <limits>
+#include <vector>
+
+namespace {
+
+using Layout = Kokkos::LayoutRight;
+
+// Fill the band of each matrix of A(KL+KU+1, nrow, nprob), diagonally dominant.
+// The entries outside the matrices are NaN, so that using them fails the test.
+template <typename BandArray>
+void fill_band (const BandArray& A, const int KL, const int KU) {
+  const int nrow = A.extent_int(1);
+  for (int p = 0; p < A.extent_int(2); ++p)
+    for (int i = 0; i < nrow; ++i) {
+      Real sum = 0;
+      for (int k = -KL; k <= KU; ++k) {
+        if (k == 0) continue;
+        const int m = p + 3*i + 7*(k + KL);
+        Real v = (m % 5 == 0 ? -1 : 1) * 1.3 * (0.1 + ((m*m) % 11));
+        if (i + k < 0 || i + k >= nrow)
+          v = std::numeric_limits<Real>::quiet_NaN();
+        else
+          sum += std::abs(v);
+        A(KL+k,i,p) = v;
+      }
+      A(KL,i,p) = (i % 3 == 0 ? -1 : 1) * (0.7 + sum + (p + i) % 17);
+    }
+}
+
+// Dense reference: expand matrix p of A and solve with Gaussian elimination
+// with partial pivoting.
+template <typename BandArray>
+std::vector<Real> dense_solve (const BandArray& A, const int p, const int KL, const int KU,
+                               std::vector<Real> b) {
+  const int n = A.extent_int(1);
+  std::vector<Real> M(n*n, 0);
+  for (int i = 0; i < n; ++i)
+    for (int k = -KL; k <= KU; ++k)
+      if (i + k >= 0 && i + k < n)
+        M[i*n + i + k] = A(KL+k,i,p);
+  for (int c = 0; c < n; ++c) {
+    int piv = c;
+    for (int r = c+1; r < n; ++r)
+      if (std::abs(M[r*n + c]) > std::abs(M[piv*n + c])) piv = r;
+    if (piv != c) {
+      for (int k = 0; k < n; ++k) std::swap(M[c*n + k], M[piv*n + k]);
+      std::swap(b[c], b[piv]);
+    }
+    for (int r = c+1; r < n; ++r) {
+      const Real f = M[r*n + c]/M[c*n + c];
+      for (int k = c; k < n; ++k) M[r*n + k] -= f*M[c*n + k];
+      b[r] -= f*b[c];
+    }
+  }
+  for (int r = n-1; r >= 0; --r) {
+    for (int k = r+1; k < n; ++k) b[r] -= M[r*n + k]*b[k];
+    b[r] /= M[r*n + r];
+  }
+  return b;
+}
+
+template <int KL, int KU, typename MT, typename BandArray, typename DataArray>
+KOKKOS_INLINE_FUNCTION
+void solve (const MT& team, const BandArray& A, const DataArray& X, const bool factored) {
+  if (factored) {
+    ekat::banded::factor<KL,KU>(team, A);
+    ekat::banded::solve_factored<KL,KU>(team, A, X);
+  } else if constexpr (KL == 2 && KU == 2) {
+    ekat::banded::pentadiag(team, A, X);
+  } else {
+    ekat::banded::solve<KL,KU>(team, A, X);
+  }
+}
+
+// Solve with solve<KL,KU>, or factor then solve_factored, in problem format 1
+// (nprob = nrhs = 1), 2 (nprob = 1) or 3 (nprob = nrhs), and return the relative
+// difference from the dense reference.
+template <int KL, int KU, typename APack, typename DataPack>
+Real run (const int nrow, const int nprob, const int nrhs, const bool factored) {
+  using TeamPolicy = Kokkos::TeamPolicy<Kokkos::DefaultExecutionSpace>;
+  using MT = typename TeamPolicy::member_type;
+  using Scalar = typename APack::scalar;
+  constexpr int nd = KL+KU+1;
+
+  const Kokkos::View<APack***, Layout> A("A", nd, nrow, ekat::npack<APack>(nprob));
+  const Kokkos::View<DataPack**, Layout> X("X", nrow, ekat::npack<DataPack>(nrhs));
+  const auto Am = Kokkos::create_mirror_view(A);
+  const auto Xm = Kokkos::create_mirror_view(X);
+  const auto As = ekat::scalarize(Am);
+  const auto Xs = ekat::scalarize(Xm);
+  fill_band(As, KL, KU);
+  for (int i = 0; i < nrow; ++i)
+    for (int j = 0; j < Xs.extent_int(1); ++j)
+      Xs(i,j) = ((7*i + 11*j) % 3 == 0 ? -1 : 1) * 1.7 * (1 + (17*i + 13*j) % 47);
+
+  std::vector<std::vector<Real>> ref(nrhs);
+  for (int j = 0; j < nrhs; ++j) {
+    std::vector<Real> b(nrow);
+    for (int i = 0; i < nrow; ++i) b[i] = Xs(i,j);
+    ref[j] = dense_solve(As, nprob > 1 ? j : 0, KL, KU, b);
+  }
+
+  Kokkos::deep_copy(A, Am);
+  Kokkos::deep_copy(X, Xm);
+  const auto Asd = ekat::scalarize(A);
+  const auto Xsd = ekat::scalarize(X);
+  const int concurrency = Kokkos::DefaultExecutionSpace().concurrency();
+  const int nthr = ekat::OnGpu<Kokkos::DefaultExecutionSpace>::value ? 128 : concurrency;
+  TeamPolicy policy(1, nthr, 1);
+  const auto f = KOKKOS_LAMBDA (const MT& team) {
+    if (nprob == 1) {
+      // One matrix, so scalar diagonals.
+      const Kokkos::View<Scalar**, Layout> a(Asd.data(), nd, nrow);
+      if (nrhs == 1)
+        solve<KL,KU>(team, a, Kokkos::View<typename DataPack::scalar*, Layout>(Xsd.data(), nrow),
+                     factored);
+      else
+        solve<KL,KU>(team, a, X, factored);
+    } else if constexpr (static_cast<int>(APack::n) == static_cast<int>(DataPack::n)) {
+      solve<KL,KU>(team, A, X, factored);
+    }
+  };
+  Kokkos::parallel_for(policy, f);
+  Kokkos::fence();
+
+  Kokkos::deep_copy(Xm, X);
+  Real num = 0, den = 0;
+  for (int j = 0; j < nrhs; ++j)
+    for (int i = 0; i < nrow; ++i) {
+      if (std::isnan(Xs(i,j)) || std::isinf(Xs(i,j)))
+        return std::numeric_limits<Real>::infinity();
+      num = std::max(num, std::abs(Xs(i,j) - ref[j][i]));
+      den = std::max(den, std::abs(ref[j][i]));
+    }
+  return num/den;
+}
+
+template <int KL, int KU, int A_pack_size, int data_pack_size>
+void run_tests () {
+  using APack = ekat::Pack<Real, A_pack_size>;
+  using DataPack = ekat::Pack<Real, data_pack_size>;
+
+  for (const int nrow : {1,2,3,4,5,8,17,64,129}) {
+    for (const int nrhs : {1,4,13}) {
+      for (const bool A_many : {false, true}) {
+        if (nrhs == 1 && A_many) continue;
+        const int nprob = A_many ? nrhs : 1;
+        // As in the tridiag tests, packs are used only for many matrices or L,RHS.
+        if ((nrhs  == 1 && data_pack_size > 1) ||
+            (nprob == 1 && A_pack_size    > 1))
+          continue;
+        if (A_pack_size != data_pack_size && nprob > 1)
+          continue;
+        for (const bool factored : {false, true}) {
+          const auto re = run<KL,KU,APack,DataPack>(nrow, nprob, nrhs, factored);
+          const bool pass = re <= 1e3*std::numeric_limits<Real>::epsilon();
+          if ( ! pass)
+            std::cout << "FAIL: banded<" << KL << "," << KU << "> | " << nrow << " "
+                      << nrhs << " " << A_many << " " << factored
+                      << " | log10 rel_diff " << std::log10(re) << "\n";
+          REQUIRE(pass);
+        }
+      }
+    }
+  }
+}
+
+template <int A_pack_size, int data_pack_size>
+void run_all_bands () {
+  run_tests<1,1,A_pack_size,data_pack_size>();
+  run_tests<2,2,A_pack_size,data_pack_size>();
+  run_tests<1,3,A_pack_size,data_pack_size>();
+  run_tests<3,0,A_pack_size,data_pack_size>();
+  run_tests<0,2,A_pack_size,data_pack_size>();
+}
+
+TEST_CASE("dense_reference", "banded") {
+  run_all_bands<1,1>();
+  if (EKAT_TEST_PACK_SIZE > 1) {
+    run_all_bands<1, EKAT_TEST_PACK_SIZE>();
+    run_all_bands<EKAT_TEST_PACK_SIZE, EKAT_TEST_PACK_SIZE>();
+  }
+}
+
+} // anonymous namespace
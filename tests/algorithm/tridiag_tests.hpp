@@ -42,7 +42,7 @@ void fill_data_matrix (DataArray X, const int& seed) {
 template <typename TridiagDiag, typename XArray, typename YArray>
 KOKKOS_INLINE_FUNCTION
 int matvec (TridiagDiag dl, TridiagDiag d, TridiagDiag du, XArray X, YArray Y,
-            const int nprob, const int nrhs) {
+            const int nprob, const int nrhs, const bool cyclic = false) {
   const int nrow = d.extent_int(0);
 
   assert(dl.extent_int(0) == nrow);
@@ -82,6 +82,13 @@ int matvec (TridiagDiag dl, TridiagDiag d, TridiagDiag du, XArray X, YArray Y,
     const int aj = dcol(j);
     Y(i,j) = dl(i,aj) * X(i-1,j) + d(i,aj) * X(i,j);
   }
+  // The corner entries (0,nrow-1) and (nrow-1,0) of a cyclic matrix.
+  if (cyclic)
+    for (int j = 0; j < nrhs; ++j) {
+      const int aj = dcol(j);
+      Y(0,j) += dl(0,aj) * X(i,j);
+      Y(i,j) += du(i,aj) * X(0,j);
+    }
 
   return 0;  
 }
@@ -107,7 +114,7 @@ Real rel_diff (const Array& a, const Array& b, const int nrhs) {
 
 namespace perf {
 struct Solver {
-  enum Enum { thomas, cr, error };
+  enum Enum { thomas, cr, thomas_batched, partitioned_thomas, error };
 
   static std::string convert(Enum e);
   static Enum convert(const std::string& s);
@@ -115,7 +122,7 @@ struct Solver {
 
 struct Input {
   Solver::Enum method;
-  int nprob, nrow, nrhs, nwarp;
+  int nprob, nrow, nrhs, nwarp, nthread, nsolve;
   bool pack, oneA;
 
   Input();
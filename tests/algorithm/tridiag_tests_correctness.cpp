@@ -13,6 +13,8 @@ struct Solver {
   enum Enum { thomas_team_scalar, thomas_team_pack,
               thomas_scalar, thomas_pack,
               cr_scalar, bfb,
+              thomas_factored, cr_factored,
+              partitioned_thomas, cyclic_thomas,
               error };
 
   static std::string convert (Enum e) {
@@ -23,6 +25,10 @@ struct Solver {
       case thomas_pack: return "thomas_pack";
       case cr_scalar: return "cr_scalar";
       case bfb: return "bfb";
+      case thomas_factored: return "thomas_factored";
+      case cr_factored: return "cr_factored";
+      case partitioned_thomas: return "partitioned_thomas";
+      case cyclic_thomas: return "cyclic_thomas";
       default: EKAT_REQUIRE_MSG(false, "Not a valid solver: " << e);
     }
     return "";
@@ -35,6 +41,10 @@ struct Solver {
     if (s == "thomas_pack") return thomas_pack;
     if (s == "cr_scalar") return cr_scalar;
     if (s == "bfb") return bfb;
+    if (s == "thomas_factored") return thomas_factored;
+    if (s == "cr_factored") return cr_factored;
+    if (s == "partitioned_thomas") return partitioned_thomas;
+    if (s == "cyclic_thomas") return cyclic_thomas;
     return error;
   }
 
@@ -44,6 +54,8 @@ struct Solver {
 Solver::Enum Solver::all[] = { thomas_team_scalar, thomas_team_pack,
                                thomas_scalar, thomas_pack,
                                cr_scalar, bfb,
+                               thomas_factored, cr_factored,
+                               partitioned_thomas, cyclic_thomas,
                              };
 
 struct TestConfig {
@@ -112,16 +124,29 @@ struct Solve<true, APack, DataPack> {
     case Solver::thomas_team_pack: {
       const auto As = scalarize(A);
       const auto Xs = scalarize(X);
-      const auto f = KOKKOS_LAMBDA (const MT& team) {
-        const auto dl = get_diag(As, 0);
-        const auto d  = get_diag(As, 1);
-        const auto du = get_diag(As, 2);
-        if (tc.solver == Solver::thomas_team_scalar)
-          ekat::tridiag::thomas(team, dl, d, du, Xs);
-        else
-          ekat::tridiag::thomas(team, dl, d, du, X);
-      };
-      Kokkos::parallel_for(policy, f);
+      if (nprob == 1) {
+        const auto f = KOKKOS_LAMBDA (const MT& team) {
+          const auto dl = get_diag(As, 0);
+          const auto d  = get_diag(As, 1);
+          const auto du = get_diag(As, 2);
+          if (tc.solver == Solver::thomas_team_scalar)
+            ekat::tridiag::thomas(team, dl, d, du, Xs);
+          else
+            ekat::tridiag::thomas(team, dl, d, du, X);
+        };
+        Kokkos::parallel_for(policy, f);
+      } else {
+        // Batched: one system per column, the columns in the pack lanes.
+        const auto f = KOKKOS_LAMBDA (const MT& team) {
+          if (tc.solver == Solver::thomas_team_scalar)
+            ekat::tridiag::thomas(team, get_diags(As, 0), get_diags(As, 1),
+                                  get_diags(As, 2), Xs);
+          else
+            ekat::tridiag::thomas(team, get_diags(A, 0), get_diags(A, 1),
+                                  get_diags(A, 2), X);
+        };
+        Kokkos::parallel_for(policy, f);
+      }
     } break;
     case Solver::thomas_scalar: {
       if (nprob == 1) {
@@ -239,6 +264,88 @@ struct Solve<true, APack, DataPack> {
       };
       Kokkos::parallel_for(policy, f);
     } break;
+    case Solver::thomas_factored: {
+      if (nprob == 1) {
+        const auto As = scalarize(A);
+        const auto f = KOKKOS_LAMBDA (const MT& team) {
+          const auto dl = get_diag(As, 0);
+          const auto d  = get_diag(As, 1);
+          const auto du = get_diag(As, 2);
+          ekat::tridiag::thomas_factor(team, dl, d, du);
+          ekat::tridiag::thomas_solve_factored(team, dl, d, du, X);
+        };
+        Kokkos::parallel_for(policy, f);
+      } else {
+        const auto f = KOKKOS_LAMBDA (const MT& team) {
+          const auto dl = get_diags(A, 0);
+          const auto d  = get_diags(A, 1);
+          const auto du = get_diags(A, 2);
+          ekat::tridiag::thomas_factor(team, dl, d, du);
+          ekat::tridiag::thomas_solve_factored(team, dl, d, du, X);
+        };
+        Kokkos::parallel_for(policy, f);
+      }
+    } break;
+    case Solver::cr_factored: {
+      assert(nprob == 1);
+      const auto As = scalarize(A);
+      const auto Xs = scalarize(X);
+      const Kokkos::View<typename APack::scalar*> coef(
+        "coef", ekat::tridiag::cr_factor_size(A.extent_int(1)));
+      const auto f = KOKKOS_LAMBDA (const MT& team) {
+        const auto dl = get_diag(As, 0);
+        const auto d  = get_diag(As, 1);
+        const auto du = get_diag(As, 2);
+        ekat::tridiag::cr_factor(team, dl, d, du, coef);
+        if (nrhs == 1)
+          ekat::tridiag::cr_solve_factored(team, dl, d, du, coef, get_x(Xs));
+        else
+          ekat::tridiag::cr_solve_factored(team, dl, d, du, coef, Xs);
+      };
+      Kokkos::parallel_for(policy, f);
+    } break;
+    case Solver::partitioned_thomas: {
+      assert(nprob == 1);
+      const auto As = scalarize(A);
+      const auto Xs = scalarize(X);
+      const auto f = KOKKOS_LAMBDA (const MT& team) {
+        const auto dl = get_diag(As, 0);
+        const auto d  = get_diag(As, 1);
+        const auto du = get_diag(As, 2);
+        if (nrhs == 1)
+          ekat::tridiag::partitioned_thomas(team, dl, d, du, get_x(Xs));
+        else
+          ekat::tridiag::partitioned_thomas(team, dl, d, du, Xs);
+      };
+      Kokkos::parallel_for(policy, f);
+    } break;
+    case Solver::cyclic_thomas: {
+      if (nprob == 1) {
+        const auto As = scalarize(A);
+        const auto Xs = scalarize(X);
+        const Kokkos::View<typename APack::scalar*> z("z", A.extent_int(1));
+        const auto f = KOKKOS_LAMBDA (const MT& team) {
+          const auto dl = get_diag(As, 0);
+          const auto d  = get_diag(As, 1);
+          const auto du = get_diag(As, 2);
+          if (nrhs == 1)
+            ekat::tridiag::cyclic_thomas(team, dl, d, du, get_x(Xs), z);
+          else
+            ekat::tridiag::cyclic_thomas(team, dl, d, du, X, z);
+        };
+        Kokkos::parallel_for(policy, f);
+      } else {
+        const Kokkos::View<APack**, TestConfig::TeamLayout> z(
+          "z", A.extent_int(1), A.extent_int(2));
+        const auto f = KOKKOS_LAMBDA (const MT& team) {
+          const auto dl = get_diags(A, 0);
+          const auto d  = get_diags(A, 1);
+          const auto du = get_diags(A, 2);
+          ekat::tridiag::cyclic_thomas(team, dl, d, du, X, z);
+        };
+        Kokkos::parallel_for(policy, f);
+      }
+    } break;
     default:
       EKAT_REQUIRE_MSG(false, "Same pack size: " << Solver::convert(tc.solver));
     }
@@ -299,6 +406,38 @@ struct Solve<false, APack, DataPack> {
       };
       Kokkos::parallel_for(policy, f);
     } break;
+    case Solver::thomas_factored: {
+      const auto As = scalarize(A);
+      const auto f = KOKKOS_LAMBDA (const MT& team) {
+        const auto dl = get_diag(As, 0);
+        const auto d  = get_diag(As, 1);
+        const auto du = get_diag(As, 2);
+        ekat::tridiag::thomas_factor(team, dl, d, du);
+        ekat::tridiag::thomas_solve_factored(team, dl, d, du, X);
+      };
+      Kokkos::parallel_for(policy, f);
+    } break;
+    case Solver::partitioned_thomas: {
+      const auto As = scalarize(A);
+      const auto f = KOKKOS_LAMBDA (const MT& team) {
+        const auto dl = get_diag(As, 0);
+        const auto d  = get_diag(As, 1);
+        const auto du = get_diag(As, 2);
+        ekat::tridiag::partitioned_thomas(team, dl, d, du, X);
+      };
+      Kokkos::parallel_for(policy, f);
+    } break;
+    case Solver::cyclic_thomas: {
+      const auto As = scalarize(A);
+      const Kokkos::View<typename APack::scalar*> z("z", A.extent_int(1));
+      const auto f = KOKKOS_LAMBDA (const MT& team) {
+        const auto dl = get_diag(As, 0);
+        const auto d  = get_diag(As, 1);
+        const auto du = get_diag(As, 2);
+        ekat::tridiag::cyclic_thomas(team, dl, d, du, X, z);
+      };
+      Kokkos::parallel_for(policy, f);
+    } break;
     default:
       EKAT_REQUIRE_MSG(false, "Different pack size: " << Solver::convert(tc.solver));
     }
@@ -345,7 +484,7 @@ void fill (Data<APack, DataPack>& dt) {
 }
 
 template <typename APack, typename DataPack>
-Real relerr (Data<APack, DataPack>& dt) {
+Real relerr (Data<APack, DataPack>& dt, const bool cyclic = false) {
   using Kokkos::create_mirror_view;
   using Kokkos::deep_copy;
   using Kokkos::subview;
@@ -360,7 +499,7 @@ Real relerr (Data<APack, DataPack>& dt) {
   const auto Ym = create_mirror_view(dt.Y);
   deep_copy(Acopym, dt.Acopy);
   deep_copy(Xm, dt.X);
-  matvec(dl, d, du, scalarize(Xm), scalarize(Ym), dt.nprob, dt.nrhs);
+  matvec(dl, d, du, scalarize(Xm), scalarize(Ym), dt.nprob, dt.nrhs, cyclic);
   const auto Bm = create_mirror_view(dt.B);
   deep_copy(Bm, dt.B);
   const auto re = rel_diff(scalarize(Bm), scalarize(Ym), dt.nrhs);
@@ -426,12 +565,6 @@ void run_property_test_on_config (const TestConfig& tc) {
         if (nrhs == 1 && A_many) continue;
         const int nprob = A_many ? nrhs : 1;
 
-        // Skip unsupported solver-problem format combinations.
-        if ((tc.solver == Solver::thomas_team_scalar ||
-             tc.solver == Solver::thomas_team_pack)
-            && nprob > 1)
-          continue;
-
         // Skip combinations generated at this and higher levels that Solve::run
         // doesn't support to reduce redundancies.
         if ((nrhs  == 1 && data_pack_size > 1) ||
@@ -439,9 +572,17 @@ void run_property_test_on_config (const TestConfig& tc) {
           continue;
         if ((tc.solver == Solver::thomas_team_scalar ||
              tc.solver == Solver::thomas_scalar ||
-             tc.solver == Solver::cr_scalar
+             tc.solver == Solver::cr_scalar ||
+             tc.solver == Solver::cr_factored
             ) && data_pack_size > 1)
           continue;
+        // Skip unsupported solver-problem format combinations.
+        if ((tc.solver == Solver::cr_factored ||
+             tc.solver == Solver::partitioned_thomas)
+            && nprob > 1)
+          continue;
+        if (tc.solver == Solver::cyclic_thomas && nrow == 1)
+          continue;
         if (static_cast<int>(APack::n) != static_cast<int>(DataPack::n) && nprob > 1)
           continue;
 
@@ -451,7 +592,7 @@ void run_property_test_on_config (const TestConfig& tc) {
         Solve<A_pack_size == data_pack_size, APack, DataPack>
           ::run(tc, dt.A, dt.X, nprob, nrhs);
 
-        const auto re = relerr(dt);
+        const auto re = relerr(dt, tc.solver == Solver::cyclic_thomas);
         const bool pass = re <= 50*std::numeric_limits<Real>::epsilon();
         if ( ! pass) {
           std::stringstream ss;
@@ -471,6 +612,163 @@ void run_property_test () {
   run_test_configs(run_property_test_on_config<A_pack_size, data_pack_size>);
 }
 
+// Block tridiagonal matrices with BxB blocks. Block (i,w), w = 0,1,2 for
+// dl,d,du, is in A(w,i,:,:,:), and the diagonal blocks are diagonally dominant.
+template <int NB, typename APack, typename DataPack>
+struct BlockData {
+  using BlockArray = Kokkos::View<APack*****, TestConfig::TeamLayout>;
+  using BlockDataArray = Kokkos::View<DataPack***, TestConfig::TeamLayout>;
+
+  const int nrow, nprob, nrhs;
+  BlockArray A, Acopy;
+  BlockDataArray B, X;
+
+  BlockData (const int nrow_, const int nprob_, const int nrhs_)
+    : nrow(nrow_), nprob(nprob_), nrhs(nrhs_),
+      A("A", 3, nrow, NB, NB, ekat::npack<APack>(nprob)),
+      Acopy("A", 3, nrow, NB, NB, A.extent(4)),
+      B("B", nrow, NB, ekat::npack<DataPack>(nrhs)),
+      X("X", nrow, NB, B.extent(2))
+  {}
+};
+
+template <int B, typename APack, typename DataPack>
+void fill (BlockData<B, APack, DataPack>& dt) {
+  const auto Am = Kokkos::create_mirror_view(dt.A);
+  const auto Bm = Kokkos::create_mirror_view(dt.B);
+  const auto As = scalarize(Am);
+  const auto Bs = scalarize(Bm);
+  // Fill the pack lanes past nprob, nrhs too, so the solvers see no zero pivots.
+  for (int p = 0; p < As.extent_int(4); ++p)
+    for (int i = 0; i < dt.nrow; ++i)
+      for (int r = 0; r < B; ++r) {
+        Real sum = 0;
+        for (int w = 0; w < 3; ++w)
+          for (int c = 0; c < B; ++c) {
+            const int k = p + 3*i + 5*r + 7*c + 11*w;
+            As(w,i,r,c,p) = (k % 5 == 0 ? -1 : 1) * 1.3 * (0.1 + ((k*k) % 11));
+            if (w != 1 || c != r) sum += std::abs(As(w,i,r,c,p));
+          }
+        As(1,i,r,r,p) = (i % 3 == 0 ? -1 : 1) * (0.7 + sum + (p + i) % 17);
+      }
+  for (int i = 0; i < dt.nrow; ++i)
+    for (int r = 0; r < B; ++r)
+      for (int j = 0; j < Bs.extent_int(2); ++j)
+        Bs(i,r,j) = ((7*i + 11*j + 3*r) % 3 == 0 ? -1 : 1) * 1.7 * (1 + (17*i + 13*j + 5*r) % 47);
+  Kokkos::deep_copy(dt.A, Am);
+  Kokkos::deep_copy(dt.B, Bm);
+  Kokkos::deep_copy(dt.Acopy, dt.A);
+  Kokkos::deep_copy(dt.X, dt.B);
+}
+
+template <int B, typename APack, typename DataPack>
+Real relerr (BlockData<B, APack, DataPack>& dt) {
+  const auto Am = Kokkos::create_mirror_view(dt.Acopy);
+  const auto Bm = Kokkos::create_mirror_view(dt.B);
+  const auto Xm = Kokkos::create_mirror_view(dt.X);
+  Kokkos::deep_copy(Am, dt.Acopy);
+  Kokkos::deep_copy(Bm, dt.B);
+  Kokkos::deep_copy(Xm, dt.X);
+  const auto As = scalarize(Am);
+  const auto Bs = scalarize(Bm);
+  const auto Xs = scalarize(Xm);
+  Real num = 0, den = 0;
+  for (int j = 0; j < dt.nrhs; ++j) {
+    const int p = dt.nprob > 1 ? j : 0;
+    for (int i = 0; i < dt.nrow; ++i)
+      for (int r = 0; r < B; ++r) {
+        Real y = 0;
+        for (int w = 0; w < 3; ++w) {
+          const int ii = i + w - 1;
+          if (ii < 0 || ii >= dt.nrow) continue;
+          for (int c = 0; c < B; ++c)
+            y += As(w,i,r,c,p) * Xs(ii,c,j);
+        }
+        if (std::isnan(y) || std::isinf(y))
+          return std::numeric_limits<Real>::infinity();
+        num = std::max(num, std::abs(y - Bs(i,r,j)));
+        den = std::max(den, std::abs(Bs(i,r,j)));
+      }
+  }
+  return num/den;
+}
+
+template <int B, typename APack, typename DataPack>
+void run_block_solve (BlockData<B, APack, DataPack>& dt) {
+  using TeamPolicy = Kokkos::TeamPolicy<Kokkos::DefaultExecutionSpace>;
+  using MT = typename TeamPolicy::member_type;
+  using Scalar = typename APack::scalar;
+
+  const int concurrency = Kokkos::DefaultExecutionSpace().concurrency();
+  const int nthr = ekat::OnGpu<Kokkos::DefaultExecutionSpace>::value ? 128 : concurrency;
+  TeamPolicy policy(1, nthr, 1);
+  const int nrow = dt.nrow, nprob = dt.nprob, nrhs = dt.nrhs;
+  const auto A = dt.A;
+  const auto As = scalarize(dt.A);
+  const auto X = dt.X;
+  const auto f = KOKKOS_LAMBDA (const MT& team) {
+    if (nprob == 1) {
+      // One matrix, so scalar diagonals, as in the property test.
+      const auto diag = [&] (const int w) {
+        return Kokkos::View<Scalar***, TestConfig::TeamLayout>(
+          &As.impl_map().reference(w, 0, 0, 0, 0), nrow, B, B);
+      };
+      if (nrhs == 1)
+        ekat::tridiag::block_thomas<B>(
+          team, diag(0), diag(1), diag(2),
+          Kokkos::View<DataPack**, TestConfig::TeamLayout>(X.data(), nrow, B));
+      else
+        ekat::tridiag::block_thomas<B>(team, diag(0), diag(1), diag(2), X);
+    } else if constexpr (static_cast<int>(APack::n) == static_cast<int>(DataPack::n)) {
+      const auto diag = [&] (const int w) {
+        return Kokkos::View<APack****, TestConfig::TeamLayout>(
+          &A.impl_map().reference(w, 0, 0, 0, 0), nrow, B, B, A.extent_int(4));
+      };
+      ekat::tridiag::block_thomas<B>(team, diag(0), diag(1), diag(2), X);
+    }
+  };
+  Kokkos::parallel_for(policy, f);
+}
+
+template <int B, int A_pack_size, int data_pack_size>
+void run_block_test () {
+  using APack = ekat::Pack<Real, A_pack_size>;
+  using DataPack = ekat::Pack<Real, data_pack_size>;
+
+  for (const int nrow : {1,2,3,5,16,43,128}) {
+    for (const int nrhs : {1,4,13}) {
+      for (const bool A_many : {false, true}) {
+        if (nrhs == 1 && A_many) continue;
+        const int nprob = A_many ? nrhs : 1;
+        // As in the property test, packs are used only for many matrices or L,RHS.
+        if ((nrhs  == 1 && data_pack_size > 1) ||
+            (nprob == 1 && A_pack_size    > 1))
+          continue;
+        if (A_pack_size != data_pack_size && nprob > 1)
+          continue;
+
+        BlockData<B, APack, DataPack> dt(nrow, nprob, nrhs);
+        fill(dt);
+        run_block_solve(dt);
+        const auto re = relerr(dt);
+        const bool pass = re <= 100*std::numeric_limits<Real>::epsilon();
+        if ( ! pass)
+          std::cout << "FAIL: block_thomas<" << B << "> | " << nrow << " " << nrhs
+                    << " " << A_many << " | log10 rel_diff " << std::log10(re) << "\n";
+        REQUIRE(pass);
+      }
+    }
+  }
+}
+
+template <int A_pack_size, int data_pack_size>
+void run_block_tests () {
+  run_block_test<1, A_pack_size, data_pack_size>();
+  run_block_test<2, A_pack_size, data_pack_size>();
+  run_block_test<3, A_pack_size, data_pack_size>();
+  run_block_test<4, A_pack_size, data_pack_size>();
+}
+
 } // namespace correct
 } // namespace test
 } // namespace ekat
@@ -482,3 +780,11 @@ TEST_CASE("property", "tridiag") {
     ekat::test::correct::run_property_test<EKAT_TEST_PACK_SIZE, EKAT_TEST_PACK_SIZE>();
   }
 }
+
+TEST_CASE("block", "tridiag") {
+  ekat::test::correct::run_block_tests<1,1>();
+  if (EKAT_TEST_PACK_SIZE > 1) {
+    ekat::test::correct::run_block_tests<1, EKAT_TEST_PACK_SIZE>();
+    ekat::test::correct::run_block_tests<EKAT_TEST_PACK_SIZE, EKAT_TEST_PACK_SIZE>();
+  }
+}
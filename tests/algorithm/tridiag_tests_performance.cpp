@@ -19,6 +19,8 @@ std::string Solver::convert (Enum e) {
   switch (e) {
     case thomas: return "thomas";
     case cr: return "cr";
+    case thomas_batched: return "thomas_batched";
+    case partitioned_thomas: return "partitioned_thomas";
     default: EKAT_REQUIRE_MSG(false, "Not a valid solver: " << static_cast<int>(e));
   }
   return "";
@@ -27,11 +29,13 @@ std::string Solver::convert (Enum e) {
 Solver::Enum Solver::convert (const std::string& s) {
   if (s == "thomas") return thomas;
   if (s == "cr") return cr;
+  if (s == "thomas_batched") return thomas_batched;
+  if (s == "partitioned_thomas") return partitioned_thomas;
   return error;
 }
 
 Input::Input ()
-  : method(Solver::cr), nprob(2048), nrow(128), nrhs(43), nwarp(-1),
+  : method(Solver::cr), nprob(2048), nrow(128), nrhs(43), nwarp(-1), nthread(1), nsolve(0),
     pack( ! ekat::OnGpu<Kokkos::DefaultExecutionSpace>::value),
     oneA(false)
 {}
@@ -60,13 +64,21 @@ bool Input::parse (int argc, char** argv) {
     } else if (argv_matches(argv[i], "-nw", "--nwarp")) {
       expect_another_arg(i, argc);
       nwarp = std::atoi(argv[++i]);
+    } else if (argv_matches(argv[i], "-nt", "--nthread")) {
+      expect_another_arg(i, argc);
+      nthread = std::atoi(argv[++i]);
     } else if (argv_matches(argv[i], "-nop", "--nopack")) {
       pack = false;
+    } else if (argv_matches(argv[i], "-ns", "--nsolve")) {
+      expect_another_arg(i, argc);
+      nsolve = std::atoi(argv[++i]);
     } else {
       std::cout << "Unexpected arg: " << argv[i] << "\n";
       return false;
     }
   }
+  if (method == Solver::thomas_batched) nrhs = 1;
+  if (nsolve > 0) oneA = true;
   if (nrhs == 1) oneA = true;
   if (method == Solver::cr) pack = false;
   return true;
@@ -80,7 +92,10 @@ std::string string (const Input& in, const int& nwarp) {
      << " nrow " << in.nrow
      << " nA " << (in.oneA ? 1 : in.nrhs)
      << " nrhs " << in.nrhs
-     << " nwarp " << nwarp << "\n";
+     << " nwarp " << nwarp;
+  if (in.nthread > 1) ss << " nthread " << in.nthread;
+  if (in.nsolve > 0) ss << " nsolve " << in.nsolve;
+  ss << "\n";
   return ss.str();
 }
 
@@ -128,6 +143,252 @@ using TridiagArrays = Kokkos::View<Scalar****, BulkLayout>;
 template <typename Scalar>
 using DataArrays = Kokkos::View<Scalar***, BulkLayout>;
 
+using TeamPolicy = Kokkos::TeamPolicy<Kokkos::DefaultExecutionSpace>;
+using TimePoint = std::chrono::steady_clock::time_point;
+
+TimePoint gettime () {
+  return std::chrono::steady_clock::now();
+}
+
+// Elapsed time in seconds.
+double duration (const TimePoint& t0, const TimePoint& tf) {
+  return 1e-6*std::chrono::duration_cast<std::chrono::microseconds>(tf - t0).count();
+}
+
+// On GPU, nwarp warps per team (4 by default); otherwise, nthread threads.
+int get_team_size (const Input& in) {
+  const bool on_gpu = ekat::OnGpu<Kokkos::DefaultExecutionSpace>::value;
+  return on_gpu ? (in.nwarp < 0 ? 128 : 32*in.nwarp) : in.nthread;
+}
+
+TeamPolicy get_team_policy (const Input& in, const int nteam) {
+  return TeamPolicy(nteam, get_team_size(in), 1);
+}
+
+// Check the solution X of problem ip, which has nA matrices and nrhs L,RHS, by
+// comparing A X, with A from Acopy, with B, and report the relative difference
+// if it is too large. Y is a work array with the shape of X.
+template <typename TridiagArray, typename DataArray, typename HostDataArray>
+void check_solution (const TridiagArray& Acopy, const DataArray& X, const DataArray& Y,
+                     const HostDataArray& Bm, const int ip, const int nA, const int nrhs) {
+  using Kokkos::create_mirror_view;
+  using Kokkos::deep_copy;
+  using Kokkos::subview;
+  using Kokkos::ALL;
+  using Scalar = typename HostDataArray::non_const_value_type;
+
+  auto Acopym = create_mirror_view(Acopy);
+  auto Xm = create_mirror_view(X);
+  auto Ym = create_mirror_view(Y);
+  deep_copy(Acopym, Acopy);
+  deep_copy(Xm, X);
+  const auto dl = subview(Acopym, ip, 0, ALL(), ALL());
+  const auto d  = subview(Acopym, ip, 1, ALL(), ALL());
+  const auto du = subview(Acopym, ip, 2, ALL(), ALL());
+  matvec(dl, d, du,
+         subview(Xm, ip, ALL(), ALL()),
+         subview(Ym, ip, ALL(), ALL()),
+         nA, nrhs);
+  const auto re = rel_diff(subview(Bm, ip, ALL(), ALL()),
+                           subview(Ym, ip, ALL(), ALL()),
+                           nrhs);
+  if (re > 50*std::numeric_limits<Scalar>::epsilon())
+    std::cout << "run: " << " re " << re << "\n";
+}
+
+// Batched mode: the nprob problems, each with one L,RHS, are the columns, which
+// are interleaved into the lanes of packs of size N, and each team solves the
+// systems of a contiguous chunk of columns with the batched Thomas algorithm.
+// On GPU, a team has one column per thread; otherwise, one pack of columns.
+template <typename Real, int N>
+void run_batched (const Input& in) {
+  using Kokkos::create_mirror_view;
+  using Kokkos::deep_copy;
+  using Kokkos::subview;
+  using Kokkos::ALL;
+  using ekat::scalarize;
+  using MT = typename TeamPolicy::member_type;
+  using ColPack = ekat::Pack<Real, N>;
+
+  const int npack_team = get_team_size(in);
+  const int nteam = (ekat::npack<ColPack>(in.nprob) + npack_team - 1)/npack_team;
+  const int ncol_team = npack_team*N;
+
+  TridiagArrays<ColPack> Ap("A", nteam, 3, in.nrow, npack_team),
+    Apcopy("Acopy", nteam, 3, in.nrow, npack_team);
+  DataArrays<ColPack> Bp("B", nteam, in.nrow, npack_team),
+    Xp("X", nteam, in.nrow, npack_team), Yp("Y", nteam, in.nrow, npack_team);
+  const auto A = scalarize(Ap), Acopy = scalarize(Apcopy);
+  const auto B = scalarize(Bp), X = scalarize(Xp), Y = scalarize(Yp);
+
+  // Fill all the lanes, including those past nprob, so that every system is
+  // nonsingular.
+  auto Am = create_mirror_view(A);
+  auto Bm = create_mirror_view(B);
+  const auto fill = [&] (const int i) {
+    const auto dl = subview(Am, i, 0, ALL(), ALL());
+    const auto d  = subview(Am, i, 1, ALL(), ALL());
+    const auto du = subview(Am, i, 2, ALL(), ALL());
+    fill_tridiag_matrix(dl, d, du, ncol_team, i);
+    fill_data_matrix(subview(Bm, i, ALL(), ALL()), i);
+  };
+  Kokkos::parallel_for(
+    Kokkos::RangePolicy<Kokkos::DefaultHostExecutionSpace>(0, nteam), fill);
+  deep_copy(A, Am);
+  deep_copy(B, Bm);
+  deep_copy(Acopy, A);
+
+  const auto policy = get_team_policy(in, nteam);
+  std::cout << string(in, policy.team_size()/32);
+
+  TimePoint t0, t1;
+  for (int trial = 0; trial < 2; ++trial) {
+    deep_copy(Ap, Apcopy);
+    deep_copy(Xp, Bp);
+    Kokkos::fence();
+    t0 = gettime();
+    const auto f = KOKKOS_LAMBDA (const MT& team) {
+      const int it = team.league_rank();
+      const auto dl = get_diags(Ap, it, 0);
+      const auto d  = get_diags(Ap, it, 1);
+      const auto du = get_diags(Ap, it, 2);
+      const auto x  = get_xs(Xp, it);
+      ekat::tridiag::thomas(team, dl, d, du, x);
+    };
+    Kokkos::parallel_for(policy, f);
+    Kokkos::fence();
+    t1 = gettime();
+  }
+
+  const auto et = duration(t0, t1);
+  printf("run: et %1.3e et/datum %1.3e\n", et, et/(in.nprob*in.nrow));
+
+  check_solution(Acopy, X, Y, Bm, nteam-1, ncol_team, ncol_team);
+}
+
+// Factored mode: each team solves nsolve times with the same matrix, and the
+// time to rebuild the matrix and solve from scratch each time is compared with
+// the time to factor it once and solve with the factors each time. The L,RHS
+// are restored from B before each solve in both cases.
+template <typename Real, int N>
+void run_factored (const Input& in) {
+  using Kokkos::create_mirror_view;
+  using Kokkos::deep_copy;
+  using Kokkos::subview;
+  using Kokkos::ALL;
+  using ekat::scalarize;
+  using ekat::npack;
+  using MT = typename TeamPolicy::member_type;
+  using DataPack = ekat::Pack<Real, N>;
+
+  EKAT_REQUIRE_MSG(in.method == Solver::thomas || in.method == Solver::cr,
+                   "Factored mode supports thomas and cr.");
+
+  const int nsolve = in.nsolve;
+  const int nrow = in.nrow;
+  const int nrhs = npack<DataPack>(in.nrhs);
+  const bool use_cr = in.method == Solver::cr;
+
+  TridiagArrays<Real> A("A", in.nprob, 3, nrow, 1), Acopy("Acopy", in.nprob, 3, nrow, 1);
+  DataArrays<DataPack> Bp("B", in.nprob, nrow, nrhs), Xp("X", in.nprob, nrow, nrhs),
+    Yp("Y", in.nprob, nrow, nrhs);
+  const Kokkos::View<Real**, BulkLayout> F("F", in.nprob, ekat::tridiag::cr_factor_size(nrow));
+  const auto B = scalarize(Bp), X = scalarize(Xp), Y = scalarize(Yp);
+
+  auto Am = create_mirror_view(A);
+  auto Bm = create_mirror_view(B);
+  const auto fill = [&] (const int i) {
+    const auto dl = subview(Am, i, 0, ALL(), ALL());
+    const auto d  = subview(Am, i, 1, ALL(), ALL());
+    const auto du = subview(Am, i, 2, ALL(), ALL());
+    fill_tridiag_matrix(dl, d, du, 1, i);
+    fill_data_matrix(subview(Bm, i, ALL(), ALL()), in.nrhs);
+  };
+  Kokkos::parallel_for(
+    Kokkos::RangePolicy<Kokkos::DefaultHostExecutionSpace>(0, in.nprob), fill);
+  deep_copy(A, Am);
+  deep_copy(B, Bm);
+  deep_copy(Acopy, A);
+
+  const auto policy = get_team_policy(in, in.nprob);
+  std::cout << string(in, policy.team_size()/32);
+
+  const auto restore_A = KOKKOS_LAMBDA (const MT& team, const int ip) {
+    Kokkos::parallel_for(Kokkos::TeamVectorRange(team, 3*nrow), [&] (const int& k) {
+      A(ip, k / nrow, k % nrow, 0) = Acopy(ip, k / nrow, k % nrow, 0);
+    });
+    team.team_barrier();
+  };
+  const auto restore_X = KOKKOS_LAMBDA (const MT& team, const int ip) {
+    Kokkos::parallel_for(Kokkos::TeamVectorRange(team, nrow*nrhs), [&] (const int& k) {
+      Xp(ip, k / nrhs, k % nrhs) = Bp(ip, k / nrhs, k % nrhs);
+    });
+    team.team_barrier();
+  };
+
+  // Rebuild and solve from scratch nsolve times.
+  const auto refactor = KOKKOS_LAMBDA (const MT& team) {
+    const int ip = team.league_rank();
+    const auto dl = get_diag(A, ip, 0);
+    const auto d  = get_diag(A, ip, 1);
+    const auto du = get_diag(A, ip, 2);
+    const auto x  = get_xs(Xp, ip);
+    for (int s = 0; s < nsolve; ++s) {
+      restore_A(team, ip);
+      restore_X(team, ip);
+      if (use_cr)
+        ekat::tridiag::cr(team, dl, d, du, scalarize(x));
+      else
+        ekat::tridiag::thomas(team, dl, d, du, x);
+      team.team_barrier();
+    }
+  };
+
+  // Factor once, and solve with the factors nsolve times.
+  const auto factored = KOKKOS_LAMBDA (const MT& team) {
+    const int ip = team.league_rank();
+    const auto dl = get_diag(A, ip, 0);
+    const auto d  = get_diag(A, ip, 1);
+    const auto du = get_diag(A, ip, 2);
+    const auto x  = get_xs(Xp, ip);
+    const Kokkos::View<Real*, TeamLayout, Kokkos::MemoryUnmanaged> f(
+      F.data() + ip*F.extent(1), F.extent(1));
+    restore_A(team, ip);
+    if (use_cr)
+      ekat::tridiag::cr_factor(team, dl, d, du, f);
+    else
+      ekat::tridiag::thomas_factor(team, dl, d, du);
+    for (int s = 0; s < nsolve; ++s) {
+      restore_X(team, ip);
+      if (use_cr)
+        ekat::tridiag::cr_solve_factored(team, dl, d, du, f, scalarize(x));
+      else
+        ekat::tridiag::thomas_solve_factored(team, dl, d, du, x);
+      team.team_barrier();
+    }
+  };
+
+  double et_refactor = 0, et_factored = 0;
+  for (int trial = 0; trial < 2; ++trial) {
+    Kokkos::fence();
+    auto t0 = gettime();
+    Kokkos::parallel_for(policy, refactor);
+    Kokkos::fence();
+    auto t1 = gettime();
+    et_refactor = duration(t0, t1);
+    t0 = gettime();
+    Kokkos::parallel_for(policy, factored);
+    Kokkos::fence();
+    t1 = gettime();
+    et_factored = duration(t0, t1);
+  }
+
+  printf("run: et refactor %1.3e factored %1.3e speedup %1.3f\n",
+         et_refactor, et_factored, et_refactor/et_factored);
+
+  check_solution(Acopy, X, Y, Bm, in.nprob-1, 1, in.nrhs);
+}
+
 template <typename Real>
 void run (const Input& in) {
   using Kokkos::create_mirror_view;
@@ -136,18 +397,25 @@ void run (const Input& in) {
   using Kokkos::ALL;
   using ekat::scalarize;
   using ekat::npack;
-  using TeamPolicy = Kokkos::TeamPolicy<Kokkos::DefaultExecutionSpace>;
   using MT = typename TeamPolicy::member_type;
   using APack = ekat::Pack<Real, EKAT_TEST_PACK_SIZE>;
   using DataPack = ekat::Pack<Real, EKAT_TEST_PACK_SIZE>;
 
-  const auto gettime = [&] () {
-    return std::chrono::steady_clock::now();
-  };
-  using TimePoint = decltype(gettime());
-  const auto duration = [&] (const TimePoint& t0, const TimePoint& tf) -> double {
-    return 1e-6*std::chrono::duration_cast<std::chrono::microseconds>(tf - t0).count();
-  };
+  if (in.nsolve > 0) {
+    if (in.pack)
+      run_factored<Real, EKAT_TEST_PACK_SIZE>(in);
+    else
+      run_factored<Real, 1>(in);
+    return;
+  }
+
+  if (in.method == Solver::thomas_batched) {
+    if (in.pack)
+      run_batched<Real, EKAT_TEST_PACK_SIZE>(in);
+    else
+      run_batched<Real, 1>(in);
+    return;
+  }
 
   const bool on_gpu = ekat::OnGpu<Kokkos::DefaultExecutionSpace>::value;
   // The following is morally a const var, but there are issues with
@@ -201,9 +469,7 @@ void run (const Input& in) {
   deep_copy(Acopy, A);
   deep_copy(X, B);
 
-  TeamPolicy policy(in.nprob,
-                    on_gpu ? (in.nwarp < 0 ? 128 : 32*in.nwarp) : 1,
-                    1);
+  const auto policy = get_team_policy(in, in.nprob);
   assert(in.nwarp < 0 || ! on_gpu || policy.team_size() == 32*in.nwarp);
   std::cout << string(in, policy.team_size()/32);
 
@@ -423,6 +689,44 @@ void run (const Input& in) {
     Kokkos::fence();
     t1 = gettime();    
   } break;
+  case Solver::partitioned_thomas: {
+    EKAT_REQUIRE_MSG(
+      in.oneA, "Only 1 A/team is supported in the partitioned Thomas algorithm.");
+    t0 = gettime();
+    if (in.pack) {
+      const auto f = KOKKOS_LAMBDA (const MT& team) {
+        const int ip = team.league_rank();
+        const auto dl = get_diag(A, ip, 0);
+        const auto d  = get_diag(A, ip, 1);
+        const auto du = get_diag(A, ip, 2);
+        const auto x  = get_xs(Xp, ip);
+        ekat::tridiag::partitioned_thomas(team, dl, d, du, x);
+      };
+      Kokkos::parallel_for(policy, f);
+    } else if (in.nrhs == 1) {
+      const auto f = KOKKOS_LAMBDA (const MT& team) {
+        const int ip = team.league_rank();
+        const auto dl = get_diag(A, ip, 0);
+        const auto d  = get_diag(A, ip, 1);
+        const auto du = get_diag(A, ip, 2);
+        const auto x  = get_x(X, ip);
+        ekat::tridiag::partitioned_thomas(team, dl, d, du, x);
+      };
+      Kokkos::parallel_for(policy, f);
+    } else {
+      const auto f = KOKKOS_LAMBDA (const MT& team) {
+        const int ip = team.league_rank();
+        const auto dl = get_diag(A, ip, 0);
+        const auto d  = get_diag(A, ip, 1);
+        const auto du = get_diag(A, ip, 2);
+        const auto x  = get_xs(X, ip);
+        ekat::tridiag::partitioned_thomas(team, dl, d, du, x);
+      };
+      Kokkos::parallel_for(policy, f);
+    }
+    Kokkos::fence();
+    t1 = gettime();
+  } break;
   default:
     std::cout << "run does not support "
               << Solver::convert(in.method) << "\n";
@@ -431,26 +735,7 @@ void run (const Input& in) {
   const auto et = duration(t0, t1);
   printf("run: et %1.3e et/datum %1.3e\n", et, et/(in.nprob*in.nrow*in.nrhs));
 
-  Real re; {
-    auto Acopym = create_mirror_view(Acopy);
-    auto Xm = create_mirror_view(X);
-    auto Ym = create_mirror_view(Y);
-    deep_copy(Acopym, Acopy);
-    deep_copy(Xm, X);
-    const auto ip = std::max(0, in.nprob-1);
-    const auto dl = subview(Acopym, ip, 0, ALL(), ALL());
-    const auto d  = subview(Acopym, ip, 1, ALL(), ALL());
-    const auto du = subview(Acopym, ip, 2, ALL(), ALL());
-    matvec(dl, d, du,
-           subview(Xm, in.nprob-1, ALL(), ALL()),
-           subview(Ym, in.nprob-1, ALL(), ALL()),
-           nA, in.nrhs);
-    re = rel_diff(subview(Bm, in.nprob-1, ALL(), ALL()),
-                subview(Ym, in.nprob-1, ALL(), ALL()),
-                in.nrhs);
-  }
-  if (re > 50*std::numeric_limits<Real>::epsilon())
-    std::cout << "run: " << " re " << re << "\n";
+  check_solution(Acopy, X, Y, Bm, in.nprob-1, nA, in.nrhs);
 }
 
 template void run<Real>(const Input&);
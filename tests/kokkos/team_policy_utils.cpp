@@ -118,7 +118,85 @@ TEST_CASE("team_utils_omp", "[kokkos_utils]")
 #endif
 }
 
-void test_utils_large_ni(const double saturation_multiplier)
+TEST_CASE("slot_free_list", "[kokkos_utils]")
+{
+  using namespace ekat;
+
+  using Device = DefaultDevice;
+  using ExeSpace = typename KokkosTypes<Device>::ExeSpace;
+  using MemberType = typename KokkosTypes<Device>::MemberType;
+  using view_1d = typename KokkosTypes<Device>::template view_1d<int>;
+
+  const int n = 5;
+  impl::SlotFreeList<ExeSpace> fl(n);
+  REQUIRE(fl.size() == n);
+
+  // Serial checks: pop all slots (slot 0 first), then pop from the empty list,
+  // and check that slots are handed back in LIFO order.
+  view_1d slots("slots", n+3);
+  Kokkos::parallel_for(Kokkos::RangePolicy<ExeSpace>(0,1), KOKKOS_LAMBDA(const int) {
+    for (int i = 0; i <= n; ++i) {
+      slots(i) = fl.try_pop();
+    }
+    fl.push(1);
+    fl.push(3);
+    slots(n+1) = fl.pop();
+    slots(n+2) = fl.pop();
+    for (int i = 0; i < n; ++i) {
+      fl.push(i);
+    }
+  });
+  const auto slots_h = create_host_mirror_and_copy(slots);
+  for (int i = 0; i < n; ++i) {
+    REQUIRE(slots_h(i) == i);
+  }
+  REQUIRE(slots_h(n) == -1);
+  REQUIRE(slots_h(n+1) == 3);
+  REQUIRE(slots_h(n+2) == 1);
+
+  // Concurrent checks: many teams pop/push slots, and no two teams may own the same slot
+  const int ni = 10000;
+  const auto p = TeamPolicyFactory<ExeSpace>::get_default_team_policy(ni, 32);
+  view_1d owned("owned", n), count("count", n);
+  int nerr = 0;
+  Kokkos::parallel_reduce("slot_free_list_check", p, KOKKOS_LAMBDA(const MemberType& team, int& errs) {
+    Kokkos::single(Kokkos::PerTeam(team), [&] () {
+      const int slot = fl.pop();
+      if (slot < 0 || slot >= n) {
+        ++errs;
+        return;
+      }
+      if (Kokkos::atomic_exchange(&owned(slot), 1) != 0) ++errs;
+      Kokkos::atomic_add(&count(slot), 1);
+      Kokkos::atomic_store(&owned(slot), 0);
+      fl.push(slot);
+    });
+  }, nerr);
+  REQUIRE(nerr == 0);
+
+  const auto count_h = create_host_mirror_and_copy(count);
+  int sum = 0;
+  for (int i = 0; i < n; ++i) {
+    sum += count_h(i);
+  }
+  REQUIRE(sum == ni);
+
+  // After reset, all slots are available again, with slot 0 on top
+  fl.reset();
+  Kokkos::parallel_for(Kokkos::RangePolicy<ExeSpace>(0,1), KOKKOS_LAMBDA(const int) {
+    for (int i = 0; i <= n; ++i) {
+      slots(i) = fl.try_pop();
+    }
+  });
+  Kokkos::deep_copy(slots_h, slots);
+  for (int i = 0; i < n; ++i) {
+    REQUIRE(slots_h(i) == i);
+  }
+  REQUIRE(slots_h(n) == -1);
+}
+
+void test_utils_large_ni(const double saturation_multiplier,
+                         const ekat::WsSlotAssignment assignment)
 {
   using namespace ekat;
 
@@ -135,7 +213,7 @@ void test_utils_large_ni(const double saturation_multiplier)
   int ni = num_conc*saturation_multiplier;
   if (ni == 0) ni = 1;
   const auto p = TeamPolicyFactory<ExeSpace>::get_default_team_policy(ni, nk);
-  TeamUtils<double,ExeSpace> tu(p, overprov_factor);
+  TeamUtils<double,ExeSpace> tu(p, overprov_factor, assignment);
 
   REQUIRE(p.league_size() == ni);
   if (saturation_multiplier <= 1.0) {
@@ -150,19 +228,27 @@ void test_utils_large_ni(const double saturation_multiplier)
 
   int max_workspace_idx = 0;
   typename KokkosTypes<Device>::template view_1d<int> test_data("test_data", tu.get_num_ws_slots());
+  typename KokkosTypes<Device>::template view_1d<int> owned("owned", tu.get_num_ws_slots());
   Kokkos::parallel_reduce("unique_token_check", p, KOKKOS_LAMBDA(MemberType team_member, int& max_ws_idx) {
     const int wi = tu.get_workspace_idx(team_member);
 
     if (wi > max_ws_idx) { max_ws_idx = wi; }
 
     Kokkos::single(Kokkos::PerTeam(team_member), [&] () {
+      // No other team may be using this slot
+      if (Kokkos::atomic_exchange(&owned(wi), 1) != 0) {
+        max_ws_idx = tu.get_num_ws_slots();
+      }
       int volatile* const data = &test_data(wi);
       *data = *data + 1;
+      Kokkos::atomic_store(&owned(wi), 0);
     });
 
     tu.release_workspace_idx(team_member, wi);
   }, Kokkos::Max<int>(max_workspace_idx));
 
+  REQUIRE(max_workspace_idx < tu.get_num_ws_slots());
+
   const auto test_data_h = ekat::create_host_mirror_and_copy(test_data);
 
   int sum = 0;
@@ -175,9 +261,11 @@ void test_utils_large_ni(const double saturation_multiplier)
 
 TEST_CASE("team_utils_large_ni", "[kokkos_utils]")
 {
-  test_utils_large_ni(10);
-  test_utils_large_ni(1);
-  test_utils_large_ni(.5);
+  for (auto assignment : {ekat::WsSlotAssignment::Default, ekat::WsSlotAssignment::FreeList}) {
+    test_utils_large_ni(10, assignment);
+    test_utils_large_ni(1, assignment);
+    test_utils_large_ni(.5, assignment);
+  }
 }
 
 } // anonymous namespace
@@ -0,0 +1,257 @@
+#include "ekat_team_policy_utils.hpp"
+#include "ekat_kokkos_session.hpp"
+#include "ekat_kokkos_types.hpp"
+#include "ekat_view_utils.hpp"
+#include "ekat_test_utils.hpp"
+
+#include <impl/Kokkos_ClockTic.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+/*
+ * Contention benchmark for the assignment of workspace slots to teams.
+ *
+ * Each team of a policy with many more teams than can run concurrently
+ * acquires a slot, does w iterations of work while holding it (w=0 means the
+ * slot is released right away, i.e., maximum contention), and releases it.
+ * The time per team (acquire + work + release) is reported for
+ *
+ *   none:       no slot acquisition (the baseline)
+ *   team_utils: TeamUtils::get/release_workspace_idx for the default exec space
+ *               (thread id on OpenMP/Threads/HPX, the lock-free free list elsewhere)
+ *   free_list:  the lock-free free list of slots (impl::SlotFreeList)
+ *   probe_cas:  CAS on per-slot flags, probing from league_rank%nslots, as
+ *               TeamUtils does on GPU (but with linear rather than random probing)
+ *
+ * With -s, it instead sweeps the league size (as a multiple of the number of
+ * concurrent teams) and the overprovision factor (i.e., the number of slots,
+ * which only varies on GPU), for each WsSlotAssignment of TeamUtils. Each team
+ * times its own get_workspace_idx + release_workspace_idx pair with the device
+ * clock (Kokkos::Impl::clock_tic, i.e., clock cycles, not ns), and the
+ * distribution (min, median, 90th and 99th percentiles, and max) of these
+ * samples, over all the teams of the nrep runs, is reported. This shows how the
+ * tail latency of the slot acquisition grows as the number of slots approaches
+ * the number of concurrent teams.
+ *
+ * Usage: team_utils_perf [-l|--league L] [-t|--team-size T] [-w|--work W] [-r|--nrep R] [-s|--sweep]
+ */
+
+namespace ekat {
+namespace test {
+namespace perf {
+
+struct Input {
+  int league = 100000;
+  int team_size = 1;
+  int work = 0;
+  int nrep = 10;
+  bool sweep = false;
+
+  bool parse (int argc, char** argv) {
+    for (int i = 1; i < argc; ++i) {
+      if (argv_matches(argv[i], "-l", "--league")) {
+        if (i == argc-1) return false;
+        league = std::atoi(argv[++i]);
+      } else if (argv_matches(argv[i], "-t", "--team-size")) {
+        if (i == argc-1) return false;
+        team_size = std::atoi(argv[++i]);
+      } else if (argv_matches(argv[i], "-w", "--work")) {
+        if (i == argc-1) return false;
+        work = std::atoi(argv[++i]);
+      } else if (argv_matches(argv[i], "-r", "--nrep")) {
+        if (i == argc-1) return false;
+        nrep = std::atoi(argv[++i]);
+      } else if (argv_matches(argv[i], "-s", "--sweep")) {
+        sweep = true;
+      } else {
+        std::cout << "Unexpected arg: " << argv[i] << "\n";
+        return false;
+      }
+    }
+    return league>0 and team_size>0 and work>=0 and nrep>0;
+  }
+};
+
+void run (const Input& in) {
+  using clock = std::chrono::steady_clock;
+  using ExeSpace = typename DefaultDevice::execution_space;
+  using KT = KokkosTypes<DefaultDevice>;
+  using MemberType = typename KT::MemberType;
+  using view_1d = typename KT::template view_1d<int>;
+
+  const auto policy = TeamPolicyFactory<ExeSpace>::get_team_policy_force_team_size(in.league, in.team_size);
+  const TeamUtils<double,ExeSpace> tu(policy);
+  const int nslots = tu.get_num_ws_slots();
+  const impl::SlotFreeList<ExeSpace> fl(nslots);
+  const view_1d flags("flags",nslots);
+  const view_1d data("data",nslots);
+  const int work = in.work;
+
+  printf("team_utils_perf: exe space %s, concurrency %d, league %d, team size %d, slots %d, work %d, nrep %d\n",
+         ExeSpace::name(), ExeSpace().concurrency(), in.league, policy.team_size(), nslots, work, in.nrep);
+  printf("  %-12s %12s   (ns/team)\n", "method", "time");
+
+  // Do some work while holding slot idx
+  const auto hold = KOKKOS_LAMBDA (const int idx) {
+    int acc = data(idx);
+    for (int k = 0; k < work; ++k) {
+      acc = acc*3 + k;
+    }
+    data(idx) = acc + 1;
+  };
+
+  // Time kernel over the whole league, and return ns/team
+  const auto time_op = [&] (const char* name, const auto& f) {
+    Kokkos::parallel_for(policy, f);
+    Kokkos::fence();
+    Kokkos::deep_copy(data, 0);
+    const auto t0 = clock::now();
+    for (int r = 0; r < in.nrep; ++r)
+      Kokkos::parallel_for(policy, f);
+    Kokkos::fence();
+    const auto t1 = clock::now();
+    const double ns = std::chrono::duration<double,std::nano>(t1-t0).count();
+
+    const auto data_h = create_host_mirror_and_copy(data);
+    long long chk = 0;
+    for (int i = 0; i < nslots; ++i) chk += data_h(i);
+    printf("  %-12s %12.4f  (chk %lld)\n", name, ns/(double(in.nrep)*in.league), chk);
+  };
+
+  time_op("none", KOKKOS_LAMBDA (const MemberType& team) {
+    Kokkos::single(Kokkos::PerTeam(team), [&] () {
+      hold(team.league_rank() % nslots);
+    });
+  });
+
+  time_op("team_utils", KOKKOS_LAMBDA (const MemberType& team) {
+    const int idx = tu.get_workspace_idx(team);
+    Kokkos::single(Kokkos::PerTeam(team), [&] () {
+      hold(idx);
+    });
+    tu.release_workspace_idx(team, idx);
+  });
+
+  time_op("free_list", KOKKOS_LAMBDA (const MemberType& team) {
+    Kokkos::single(Kokkos::PerTeam(team), [&] () {
+      const int idx = fl.pop();
+      hold(idx);
+      fl.push(idx);
+    });
+  });
+
+  time_op("probe_cas", KOKKOS_LAMBDA (const MemberType& team) {
+    Kokkos::single(Kokkos::PerTeam(team), [&] () {
+      int idx = team.league_rank() % nslots;
+      while (Kokkos::atomic_compare_exchange(&flags(idx), 0, 1) != 0) {
+        idx = (idx+1) % nslots;
+      }
+      Kokkos::memory_fence();
+      hold(idx);
+      Kokkos::memory_fence();
+      Kokkos::atomic_store(&flags(idx), 0);
+    });
+  });
+}
+
+void sweep (const Input& in) {
+  using ExeSpace = typename DefaultDevice::execution_space;
+  using KT = KokkosTypes<DefaultDevice>;
+  using MemberType = typename KT::MemberType;
+  using view_1d = typename KT::template view_1d<int>;
+  using tics_1d = typename KT::template view_1d<uint64_t>;
+
+  const auto temp_policy = TeamPolicyFactory<ExeSpace>::get_team_policy_force_team_size(1, in.team_size);
+  const TeamUtils<double,ExeSpace> tu_temp(temp_policy);
+  const int num_conc = std::max(1, tu_temp.get_max_concurrent_threads() / temp_policy.team_size());
+  const int work = in.work;
+
+  printf("team_utils_perf sweep: exe space %s, concurrent teams %d, team size %d, work %d, nrep %d\n",
+         ExeSpace::name(), num_conc, temp_policy.team_size(), work, in.nrep);
+  printf("  %10s %8s %10s %12s %12s %12s %12s %12s   (clock tics per acquire+release)\n",
+         "league", "slots", "assignment", "min", "median", "p90", "p99", "max");
+
+  for (const int mult : {1, 2, 4, 16, 64}) {
+    const int league = num_conc*mult;
+    const auto policy = TeamPolicyFactory<ExeSpace>::get_team_policy_force_team_size(league, in.team_size);
+    for (const double overprov : {1.0, 1.25, 2.0}) {
+      // The overprovision factor only matters on GPU
+      if (not OnGpu<ExeSpace>::value and overprov != 1.0) continue;
+
+      for (const auto assignment : {WsSlotAssignment::Default, WsSlotAssignment::FreeList}) {
+        const TeamUtils<double,ExeSpace> tu(policy, overprov, assignment);
+        const view_1d data("data",tu.get_num_ws_slots());
+        // One sample per team per run
+        const tics_1d tics("tics",in.nrep*league);
+        const auto run_once = [&] (const int r) {
+          const auto f = KOKKOS_LAMBDA (const MemberType& team) {
+            const uint64_t t0 = Kokkos::Impl::clock_tic();
+            const int idx = tu.get_workspace_idx(team);
+            const uint64_t t1 = Kokkos::Impl::clock_tic();
+            Kokkos::single(Kokkos::PerTeam(team), [&] () {
+              int acc = data(idx);
+              for (int k = 0; k < work; ++k) {
+                acc = acc*3 + k;
+              }
+              data(idx) = acc + 1;
+            });
+            const uint64_t t2 = Kokkos::Impl::clock_tic();
+            tu.release_workspace_idx(team, idx);
+            const uint64_t t3 = Kokkos::Impl::clock_tic();
+            Kokkos::single(Kokkos::PerTeam(team), [&] () {
+              tics(r*league + team.league_rank()) = (t1 - t0) + (t3 - t2);
+            });
+          };
+          Kokkos::parallel_for(policy, f);
+          Kokkos::fence();
+        };
+
+        // The first run is a warmup, and its samples are overwritten
+        run_once(0);
+        for (int r = 0; r < in.nrep; ++r) {
+          run_once(r);
+        }
+        const auto tics_h = create_host_mirror_and_copy(tics);
+        std::vector<uint64_t> samples(tics_h.data(), tics_h.data() + tics_h.size());
+        std::sort(samples.begin(), samples.end());
+        const auto pct = [&] (const int p) {
+          return samples[(p*(samples.size()-1))/100];
+        };
+        printf("  %10d %8d %10s %12llu %12llu %12llu %12llu %12llu\n",
+               league, tu.get_num_ws_slots(),
+               assignment == WsSlotAssignment::Default ? "default" : "free_list",
+               (unsigned long long) samples.front(), (unsigned long long) pct(50),
+               (unsigned long long) pct(90), (unsigned long long) pct(99),
+               (unsigned long long) samples.back());
+      }
+    }
+  }
+}
+
+} // namespace perf
+} // namespace test
+} // namespace ekat
+
+int main (int argc, char** argv) {
+  ekat::test::perf::Input in;
+  if (not in.parse(argc,argv)) {
+    std::cout << "Usage: " << argv[0] << " [-l|--league L] [-t|--team-size T] [-w|--work W] [-r|--nrep R] [-s|--sweep]\n";
+    return 1;
+  }
+
+  ekat::initialize_kokkos_session(false); {
+    if (in.sweep) {
+      ekat::test::perf::sweep(in);
+    } else {
+      ekat::test::perf::run(in);
+    }
+  } ekat::finalize_kokkos_session();
+
+  return 0;
+}
@@ -0,0 +1,112 @@
+#include <catch2/catch.hpp>
+
+#include "ekat_workspace_arena.hpp"
+#include "ekat_team_policy_utils.hpp"
+
+#include "ekat_test_config.h"
+
+namespace {
+
+TEST_CASE("workspace_arena", "[kokkos_utils]")
+{
+  using namespace ekat;
+
+  using Device     = DefaultDevice;
+  using ExeSpace   = typename KokkosTypes<Device>::ExeSpace;
+  using MemberType = typename KokkosTypes<Device>::MemberType;
+  using WSMd       = WorkspaceManager<double, Device>;
+  using WSMi       = WorkspaceManager<int, Device>;
+
+  const int ni = 64;
+  const int nk = 32;
+  const auto policy = TeamPolicyFactory<ExeSpace>::get_default_team_policy(ni, nk);
+
+  WSMd wsm_a;
+  WSMi wsm_b;
+  WorkspaceArena<Device> arena;
+  REQUIRE(arena.add("a", wsm_a, nk, 4, policy) == 0);
+  REQUIRE(arena.add("b", wsm_b, { {nk, 2}, {4*nk, 3} }, policy) == 1);
+  REQUIRE(arena.get_num_managers() == 2);
+
+  const size_t bytes_a = WSMd::get_total_bytes_needed(nk, 4, policy);
+  const size_t bytes_b = WSMi::get_total_bytes_needed({ {nk, 2}, {4*nk, 3} }, policy);
+  REQUIRE(arena.get_bytes_needed(0) == bytes_a);
+  REQUIRE(arena.get_bytes_needed(1) == bytes_b);
+  REQUIRE(arena.get_total_bytes() == std::max(bytes_a, bytes_b));
+  REQUIRE(arena.get_separate_bytes() == bytes_a + bytes_b);
+
+  REQUIRE(not arena.is_allocated());
+  REQUIRE_THROWS(arena.activate(0));
+  arena.allocate();
+  REQUIRE(arena.is_allocated());
+  REQUIRE(arena.get_active() == -1);
+  REQUIRE_THROWS(arena.activate(2));
+  REQUIRE_THROWS(arena.allocate());
+  WSMd wsm_c;
+  REQUIRE_THROWS(arena.add("c", wsm_c, nk, 4, policy));
+
+  // Kernels using one WSM at a time can share the memory. Check that each one
+  // works on the shared memory, even after the other one overwrote it.
+  for (int r = 0; r < 2; ++r) {
+    int nerr = 0;
+    arena.activate(0);
+    REQUIRE(arena.get_active() == 0);
+    Kokkos::parallel_reduce("workspace_arena_a", policy, KOKKOS_LAMBDA(const MemberType& team, int& total_errs) {
+      auto ws = wsm_a.get_workspace(team);
+      const auto v = ws.take("v");
+      const auto w = ws.take("w");
+      Kokkos::parallel_for(Kokkos::TeamVectorRange(team, nk), [&] (int k) {
+        v(k) = team.league_rank() + k;
+        w(k) = -v(k);
+      });
+      team.team_barrier();
+      int nerr_local = 0;
+      Kokkos::single(Kokkos::PerTeam(team), [&] () {
+        for (int k = 0; k < nk; ++k) {
+          if (v(k) != team.league_rank() + k || w(k) != -v(k)) ++nerr_local;
+        }
+      });
+      ws.release(w);
+      ws.release(v);
+      total_errs += nerr_local;
+    }, nerr);
+    REQUIRE(nerr == 0);
+
+    arena.activate(1);
+    REQUIRE(arena.get_active() == 1);
+    Kokkos::parallel_reduce("workspace_arena_b", policy, KOKKOS_LAMBDA(const MemberType& team, int& total_errs) {
+      auto ws = wsm_b.get_workspace(team);
+      const auto v = ws.take("v");
+      const auto u = ws.take("u", 3*nk);
+      Kokkos::parallel_for(Kokkos::TeamVectorRange(team, 3*nk), [&] (int k) {
+        u(k) = 2*team.league_rank() + k;
+        if (k < nk) v(k) = k;
+      });
+      team.team_barrier();
+      int nerr_local = 0;
+      Kokkos::single(Kokkos::PerTeam(team), [&] () {
+        for (int k = 0; k < 3*nk; ++k) {
+          if (u(k) != 2*team.league_rank() + k) ++nerr_local;
+          if (k < nk && v(k) != k) ++nerr_local;
+        }
+      });
+      ws.release(u);
+      ws.release(v);
+      total_errs += nerr_local;
+    }, nerr);
+    REQUIRE(nerr == 0);
+  }
+  REQUIRE_NOTHROW(arena.validate());
+
+#ifndef NDEBUG
+  // Using both WSMs in the same kernel is a conflict, detected in debug builds
+  arena.activate(0);
+  Kokkos::parallel_for("workspace_arena_overlap", policy, KOKKOS_LAMBDA(const MemberType& team) {
+    auto ws_a = wsm_a.get_workspace(team);
+    auto ws_b = wsm_b.get_workspace(team);
+  });
+  REQUIRE_THROWS(arena.validate());
+#endif
+}
+
+} // anonymous namespace
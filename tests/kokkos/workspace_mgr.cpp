@@ -91,38 +91,578 @@ static void unittest_workspace_idx_lock()
   const int nk = 128;
 
   auto policy = TeamPolicyFactory<ExeSpace>::get_default_team_policy(ni, nk);
-  WorkspaceManager<double, Device> wsm(nk, n_slots_per_team, policy);
-
-  const auto f = KOKKOS_LAMBDA(const MemberType& team, int& err) {
-    const auto i = team.league_rank();
-    auto workspace = wsm.get_workspace(team);
-    auto v = workspace.take("v");
-    const auto tevr = Kokkos::TeamVectorRange(team, 0, nk);
-    const auto g = [&] (const int k) { v(k) = i; };
-    Kokkos::parallel_for(tevr, g);
+  for (auto assignment : {WsSlotAssignment::Default, WsSlotAssignment::FreeList}) {
+    WorkspaceManager<double, Device> wsm(nk, n_slots_per_team, policy,
+                                         WorkspaceManager<double, Device>::GPU_DEFAULT_OVERPROVISION_FACTOR(),
+                                         assignment);
+
+    const auto f = KOKKOS_LAMBDA(const MemberType& team, int& err) {
+      const auto i = team.league_rank();
+      auto workspace = wsm.get_workspace(team);
+      auto v = workspace.take("v");
+      const auto tevr = Kokkos::TeamVectorRange(team, 0, nk);
+      const auto g = [&] (const int k) { v(k) = i; };
+      Kokkos::parallel_for(tevr, g);
+      team.team_barrier();
+      // Write race, but doesn't matter. Any err > 0 is an error.
+      const auto h = [&] (const int k) { if (v(k) != i) ++err; };
+      Kokkos::parallel_for(tevr, h);
+      workspace.release(v);
+    };
+    for (int trial = 0; trial < 10; ++trial) {
+      // Failures in the buggy case (missing memory_fence in
+      // release_workspace_idx) are nondeterministic, so run this loop multiple
+      // times to increase the strength of the test. In the buggy case on a V100,
+      // I find that this test fails nearly 100% of the time.
+      int err;
+      Kokkos::parallel_reduce(policy, f, err);
+      REQUIRE(err == 0);
+    }
+  }
+}
+
+static void unittest_workspace_block_classes()
+{
+  using namespace ekat;
+
+  using WSM = WorkspaceManager<double, Device>;
+
+  const int ni = 32;
+  const int nk = 16;
+  auto policy = TeamPolicyFactory<ExeSpace>::get_default_team_policy(ni, nk);
+
+  // Three nk-sized sub-blocks and two 3*nk-sized ones
+  const std::vector<typename WSM::BlockClass> classes = { {nk, 3}, {3*nk, 2} };
+  WSM wsm(classes, policy);
+
+  REQUIRE(wsm.m_num_classes == 2);
+  REQUIRE(wsm.m_num_slots == 5);
+  REQUIRE(wsm.m_size == nk);
+  REQUIRE(wsm.m_max_used == 3);
+  REQUIRE(wsm.m_data.extent_int(1) == 3*(nk+1+WSM::m_guard) + 2*(3*nk+1+WSM::m_guard));
+  REQUIRE(size_t(WSM::get_total_bytes_needed(classes, policy)) == wsm.m_data.size()*sizeof(double));
+
+  // Smaller footprint than sizing all sub-blocks for the largest one
+  REQUIRE(WSM::get_total_bytes_needed(classes, policy) < WSM::get_total_bytes_needed(3*nk, 5, policy));
+
+  int nerr = 0;
+  Kokkos::parallel_reduce("unittest_workspace_block_classes", policy,
+                          KOKKOS_LAMBDA(const MemberType& team, int& total_errs) {
+    int nerrs_local = 0;
+    auto ws = wsm.get_workspace(team);
+
+    for (int r = 0; r < 3; ++r) {
+      // Fill the nk-sized class, then fall back to the larger one
+      Kokkos::Array<Unmanaged<view_1d<double> >, 5> v;
+      const int len[5] = {nk, nk-1, nk, nk, 3*nk};
+      v[0] = ws.take("v0", len[0]);
+      v[1] = ws.take("v1", len[1]);
+      v[2] = ws.take("v2", len[2]);
+      v[3] = ws.take("v3", len[3]);
+      v[4] = ws.take("v4", len[4]);
+
+      Kokkos::single(Kokkos::PerTeam(team), [&] () {
+        for (int w = 0; w < 5; ++w) {
+          if (v[w].extent_int(0) != len[w]) ++nerrs_local;
+          const int c = wsm.get_slot_class(wsm.get_index(v[w]));
+          if (c != (w < 3 ? 0 : 1)) ++nerrs_local;
+        }
+        if (ws.get_num_free(0) != 0) ++nerrs_local;
+        if (ws.get_num_free(1) != 0) ++nerrs_local;
+      });
+
+      // Check that sub-blocks do not overlap
+      for (int w = 0; w < 5; ++w) {
+        Kokkos::parallel_for(Kokkos::TeamVectorRange(team, len[w]), [&] (int i) {
+          v[w](i) = 1000*w + i;
+        });
+      }
+      team.team_barrier();
+      Kokkos::single(Kokkos::PerTeam(team), [&] () {
+        for (int w = 0; w < 5; ++w) {
+          for (int i = 0; i < len[w]; ++i) {
+            if (v[w](i) != 1000*w + i) ++nerrs_local;
+          }
+        }
+      });
+      team.team_barrier();
+
+      // A released sub-block of the larger class is reused for a mid-size request
+      double* const p3 = v[3].data();
+      ws.release(v[3]);
+      const auto u = ws.take("u", 2*nk);
+      Kokkos::single(Kokkos::PerTeam(team), [&] () {
+        if (u.data() != p3) ++nerrs_local;
+        if (u.extent_int(0) != 2*nk) ++nerrs_local;
+      });
+      ws.release(u);
+
+      // Sub-blocks of other types take the number of bytes into account
+      ws.release(v[1]);
+      const auto vi = ws.template take<int>("vi", 2*nk);
+      Kokkos::single(Kokkos::PerTeam(team), [&] () {
+        if (wsm.get_slot_class(wsm.template get_index<int>(vi)) != 0) ++nerrs_local;
+        if (vi.extent_int(0) != 2*nk) ++nerrs_local;
+      });
+      ws.release(vi);
+
+      if (r == 0) {
+        ws.release(v[4]);
+        ws.release(v[2]);
+        ws.release(v[0]);
+      } else {
+        ws.reset();
+      }
+      Kokkos::single(Kokkos::PerTeam(team), [&] () {
+        if (ws.get_num_free(0) != 3) ++nerrs_local;
+        if (ws.get_num_free(1) != 2) ++nerrs_local;
+      });
+
+      // The default class is still used by the other take methods
+      const auto d = ws.take("d");
+      Kokkos::single(Kokkos::PerTeam(team), [&] () {
+        if (d.extent_int(0) != nk) ++nerrs_local;
+        if (wsm.get_slot_class(wsm.get_index(d)) != 0) ++nerrs_local;
+      });
+      ws.release(d);
+      team.team_barrier();
+    }
+
+    total_errs += nerrs_local;
+    team.team_barrier();
+  }, nerr);
+
+  REQUIRE(nerr == 0);
+}
+
+static void unittest_workspace_usage()
+{
+  using namespace ekat;
+
+  using WSM = WorkspaceManager<double, Device>;
+
+  const int ni = 32;
+  const int nk = 16;
+  auto policy = TeamPolicyFactory<ExeSpace>::get_default_team_policy(ni, nk);
+
+  const std::vector<typename WSM::BlockClass> classes = { {nk, 5}, {3*nk, 2} };
+
+  // Usage is only available if tracked
+  {
+    WSM wsm(classes, policy);
+    REQUIRE_THROWS(wsm.get_usage_summary());
+  }
+
+  WSM wsm(classes, policy, WSM::GPU_DEFAULT_OVERPROVISION_FACTOR(), WsSlotAssignment::Default, true);
+
+  // Use at most 3 nk-sized sub-blocks and 1 3*nk-sized one at once
+  Kokkos::parallel_for("unittest_workspace_usage", policy, KOKKOS_LAMBDA(const MemberType& team) {
+    auto ws = wsm.get_workspace(team);
+    for (int r = 0; r < 2; ++r) {
+      const auto a = ws.take("a");
+      const auto b = ws.take("b", nk-1);
+      const auto c = ws.take("c", 3*nk);
+      ws.release(b);
+      const auto d = ws.take("d");
+      const auto e = ws.take("e");
+      ws.release(c);
+      ws.release(a);
+      ws.release(d);
+      ws.release(e);
+    }
+  });
+  Kokkos::fence();
+
+  auto summary = wsm.get_usage_summary();
+  REQUIRE(summary.num_ws == wsm.m_max_ws_idx);
+  REQUIRE(summary.classes.size() == 2);
+  REQUIRE(summary.classes[0].size == nk);
+  REQUIRE(summary.classes[0].max_used == 5);
+  REQUIRE(summary.classes[0].high_water == 3);
+  REQUIRE(summary.classes[1].size == 3*nk);
+  REQUIRE(summary.classes[1].max_used == 2);
+  REQUIRE(summary.classes[1].high_water == 1);
+  for (int c = 0; c < 2; ++c) {
+    REQUIRE(summary.classes[c].ws_high_water.size() == size_t(wsm.m_max_ws_idx));
+    for (const int hw : summary.classes[c].ws_high_water) {
+      REQUIRE(hw <= summary.classes[c].high_water);
+    }
+  }
+
+  const auto fitted = summary.get_fitted_classes();
+  REQUIRE(fitted.size() == 2);
+  REQUIRE((fitted[0].size == nk && fitted[0].max_used == 3));
+  REQUIRE((fitted[1].size == 3*nk && fitted[1].max_used == 1));
+  REQUIRE(WSM::get_total_bytes_needed(fitted, policy) < WSM::get_total_bytes_needed(classes, policy));
+
+  // High-water marks survive reset_internals, and count bulk takes too
+  wsm.reset_internals();
+  Kokkos::parallel_for("unittest_workspace_usage", policy, KOKKOS_LAMBDA(const MemberType& team) {
+    auto ws = wsm.get_workspace(team);
+    Unmanaged<view_1d<double> > v0, v1, v2, v3;
+    Kokkos::Array<Unmanaged<view_1d<double> >*, 4> ptrs = { {&v0, &v1, &v2, &v3} };
+    Kokkos::Array<const char*, 4> names = { {"v0", "v1", "v2", "v3"} };
+    ws.take_many_and_reset(names, ptrs);
+    ws.reset();
+    const auto a = ws.take("a");
+    ws.release(a);
+  });
+  Kokkos::fence();
+
+  summary = wsm.get_usage_summary();
+  REQUIRE(summary.classes[0].high_water == 4);
+  REQUIRE(summary.classes[1].high_water == 1);
+
+  // Nothing is in use at the end
+  const auto usage_h = Kokkos::create_mirror_view(wsm.m_usage);
+  Kokkos::deep_copy(usage_h, wsm.m_usage);
+  for (int t = 0; t < wsm.m_max_ws_idx; ++t) {
+    for (int c = 0; c < 2; ++c) {
+      REQUIRE(usage_h(t, c, 0) == 0);
+    }
+  }
+}
+
+static void unittest_workspace_scoped()
+{
+  using namespace ekat;
+
+  using WSM = WorkspaceManager<double, Device>;
+
+  const int ni = 32;
+  const int nk = 16;
+  const int n_slots = 4;
+  auto policy = TeamPolicyFactory<ExeSpace>::get_default_team_policy(ni, nk);
+
+  WSM wsm({ {nk, n_slots}, {2*nk, 1} }, policy);
+
+  int nerr = 0;
+  Kokkos::parallel_reduce("unittest_workspace_scoped", policy,
+                          KOKKOS_LAMBDA(const MemberType& team, int& total_errs) {
+    int nerrs_local = 0;
+    auto ws = wsm.get_workspace(team);
+    const auto count_free = [&] (const int c, const int expected) {
+      Kokkos::single(Kokkos::PerTeam(team), [&] () {
+        if (ws.get_num_free(c) != expected) ++nerrs_local;
+      });
+      team.team_barrier();
+    };
+
+    const int first = wsm.get_index(ws.take_scoped("first").view());
+    count_free(0, n_slots);
+
+    for (int r = 0; r < 2; ++r) {
+      {
+        const auto a = ws.take_scoped("a");
+        count_free(0, n_slots-1);
+        {
+          auto b = ws.take_scoped("b", 2*nk);
+          const auto b2 = std::move(b);
+          count_free(1, 0);
+          Kokkos::parallel_for(Kokkos::TeamVectorRange(team, b2.size()), [&] (int k) {
+            b2(k) = a.size() + k;
+          });
+          team.team_barrier();
+          Kokkos::single(Kokkos::PerTeam(team), [&] () {
+            if (b2.size() != 2*nk) ++nerrs_local;
+            if (b2.data() != b2.view().data()) ++nerrs_local;
+            for (int k = 0; k < 2*nk; ++k) {
+              if (b2(k) != nk + k) ++nerrs_local;
+            }
+          });
+        }
+        // The moved-from b did not release twice
+        count_free(1, 1);
+
+        const auto m = ws.template take_scoped_many<3>({"m0", "m1", "m2"});
+        count_free(0, 0);
+        Kokkos::single(Kokkos::PerTeam(team), [&] () {
+          for (int n = 0; n < m.size(); ++n) {
+            for (int k = 0; k < nk; ++k) m[n](k) = 100*n + k;
+          }
+          for (int n = 0; n < m.size(); ++n) {
+            for (int k = 0; k < nk; ++k) {
+              if (m[n](k) != 100*n + k) ++nerrs_local;
+            }
+          }
+        });
+        team.team_barrier();
+      }
+      // Releasing in reverse order restores the free list
+      count_free(0, n_slots);
+      {
+        // All threads of the team create and destroy the scoped block
+        const auto s = ws.take_scoped("second");
+        Kokkos::single(Kokkos::PerTeam(team), [&] () {
+          if (wsm.get_index(s.view()) != first) ++nerrs_local;
+        });
+        team.team_barrier();
+      }
+
+      {
+        const auto m = ws.template take_scoped_many_and_reset<n_slots>({"r0", "r1", "r2", "r3"});
+        count_free(0, 0);
+        Kokkos::single(Kokkos::PerTeam(team), [&] () {
+          for (int n = 0; n < n_slots; ++n) {
+            if (wsm.get_index(m[n]) != n) ++nerrs_local;
+          }
+        });
+        team.team_barrier();
+      }
+      count_free(0, n_slots);
+      count_free(1, 1);
+    }
+
+    total_errs += nerrs_local;
     team.team_barrier();
-    // Write race, but doesn't matter. Any err > 0 is an error.
-    const auto h = [&] (const int k) { if (v(k) != i) ++err; };
-    Kokkos::parallel_for(tevr, h);
-    workspace.release(v);
-  };
-  for (int trial = 0; trial < 10; ++trial) {
-    // Failures in the buggy case (missing memory_fence in
-    // release_workspace_idx) are nondeterministic, so run this loop multiple
-    // times to increase the strength of the test. In the buggy case on a V100,
-    // I find that this test fails nearly 100% of the time.
-    int err;
-    Kokkos::parallel_reduce(policy, f, err);
-    REQUIRE(err == 0);
+  }, nerr);
+
+  REQUIRE(nerr == 0);
+}
+
+static void unittest_workspace_nd()
+{
+  using namespace ekat;
+
+  using WSM = WorkspaceManager<double, Device>;
+
+  const int ni = 32;
+  const int nk = 16;
+  const int n_slots = 8;
+  auto policy = TeamPolicyFactory<ExeSpace>::get_default_team_policy(ni, nk);
+
+  WSM wsm(nk, n_slots, policy);
+
+  // Rows of ints are padded to a whole number of doubles
+  REQUIRE(WSM::template get_padded_len<int>(5) == 6);
+  REQUIRE(WSM::template get_padded_len<int>(6) == 6);
+  REQUIRE(WSM::template get_padded_len<double>(5) == 5);
+  // 2 contiguous sub-blocks hold 2*nk+1 doubles, since the metadata of the 2nd one
+  // (and the canary of the 1st one, see EKAT_WSM_GUARD) is usable too
+  REQUIRE(wsm.template get_num_sub_blocks<double>(2*nk+1+WSM::m_guard) == 2);
+  REQUIRE(wsm.template get_num_sub_blocks<double>(2*nk+2+WSM::m_guard) == 3);
+  REQUIRE(wsm.template get_num_sub_blocks<int>(2*nk) == 1);
+
+  int nerr = 0;
+  Kokkos::parallel_reduce("unittest_workspace_nd", policy,
+                          KOKKOS_LAMBDA(const MemberType& team, int& total_errs) {
+    int nerrs_local = 0;
+    auto ws = wsm.get_workspace(team);
+
+    for (int r = 0; r < 2; ++r) {
+      const auto a = ws.take_2d("a", 3, 10);
+      const auto b = ws.template take_3d<int>("b", 2, 3, 5);
+      const auto c = ws.take("c");
+
+      Kokkos::single(Kokkos::PerTeam(team), [&] () {
+        if (a.extent_int(0) != 3 || a.extent_int(1) != 10) ++nerrs_local;
+        if (b.extent_int(0) != 2 || b.extent_int(1) != 3 || b.extent_int(2) != 6) ++nerrs_local;
+        // a spans slots 0-1, b slots 2-3
+        if (wsm.get_index(Unmanaged<view_1d<double> >(a.data(), 1)) != 0) ++nerrs_local;
+        if (wsm.template get_index<int>(Unmanaged<view_1d<int> >(b.data(), 1)) != 2) ++nerrs_local;
+        if (wsm.get_index(c) != 4) ++nerrs_local;
+        if (ws.get_num_free(0) != n_slots-5) ++nerrs_local;
+
+        // Check that the views do not overlap
+        for (int i = 0; i < 3; ++i) for (int j = 0; j < 10; ++j) a(i,j) = 100*i + j;
+        for (int i = 0; i < 2; ++i) for (int j = 0; j < 3; ++j) for (int k = 0; k < 6; ++k) b(i,j,k) = -(100*i + 10*j + k);
+        for (int k = 0; k < nk; ++k) c(k) = 0.5 + k;
+        for (int i = 0; i < 3; ++i) for (int j = 0; j < 10; ++j) if (a(i,j) != 100*i + j) ++nerrs_local;
+        for (int i = 0; i < 2; ++i) for (int j = 0; j < 3; ++j) for (int k = 0; k < 6; ++k) {
+          if (b(i,j,k) != -(100*i + 10*j + k)) ++nerrs_local;
+        }
+        for (int k = 0; k < nk; ++k) if (c(k) != 0.5 + k) ++nerrs_local;
+      });
+      team.team_barrier();
+
+      ws.release(c);
+      ws.release(b);
+      ws.release(a);
+      Kokkos::single(Kokkos::PerTeam(team), [&] () {
+        if (ws.get_num_free(0) != n_slots) ++nerrs_local;
+      });
+      team.team_barrier();
+    }
+
+    total_errs += nerrs_local;
+    team.team_barrier();
+  }, nerr);
+
+  REQUIRE(nerr == 0);
+}
+
+static void unittest_workspace_team_scratch()
+{
+  using namespace ekat;
+
+  using WSM = WorkspaceManager<double, Device>;
+
+  const int ni = 32;
+  const int nk = 16;
+  const int n_slots = 4;
+  auto policy = TeamPolicyFactory<ExeSpace>::get_default_team_policy(ni, nk);
+
+  const std::vector<typename WSM::BlockClass> classes = { {nk, n_slots}, {3*nk, 2} };
+  WSM wsm(classes, policy, WSM::GPU_DEFAULT_OVERPROVISION_FACTOR(), WsSlotAssignment::Default, true);
+  REQUIRE(not wsm.uses_team_scratch());
+  REQUIRE(wsm.get_team_scratch_size() >= WSM::get_row_length(classes)*sizeof(double) + 2*sizeof(int));
+
+  REQUIRE(wsm.use_team_scratch(policy));
+  REQUIRE(wsm.uses_team_scratch());
+  REQUIRE(wsm.m_data.size() == 0);
+
+  // Each team starts with a fresh workspace, also in the second kernel, even
+  // though the first one did not release everything.
+  for (int r = 0; r < 2; ++r) {
+    int nerr = 0;
+    Kokkos::parallel_reduce("unittest_workspace_team_scratch", policy,
+                            KOKKOS_LAMBDA(const MemberType& team, int& total_errs) {
+      int nerrs_local = 0;
+      auto ws = wsm.get_workspace(team);
+
+      Kokkos::single(Kokkos::PerTeam(team), [&] () {
+        if (ws.get_num_free(0) != n_slots || ws.get_num_free(1) != 2) ++nerrs_local;
+      });
+      team.team_barrier();
+
+      const auto a = ws.take("a");
+      const auto b = ws.take("b", 3*nk);
+      const auto c = ws.take("c");
+      Kokkos::parallel_for(Kokkos::TeamVectorRange(team, 3*nk), [&] (int k) {
+        b(k) = team.league_rank() - k;
+        if (k < nk) {
+          a(k) = team.league_rank() + k;
+          c(k) = -a(k);
+        }
+      });
+      team.team_barrier();
+
+      Kokkos::single(Kokkos::PerTeam(team), [&] () {
+        for (int k = 0; k < 3*nk; ++k) {
+          if (b(k) != team.league_rank() - k) ++nerrs_local;
+          if (k < nk && (a(k) != team.league_rank() + k || c(k) != -a(k))) ++nerrs_local;
+        }
+        if (ws.get_num_free(0) != n_slots-2 || ws.get_num_free(1) != 1) ++nerrs_local;
+      });
+      team.team_barrier();
+
+      ws.release(c);
+      ws.release(a);
+      total_errs += nerrs_local;
+    }, nerr);
+    REQUIRE(nerr == 0);
   }
+
+  // Usage is tracked in team scratch mode too
+  const auto summary = wsm.get_usage_summary();
+  REQUIRE(summary.classes[0].high_water == 2);
+  REQUIRE(summary.classes[1].high_water == 1);
+
+  // A workspace too large for the team scratch memory stays in global memory
+  auto policy_large = TeamPolicyFactory<ExeSpace>::get_default_team_policy(ni, nk);
+  const int nk_large = WSM::TeamPolicy::scratch_size_max(0)/sizeof(double) + 1;
+  WSM wsm_large(nk_large, 1, policy_large);
+  REQUIRE(not wsm_large.use_team_scratch(policy_large));
+  REQUIRE(not wsm_large.uses_team_scratch());
+  REQUIRE(wsm_large.m_data.size() > 0);
+
+  int nerr = 0;
+  Kokkos::parallel_reduce("unittest_workspace_team_scratch_large", policy_large,
+                          KOKKOS_LAMBDA(const MemberType& team, int& total_errs) {
+    auto ws = wsm_large.get_workspace(team);
+    const auto a = ws.take("a");
+    int nerrs_local = 0;
+    Kokkos::single(Kokkos::PerTeam(team), [&] () {
+      a(nk_large-1) = team.league_rank();
+      if (a(nk_large-1) != team.league_rank()) ++nerrs_local;
+    });
+    ws.release(a);
+    total_errs += nerrs_local;
+  }, nerr);
+  REQUIRE(nerr == 0);
 }
 
+#ifdef EKAT_WSM_GUARD
+static void unittest_workspace_guard()
+{
+  using namespace ekat;
+
+  using WSM = WorkspaceManager<double, Device>;
+
+  const int ni = 32;
+  const int nk = 16;
+  auto policy = TeamPolicyFactory<ExeSpace>::get_default_team_policy(ni, nk);
+
+  const std::vector<typename WSM::BlockClass> classes = { {nk, 4}, {3*nk, 2} };
+  WSM wsm(classes, policy);
+  REQUIRE(WSM::m_guard == 1);
+
+  int nerr = 0;
+  Kokkos::parallel_reduce("unittest_workspace_guard", policy,
+                          KOKKOS_LAMBDA(const MemberType& team, int& total_errs) {
+    int nerrs_local = 0;
+    auto ws = wsm.get_workspace(team);
+
+    for (int r = 0; r < 2; ++r) {
+      const auto a = ws.take("a");
+      const auto b = ws.take("b", 2*nk);
+      const auto c = ws.template take_2d<int>("c", 2, nk);
+      Kokkos::single(Kokkos::PerTeam(team), [&] () {
+        // Taken sub-blocks are poisoned, also in the 2nd iteration, after being written
+        for (int k = 0; k < nk; ++k) {
+          if (!Kokkos::isnan(a(k))) ++nerrs_local;
+          if (c(0,k) != invalid<int>() || c(1,k) != invalid<int>()) ++nerrs_local;
+        }
+        for (int k = 0; k < 2*nk; ++k) {
+          if (!Kokkos::isnan(b(k))) ++nerrs_local;
+        }
+        if (!wsm.is_canary_intact(a.data(), 0) || !wsm.is_canary_intact(b.data(), 1)) ++nerrs_local;
+
+        for (int k = 0; k < nk; ++k) {
+          a(k) = k;
+          c(0,k) = c(1,k) = k;
+        }
+        for (int k = 0; k < 3*nk; ++k) {
+          // Writing past nelems, but within the class size, is not detected
+          b.data()[k] = k;
+        }
+        if (!wsm.is_canary_intact(a.data(), 0) || !wsm.is_canary_intact(b.data(), 1)) ++nerrs_local;
+
+        // Writing past the end of a sub-block is
+        a.data()[nk] = 0;
+        if (wsm.is_canary_intact(a.data(), 0)) ++nerrs_local;
+        wsm.set_canary(a.data(), 0);
+        if (!wsm.is_canary_intact(a.data(), 0)) ++nerrs_local;
+      });
+      team.team_barrier();
+
+      ws.release(c);
+      ws.release(b);
+      ws.release(a);
+    }
+
+    total_errs += nerrs_local;
+    team.team_barrier();
+  }, nerr);
+
+  REQUIRE(nerr == 0);
+}
+#endif
+
 static void unittest_workspace()
 {
   using namespace ekat;
 
   unittest_workspace_overprovision();
   unittest_workspace_idx_lock();
+  unittest_workspace_block_classes();
+  unittest_workspace_usage();
+  unittest_workspace_scoped();
+  unittest_workspace_nd();
+  unittest_workspace_team_scratch();
+#ifdef EKAT_WSM_GUARD
+  unittest_workspace_guard();
+#endif
 
   static constexpr const int n_slots_per_team = 4;
   const int ni = 128;
@@ -0,0 +1,268 @@
+#include "ekat_workspace.hpp"
+#include "ekat_kokkos_session.hpp"
+#include "ekat_kokkos_types.hpp"
+#include "ekat_test_utils.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+/*
+ * Throughput benchmark for the take/release APIs of WorkspaceManager.
+ *
+ * Each team of the policy gets its workspace, takes k sub-blocks of n doubles
+ * with one of the APIs below, writes and reads all their entries, and releases
+ * them. The time per sub-block (take + write + read + release, averaged over
+ * the whole league) and the effective bandwidth (the bytes written and read,
+ * over the kernel time) are reported for
+ *
+ *   get_workspace:         only get_workspace, no sub-blocks taken (the baseline)
+ *   take_release:          k take calls, then k release calls
+ *   take_many:             one take_many call, then k release calls
+ *   take_many_contiguous:  take_many_contiguous_unsafe, then release_many_contiguous
+ *   take_many_and_reset:   one take_many_and_reset call, and no release
+ *   take_macro_block:      take_macro_block of k sub-blocks, then release_macro_block
+ *
+ * The exec space is the default one, so build with the Serial or OpenMP backend
+ * (and run with several threads) to compare them. Besides a human readable table,
+ * the results can be printed as CSV or JSON (-f csv|json), for regression tracking.
+ *
+ * Usage: workspace_perf [-l|--league L] [-t|--team-size T] [-n|--size N]
+ *                       [-k|--ntakes 1|2|4|8|16] [-r|--nrep R] [-f|--format table|csv|json]
+ */
+
+namespace ekat {
+namespace test {
+namespace perf {
+
+struct Input {
+  int league = 10000;
+  int team_size = 1;
+  int size = 128;
+  int ntakes = 4;
+  int nrep = 10;
+  std::string format = "table";
+
+  bool parse (int argc, char** argv) {
+    for (int i = 1; i < argc; ++i) {
+      if (argv_matches(argv[i], "-l", "--league")) {
+        if (i == argc-1) return false;
+        league = std::atoi(argv[++i]);
+      } else if (argv_matches(argv[i], "-t", "--team-size")) {
+        if (i == argc-1) return false;
+        team_size = std::atoi(argv[++i]);
+      } else if (argv_matches(argv[i], "-n", "--size")) {
+        if (i == argc-1) return false;
+        size = std::atoi(argv[++i]);
+      } else if (argv_matches(argv[i], "-k", "--ntakes")) {
+        if (i == argc-1) return false;
+        ntakes = std::atoi(argv[++i]);
+      } else if (argv_matches(argv[i], "-r", "--nrep")) {
+        if (i == argc-1) return false;
+        nrep = std::atoi(argv[++i]);
+      } else if (argv_matches(argv[i], "-f", "--format")) {
+        if (i == argc-1) return false;
+        format = argv[++i];
+      } else {
+        std::cout << "Unexpected arg: " << argv[i] << "\n";
+        return false;
+      }
+    }
+    const bool valid_ntakes = ntakes==1 or ntakes==2 or ntakes==4 or ntakes==8 or ntakes==16;
+    const bool valid_format = format=="table" or format=="csv" or format=="json";
+    return league>0 and team_size>0 and size>0 and valid_ntakes and nrep>0 and valid_format;
+  }
+};
+
+// Sub-block names, built on device, so that debug builds can read them
+template <int K>
+KOKKOS_INLINE_FUNCTION
+Kokkos::Array<const char*, K> get_names () {
+  Kokkos::Array<const char*, K> names;
+  for (int i = 0; i < K; ++i) {
+    names[i] = "w";
+  }
+  return names;
+}
+
+struct Result {
+  std::string api;
+  double ns_per_op;
+  double gbps;
+  double chk;
+};
+
+template <int K>
+void run (const Input& in) {
+  using clock = std::chrono::steady_clock;
+  using ExeSpace = typename DefaultDevice::execution_space;
+  using WSM = WorkspaceManager<double, DefaultDevice>;
+  using MemberType = typename WSM::MemberType;
+  using view_t = Unmanaged<typename WSM::template view_1d<double> >;
+
+  const auto policy = TeamPolicyFactory<ExeSpace>::get_team_policy_force_team_size(in.league, in.team_size);
+  WSM wsm(in.size, K, policy);
+  const int n = in.size;
+
+  // Write and read the nelems entries at p, and return their sum
+  const auto touch = KOKKOS_LAMBDA (const MemberType& team, double* p, const int nelems) {
+    Kokkos::parallel_for(Kokkos::TeamVectorRange(team, nelems), [&] (int k) {
+      p[k] = k + team.league_rank();
+    });
+    team.team_barrier();
+    double sum = 0;
+    Kokkos::parallel_reduce(Kokkos::TeamVectorRange(team, nelems), [&] (int k, double& lsum) {
+      lsum += p[k];
+    }, sum);
+    return sum;
+  };
+
+  std::vector<Result> results;
+
+  // Time kernel f over the whole league, starting from a clean WSM every time
+  const auto time_op = [&] (const char* api, const int ntaken, const auto& f) {
+    double chk = 0;
+    wsm.reset_internals();
+    Kokkos::parallel_reduce(policy, f, chk);
+    Kokkos::fence();
+    double elapsed = 0;
+    for (int r = 0; r < in.nrep; ++r) {
+      wsm.reset_internals();
+      Kokkos::fence();
+      const auto t0 = clock::now();
+      Kokkos::parallel_reduce(policy, f, chk);
+      Kokkos::fence();
+      const auto t1 = clock::now();
+      elapsed += std::chrono::duration<double,std::nano>(t1-t0).count();
+    }
+    const double nops = double(in.nrep)*in.league*(ntaken > 0 ? ntaken : 1);
+    const double bytes = 2.0*in.nrep*in.league*ntaken*n*sizeof(double);
+    results.push_back({api, elapsed/nops, bytes/elapsed, chk});
+  };
+
+  time_op("get_workspace", 0, KOKKOS_LAMBDA (const MemberType& team, double& total) {
+    auto ws = wsm.get_workspace(team);
+    if (team.team_rank() == 0) total += 1;
+  });
+
+  time_op("take_release", K, KOKKOS_LAMBDA (const MemberType& team, double& total) {
+    auto ws = wsm.get_workspace(team);
+    view_t v[K];
+    double sum = 0;
+    for (int i = 0; i < K; ++i) {
+      v[i] = ws.take("w");
+      sum += touch(team, v[i].data(), n);
+    }
+    for (int i = K-1; i >= 0; --i) {
+      ws.release(v[i]);
+    }
+    if (team.team_rank() == 0) total += sum;
+  });
+
+  time_op("take_many", K, KOKKOS_LAMBDA (const MemberType& team, double& total) {
+    auto ws = wsm.get_workspace(team);
+    view_t v[K];
+    typename WSM::template view_1d_ptr_array<double, K> ptrs;
+    for (int i = 0; i < K; ++i) ptrs[i] = &v[i];
+    ws.take_many(get_names<K>(), ptrs);
+    double sum = 0;
+    for (int i = 0; i < K; ++i) {
+      sum += touch(team, v[i].data(), n);
+    }
+    for (int i = K-1; i >= 0; --i) {
+      ws.release(v[i]);
+    }
+    if (team.team_rank() == 0) total += sum;
+  });
+
+  time_op("take_many_contiguous", K, KOKKOS_LAMBDA (const MemberType& team, double& total) {
+    auto ws = wsm.get_workspace(team);
+    view_t v[K];
+    typename WSM::template view_1d_ptr_array<double, K> ptrs;
+    for (int i = 0; i < K; ++i) ptrs[i] = &v[i];
+    ws.take_many_contiguous_unsafe(get_names<K>(), ptrs);
+    double sum = 0;
+    for (int i = 0; i < K; ++i) {
+      sum += touch(team, v[i].data(), n);
+    }
+    ws.release_many_contiguous(ptrs);
+    if (team.team_rank() == 0) total += sum;
+  });
+
+  time_op("take_many_and_reset", K, KOKKOS_LAMBDA (const MemberType& team, double& total) {
+    auto ws = wsm.get_workspace(team);
+    view_t v[K];
+    typename WSM::template view_1d_ptr_array<double, K> ptrs;
+    for (int i = 0; i < K; ++i) ptrs[i] = &v[i];
+    ws.take_many_and_reset(get_names<K>(), ptrs);
+    double sum = 0;
+    for (int i = 0; i < K; ++i) {
+      sum += touch(team, v[i].data(), n);
+    }
+    if (team.team_rank() == 0) total += sum;
+  });
+
+  time_op("take_macro_block", K, KOKKOS_LAMBDA (const MemberType& team, double& total) {
+    auto ws = wsm.get_workspace(team);
+    const auto v = ws.take_macro_block("m", K);
+    const double sum = touch(team, v.data(), K*n);
+    ws.release_macro_block(v, K);
+    if (team.team_rank() == 0) total += sum;
+  });
+
+  const char* exe_space = ExeSpace::name();
+  const int concurrency = ExeSpace().concurrency();
+  const int team_size = policy.team_size();
+  if (in.format == "csv") {
+    printf("exe_space,concurrency,league,team_size,size,ntakes,nrep,api,ns_per_op,gbps,chk\n");
+    for (const auto& r : results) {
+      printf("%s,%d,%d,%d,%d,%d,%d,%s,%.4f,%.4f,%g\n", exe_space, concurrency, in.league, team_size,
+             n, K, in.nrep, r.api.c_str(), r.ns_per_op, r.gbps, r.chk);
+    }
+  } else if (in.format == "json") {
+    printf("{\n  \"exe_space\": \"%s\", \"concurrency\": %d, \"league\": %d, \"team_size\": %d,\n"
+           "  \"size\": %d, \"ntakes\": %d, \"nrep\": %d,\n  \"results\": [\n",
+           exe_space, concurrency, in.league, team_size, n, K, in.nrep);
+    for (size_t i = 0; i < results.size(); ++i) {
+      const auto& r = results[i];
+      printf("    {\"api\": \"%s\", \"ns_per_op\": %.4f, \"gbps\": %.4f, \"chk\": %g}%s\n",
+             r.api.c_str(), r.ns_per_op, r.gbps, r.chk, i+1 < results.size() ? "," : "");
+    }
+    printf("  ]\n}\n");
+  } else {
+    printf("workspace_perf: exe space %s, concurrency %d, league %d, team size %d, size %d, ntakes %d, nrep %d\n",
+           exe_space, concurrency, in.league, team_size, n, K, in.nrep);
+    printf("  %-22s %12s %10s   (ns/sub-block, GB/s)\n", "api", "time", "bandwidth");
+    for (const auto& r : results) {
+      printf("  %-22s %12.4f %10.4f  (chk %g)\n", r.api.c_str(), r.ns_per_op, r.gbps, r.chk);
+    }
+  }
+}
+
+} // namespace perf
+} // namespace test
+} // namespace ekat
+
+int main (int argc, char** argv) {
+  ekat::test::perf::Input in;
+  if (not in.parse(argc,argv)) {
+    std::cout << "Usage: " << argv[0] << " [-l|--league L] [-t|--team-size T] [-n|--size N]"
+              << " [-k|--ntakes 1|2|4|8|16] [-r|--nrep R] [-f|--format table|csv|json]\n";
+    return 1;
+  }
+
+  ekat::initialize_kokkos_session(false); {
+    switch (in.ntakes) {
+      case 1:  ekat::test::perf::run<1>(in);  break;
+      case 2:  ekat::test::perf::run<2>(in);  break;
+      case 4:  ekat::test::perf::run<4>(in);  break;
+      case 8:  ekat::test::perf::run<8>(in);  break;
+      case 16: ekat::test::perf::run<16>(in); break;
+    }
+  } ekat::finalize_kokkos_session();
+
+  return 0;
+}
@@ -5,7 +5,10 @@
 #include "ekat_kokkos_types.hpp"
 #include "ekat_test_config.h"
 
+#include <cmath>
+#include <limits>
 #include <sstream>
+#include <vector>
 
 namespace {
 
@@ -27,6 +30,8 @@ struct TestMask {
     ekat_masked_loop(m, s) ++sum1;
     ekat_masked_loop_no_vec(m, s) ++sum2;
     REQUIRE(sum1 == sum2);
+    REQUIRE(m.count() == sum1);
+    REQUIRE(m.all() == (sum1 == Mask::n));
     return sum1;
   }
 
@@ -67,6 +72,8 @@ struct TestMask {
       REQUIRE(sum_true(m1 || m2) == Mask::n / 2);
       REQUIRE(sum_true(m1 && ! m2) == 0);
       REQUIRE(sum_true(m1 || ! m2) == Mask::n);
+      REQUIRE(m1 == m2);
+      REQUIRE(!(m1 == !m2));
     }
   }
 };
@@ -244,6 +251,25 @@ struct TestPack {
     }
   }
 
+  static void test_shift () {
+    const auto a = ekat::range<Pack>(0);
+    const auto b = ekat::range<Pack>(Pack::n);
+    const auto r  = ekat::shift_right(a,b);
+    const auto rs = ekat::shift_right(scalar(-1),b);
+    const auto l  = ekat::shift_left(b,a);
+    const auto ls = ekat::shift_left(scalar(-1),a);
+    REQUIRE(r[0] == a[Pack::n-1]);
+    REQUIRE(rs[0] == -1);
+    REQUIRE(l[Pack::n-1] == b[0]);
+    REQUIRE(ls[Pack::n-1] == -1);
+    vector_novec for (int i = 1; i < Pack::n; ++i) {
+      REQUIRE(r[i] == b[i-1]);
+      REQUIRE(rs[i] == b[i-1]);
+      REQUIRE(l[i-1] == a[i]);
+      REQUIRE(ls[i-1] == a[i]);
+    }
+  }
+
   static void test_range () {
     const auto p = ekat::range<Pack>(42);
     vector_novec for (int i = 0; i < Pack::n; ++i)
@@ -279,6 +305,114 @@ struct TestPack {
     }
   }
 
+  // Reference tree reduction, combining the first and second half of the values at each level
+  template<typename Op>
+  static scalar tree_ref (std::vector<scalar> v, const Op& op) {
+    while (v.size()>1) {
+      const int m = v.size(), h = (m+1)/2;
+      for (int i=0; i<m-h; ++i) v[i] = op(v[i],v[i+h]);
+      v.resize(h);
+    }
+    return v[0];
+  }
+
+  template<bool Serialize>
+  static void test_reductions () {
+    using ekat::impl::min;
+    using ekat::impl::max;
+    const auto sum  = [](const scalar a, const scalar b) { return a+b; };
+    const auto prod = [](const scalar a, const scalar b) { return a*b; };
+    const auto mn   = [](const scalar a, const scalar b) { return min(a,b); };
+    const auto mx   = [](const scalar a, const scalar b) { return max(a,b); };
+    const auto ref = [&](const std::vector<scalar>& v, const auto& op, const scalar id) {
+      if (v.size()==0) return id;
+      if (Serialize) {
+        scalar r = v[0];
+        for (size_t i=1; i<v.size(); ++i) r = op(r,v[i]);
+        return r;
+      }
+      return tree_ref(v,op);
+    };
+
+    Pack p;
+    Mask m;
+    for (int i=0; i<Pack::n; ++i) {
+      // Values s.t. the product does not overflow, and sums are not exact for floats
+      p[i] = (i%3==0 ? scalar(-2) : scalar(1)) * scalar(Pack::n-i) / scalar(3-(i%2));
+      m.set(i,i%3!=1);
+    }
+
+    std::vector<scalar> all, active;
+    for (int i=0; i<Pack::n; ++i) {
+      all.push_back(p[i]);
+      if (m[i]) active.push_back(p[i]);
+    }
+    // The tree reduction of the masked versions includes all slots, with the
+    // inactive ones replaced by the identity of the op
+    const auto ref_masked = [&](const auto& op, const scalar id) {
+      if (Serialize) return ref(active,op,id);
+      std::vector<scalar> v;
+      for (int i=0; i<Pack::n; ++i) v.push_back(m[i] ? p[i] : id);
+      return tree_ref(v,op);
+    };
+    const scalar inf = std::numeric_limits<scalar>::has_infinity ? std::numeric_limits<scalar>::infinity()
+                                                                 : std::numeric_limits<scalar>::max();
+    const scalar ninf = std::numeric_limits<scalar>::has_infinity ? -inf : std::numeric_limits<scalar>::lowest();
+
+    // The results must match the reference *exactly*, in the order selected
+    // by Serialize, and regardless of the backend.
+    REQUIRE (ekat::reduce_sum<Serialize>(p)==ref(all,sum,0));
+    REQUIRE (ekat::reduce_prod<Serialize>(p)==ref(all,prod,1));
+    REQUIRE (ekat::reduce_min<Serialize>(p)==ref(all,mn,0));
+    REQUIRE (ekat::reduce_max<Serialize>(p)==ref(all,mx,0));
+
+    REQUIRE (ekat::reduce_sum<Serialize>(m,p)==ref_masked(sum,-scalar(0)));
+    REQUIRE (ekat::reduce_prod<Serialize>(m,p)==ref_masked(prod,1));
+    REQUIRE (ekat::reduce_min<Serialize>(m,scalar(100),p)==min(scalar(100),ref_masked(mn,inf)));
+    REQUIRE (ekat::reduce_max<Serialize>(m,scalar(-100),p)==max(scalar(-100),ref_masked(mx,ninf)));
+    scalar s = 1;
+    ekat::reduce_sum<Serialize>(m,p,s);
+    if (Serialize) {
+      scalar r = 1;
+      for (const auto v : active) r += v;
+      REQUIRE (s==r);
+    } else {
+      REQUIRE (s==scalar(1)+ref_masked(sum,-scalar(0)));
+    }
+
+    // No active slot: return the identity (or init)
+    const Mask none(false);
+    REQUIRE (ekat::reduce_sum<Serialize>(none,p)==0);
+    REQUIRE (ekat::reduce_prod<Serialize>(none,p)==1);
+    REQUIRE (ekat::reduce_min<Serialize>(none,scalar(7),p)==7);
+    REQUIRE (ekat::reduce_max<Serialize>(none,scalar(-7),p)==-7);
+
+    // min/max are exact, so the order does not matter (w/o NaNs)
+    REQUIRE (ekat::reduce_min<Serialize>(p)==ekat::reduce_min<!Serialize>(p));
+    REQUIRE (ekat::reduce_max<Serialize>(p)==ekat::reduce_max<!Serialize>(p));
+    REQUIRE (min(p)==ekat::reduce_min<Serialize>(p));
+    REQUIRE (max(p)==ekat::reduce_max<Serialize>(p));
+
+    if constexpr (std::is_floating_point<scalar>::value) {
+      // Inactive NaN/Inf slots do not affect the masked reductions
+      Pack q = p;
+      for (int i=0; i<Pack::n; ++i) {
+        if (not m[i]) q[i] = (i%2==0 ? std::numeric_limits<scalar>::quiet_NaN()
+                                     : std::numeric_limits<scalar>::infinity());
+      }
+      REQUIRE (ekat::reduce_sum<Serialize>(m,q)==ekat::reduce_sum<Serialize>(m,p));
+      REQUIRE (ekat::reduce_prod<Serialize>(m,q)==ekat::reduce_prod<Serialize>(m,p));
+      REQUIRE (ekat::reduce_min<Serialize>(m,scalar(100),q)==ekat::reduce_min<Serialize>(m,scalar(100),p));
+      REQUIRE (ekat::reduce_max<Serialize>(m,scalar(-100),q)==ekat::reduce_max<Serialize>(m,scalar(-100),p));
+
+      // ... and infinite active slots are not lost
+      q = p;
+      q[0] = std::numeric_limits<scalar>::infinity();
+      REQUIRE (ekat::reduce_max<Serialize>(Mask(true),scalar(-100),q)==q[0]);
+      REQUIRE (ekat::reduce_min<Serialize>(Mask(true),scalar(100),-q)==-q[0]);
+    }
+  }
+
 #define test_pack_gen_assign_op_all(op) do {        \
     Pack a, b;                                      \
     scalar c;                                       \
@@ -390,12 +524,15 @@ struct TestPack {
     test_conversion();
     test_unary_min_max();
     test_range();
+    test_shift();
     test_ostream();
     test_masked_ctor();
     test_masked_set();
 
     test_reduce_sum<true>();
     test_reduce_sum<false>();
+    test_reductions<true>();
+    test_reductions<false>();
   }
 };
 
@@ -536,6 +673,107 @@ TEST_CASE("pack_update") {
   for (int i=0; i<N; ++i) REQUIRE (y[i]==(i%2==0 ? 1 : -1));
 }
 
+TEST_CASE("fma", "ekat::pack") {
+  constexpr int N = EKAT_TEST_PACK_SIZE;
+  using pt = ekat::Pack<Real,N>;
+
+  // a*b = 1-2^-2k is not representable, and rounds to 1, so a*b-1 is 0 if
+  // a*b is rounded before the subtraction, and -2^-2k with a single rounding.
+  // Use volatile values, so that the compiler cannot fold the ops.
+  constexpr int k = std::numeric_limits<Real>::digits/2 + 1;
+  const Real e = std::ldexp(Real(1),-k);
+  volatile Real va = 1+e, vb = 1-e, vc = 1;
+  const Real a = va, b = vb, c = vc;
+  const Real exact = -e*e;
+
+  // BFB mode always rounds once, like std::fma
+  REQUIRE (ekat::fma<true>(a,b,-c)==exact);
+  REQUIRE (ekat::fms<true>(a,b,c)==exact);
+  REQUIRE (ekat::fnma<true>(a,b,c)==-exact);
+
+  // Otherwise, it rounds once only if the target has hardware fma
+  const Real r = ekat::fma<false>(a,b,-c);
+  if (ekat::impl::HasFastFma<Real>::value) {
+    REQUIRE (r==exact);
+  } else {
+    REQUIRE ((r==exact or r==0));
+  }
+
+  // Packs, and mixes of packs and scalars, give the same result as the scalar fcn
+  pt pa, pb, pc;
+  for (int i=0; i<N; ++i) {
+    pa[i] = (i%2==0 ? a : Real(0.5)/(i+1));
+    pb[i] = (i%2==0 ? b : Real(3) + i);
+    pc[i] = (i%2==0 ? c : Real(1)/(i+3));
+  }
+  const pt f  = ekat::fma<true>(pa,pb,-pc);
+  const pt fs = ekat::fms<true>(pa,pb,pc);
+  const pt fn = ekat::fnma<true>(pa,pb,pc);
+  const pt f1 = ekat::fma<true>(pa,b,pc);
+  const pt f2 = ekat::fma<true>(a,pb,c);
+  const pt f3 = ekat::fma(pa,pb,pc);
+  for (int i=0; i<N; ++i) {
+    REQUIRE (f[i]==ekat::fma<true>(pa[i],pb[i],-pc[i]));
+    REQUIRE (fs[i]==f[i]);
+    REQUIRE (fn[i]==-f[i]);
+    REQUIRE (f1[i]==ekat::fma<true>(pa[i],b,pc[i]));
+    REQUIRE (f2[i]==ekat::fma<true>(a,pb[i],c));
+    REQUIRE (f3[i]==ekat::fma(pa[i],pb[i],pc[i]));
+  }
+
+  // Horner: c0 + x*(c1 + x*(c2 + x*c3)), with one fma per coefficient
+  const Real c0 = 1, c1 = -0.5, c2 = 0.25, c3 = 1.0/3;
+  const pt h = ekat::horner<true>(pa,c0,c1,c2,c3);
+  const pt hd = ekat::horner(pa,c0,c1,c2,c3);
+  for (int i=0; i<N; ++i) {
+    const Real x = pa[i];
+    const Real ref = std::fma(x,std::fma(x,std::fma(x,c3,c2),c1),c0);
+    REQUIRE (h[i]==ref);
+    REQUIRE (ekat::horner<true>(x,c0,c1,c2,c3)==ref);
+    REQUIRE (hd[i]==ekat::horner(x,c0,c1,c2,c3));
+  }
+  REQUIRE (ekat::horner<true>(a,c0)==c0);
+  REQUIRE ((ekat::horner<true>(pa,c0)==pt(c0)).all());
+}
+
+TEST_CASE("mixed_precision", "ekat::pack")
+{
+  constexpr int N = EKAT_TEST_PACK_SIZE;
+  using fpack_t = ekat::Pack<float,N>;
+  using dpack_t = ekat::Pack<double,N>;
+
+  // Widening is exact, and narrowing must round as static_cast does
+  fpack_t pf;
+  dpack_t pd;
+  for (int i=0; i<N; ++i) {
+    pf[i] = 1.0f/(i+3);
+    pd[i] = 1.0/(i+3);
+  }
+  const dpack_t pfd(pf);
+  const fpack_t pdf(pd);
+  for (int i=0; i<N; ++i) {
+    REQUIRE (pfd[i]==static_cast<double>(pf[i]));
+    REQUIRE (pdf[i]==static_cast<float>(pd[i]));
+  }
+
+  // Accumulating a float pack into a double must be the same as accumulating
+  // the widened pack, and not lose the digits that a float sum would lose
+  double sum = 0.5, sum_d = 0.5;
+  ekat::reduce_sum<true>(pf,sum);
+  ekat::reduce_sum<true>(pfd,sum_d);
+  REQUIRE (sum==sum_d);
+  REQUIRE (ekat::reduce_sum<double,true>(pf)==ekat::reduce_sum<true>(pfd));
+
+  const double big = 1 << 24; // beyond this, float cannot represent consecutive integers
+  sum = big;
+  ekat::reduce_sum<true>(fpack_t(1),sum);
+  REQUIRE (sum==big+N);
+  sum = big;
+  ekat::reduce_sum(fpack_t(1),sum);
+  REQUIRE (sum==big+N);
+  REQUIRE (ekat::reduce_sum<double>(fpack_t(1.5f))==1.5*N);
+}
+
 TEST_CASE("different_scalar_types")
 {
   constexpr int N = EKAT_TEST_PACK_SIZE;
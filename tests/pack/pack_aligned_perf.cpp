@@ -0,0 +1,145 @@
+#include "ekat_pack.hpp"
+#include "ekat_pack_kokkos.hpp"
+#include "ekat_kokkos_session.hpp"
+#include "ekat_kokkos_types.hpp"
+#include "ekat_test_utils.hpp"
+#include "ekat_test_config.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <utility>
+
+/*
+ * Stream-style benchmark (copy, scale, add, triad) on views of packs, comparing
+ * views allocated with allocate_aligned (see ekat_pack_kokkos.hpp) with views
+ * whose data is deliberately misaligned by one scalar, so that packs straddle
+ * cache lines. Both kernels access the data via aligned_data, which only lets
+ * the compiler assume alignment for the former. Timings are in ns per pack,
+ * for pack sizes 4, 8 and 16.
+ *
+ * Usage: pack_aligned_perf [-n|--nslots N] [-r|--nrep R]
+ */
+
+namespace ekat {
+namespace test {
+namespace perf {
+
+struct Input {
+  int nslots = 1 << 15;
+  int nrep = 1000;
+
+  bool parse (int argc, char** argv) {
+    for (int i = 1; i < argc; ++i) {
+      if (argv_matches(argv[i], "-n", "--nslots")) {
+        if (i == argc-1) return false;
+        nslots = std::atoi(argv[++i]);
+      } else if (argv_matches(argv[i], "-r", "--nrep")) {
+        if (i == argc-1) return false;
+        nrep = std::atoi(argv[++i]);
+      } else {
+        std::cout << "Unexpected arg: " << argv[i] << "\n";
+        return false;
+      }
+    }
+    return nslots>0 and nrep>0;
+  }
+};
+
+template <typename Real, int N>
+void run (const Input& in) {
+  using PackT = Pack<Real,N>;
+  using clock = std::chrono::steady_clock;
+  using KT = KokkosTypes<HostDevice>;
+  using uview_t = KT::view_1d<PackT,Kokkos::MemoryTraits<Kokkos::Unmanaged>>;
+
+  const int np = PackInfo<N>::num_packs(in.nslots);
+
+  // Aligned views
+  const auto a = allocate_aligned<PackT,HostDevice>("a",in.nslots);
+  const auto b = allocate_aligned<PackT,HostDevice>("b",in.nslots);
+  const auto c = allocate_aligned<PackT,HostDevice>("c",in.nslots);
+
+  // Misaligned views: same number of packs, but starting one scalar past an
+  // aligned address (the alignment of Pack<Real,N> itself is only that of Real)
+  const auto misaligned = [&](const std::string& name) {
+    KT::view_1d<Real> buf(name,(np+1)*N);
+    return std::make_pair(buf,uview_t(reinterpret_cast<PackT*>(buf.data()+1),np));
+  };
+  const auto ua = misaligned("ua");
+  const auto ub = misaligned("ub");
+  const auto uc = misaligned("uc");
+
+  for (int i = 0; i < np; ++i) {
+    for (int j = 0; j < N; ++j) {
+      b(i)[j] = ub.second(i)[j] = 0.5 + ((7*(i*N+j) + 3) % 101) / 101.0;
+      c(i)[j] = uc.second(i)[j] = 0.5 + ((5*(i*N+j) + 11) % 97) / 97.0;
+    }
+  }
+  const Real s = 0.75;
+
+  printf("pack_aligned_perf: pack size %d, sizeof(Real) %d, npacks %d, nrep %d, alignment %d\n",
+         N, int(sizeof(Real)), np, in.nrep, view_alignment);
+  printf("  %-8s %12s %12s %10s   (ns/pack)\n", "kernel", "aligned", "misaligned", "ratio");
+
+  // Time kernel f(a,b,c) over all packs, and return ns/pack
+  const auto time_op = [&] (const auto& f, const auto& va, const auto& vb, const auto& vc) {
+    PackT* pa = aligned_data(va);
+    const PackT* pb = aligned_data(vb);
+    const PackT* pc = aligned_data(vc);
+    f(pa,pb,pc);
+    const auto t0 = clock::now();
+    for (int r = 0; r < in.nrep; ++r)
+      f(pa,pb,pc);
+    const auto t1 = clock::now();
+    const double ns = std::chrono::duration<double,std::nano>(t1-t0).count();
+
+    // Accumulate outputs, so the compiler cannot optimize away the loop
+    Real chk = 0;
+    for (int i = 0; i < np; ++i) chk += pa[i][0];
+    return std::make_pair(ns/(double(in.nrep)*np),chk);
+  };
+
+  const auto time_kernel = [&] (const char* name, const auto& f) {
+    const auto ta = time_op(f,a,b,c);
+    const auto tu = time_op(f,ua.second,ub.second,uc.second);
+    printf("  %-8s %12.4f %12.4f %10.3f  (chk %g)\n", name, ta.first, tu.first,
+           tu.first/ta.first, double(ta.second-tu.second));
+  };
+
+  time_kernel("copy",  [&](PackT* x, const PackT* y, const PackT*) {
+    for (int i = 0; i < np; ++i) x[i] = y[i];
+  });
+  time_kernel("scale", [&](PackT* x, const PackT* y, const PackT*) {
+    for (int i = 0; i < np; ++i) x[i] = s*y[i];
+  });
+  time_kernel("add",   [&](PackT* x, const PackT* y, const PackT* z) {
+    for (int i = 0; i < np; ++i) x[i] = y[i] + z[i];
+  });
+  time_kernel("triad", [&](PackT* x, const PackT* y, const PackT* z) {
+    for (int i = 0; i < np; ++i) x[i] = y[i] + s*z[i];
+  });
+}
+
+} // namespace perf
+} // namespace test
+} // namespace ekat
+
+int main (int argc, char** argv) {
+  ekat::test::perf::Input in;
+  if (not in.parse(argc,argv)) {
+    std::cout << "Usage: " << argv[0] << " [-n|--nslots N] [-r|--nrep R]\n";
+    return 1;
+  }
+
+  ekat::initialize_kokkos_session(false); {
+    using namespace ekat::test::perf;
+    run<Real,4>(in);
+    run<Real,8>(in);
+    run<Real,16>(in);
+  } ekat::finalize_kokkos_session();
+
+  return 0;
+}
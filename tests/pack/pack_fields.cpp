@@ -0,0 +1,116 @@
+#include <catch2/catch.hpp>
+
+#include "ekat_pack_fields.hpp"
+#include "ekat_pack_kokkos.hpp"
+#include "ekat_kokkos_types.hpp"
+
+#include "ekat_test_config.h"
+
+#include <cstdint>
+
+namespace {
+
+template <int N>
+void test_pack_fields ()
+{
+  using namespace ekat;
+
+  using PF = PackFields<Real,N>;
+  using PackT = typename PF::pack_type;
+
+  const int ncol = 3, nfields = 5;
+  for (const int nlev : {1, N-1, N, 2*N+1, 72}) {
+    if (nlev<=0) continue;
+
+    PF q("q",ncol,nfields,nlev);
+
+    // Dimensions
+    REQUIRE (q.ncols()==ncol);
+    REQUIRE (q.nfields()==nfields);
+    REQUIRE (q.nlevs()==nlev);
+    REQUIRE (q.npacks()==PackInfo<N>::num_packs(nlev));
+    REQUIRE (int(q.view().extent(0))==ncol);
+    REQUIRE (int(q.view().extent(1))==nfields);
+    REQUIRE (int(q.view().extent(2))==padded_extent<Real,N>(nlev)/N);
+    REQUIRE (int(q.view().extent(2))>=q.npacks());
+
+    // Layout: fields of a column are contiguous, and each starts at an aligned address
+    const int np = q.view().extent(2);
+    for (int i=0; i<ncol; ++i) {
+      REQUIRE (q.column(i).data()==q.view().data()+i*nfields*np);
+      REQUIRE (int(q.column(i).extent(0))==nfields);
+      for (int f=0; f<nfields; ++f) {
+        const auto qf = q.field(i,f);
+        REQUIRE (qf.data()==q.column(i).data()+f*np);
+        REQUIRE (int(qf.extent(0))==np);
+        REQUIRE (reinterpret_cast<std::uintptr_t>(qf.data()) % view_alignment == 0);
+
+        const auto qfs = scalarize(qf);
+        REQUIRE (int(qfs.extent(0))==np*N);
+        REQUIRE (reinterpret_cast<void*>(qfs.data())==reinterpret_cast<void*>(qf.data()));
+      }
+    }
+    REQUIRE (int(q.field(0).extent(0))==ncol);
+    REQUIRE (int(q.field(0).extent(1))==q.npacks());
+
+    // Fill on device via operator(), then check values (and padding) on host
+    const auto val = [] (const int i, const int f, const int k) -> Real {
+      return 1000*i + 100*f + k;
+    };
+    Kokkos::parallel_for(Kokkos::RangePolicy<typename PF::device_type::execution_space>(0,ncol),
+                         KOKKOS_LAMBDA (const int i) {
+      for (int f=0; f<q.nfields(); ++f) {
+        for (int k=0; k<q.npacks(); ++k) {
+          for (int s=0; s<N; ++s) {
+            q(i,f,k)[s] = 1000*i + 100*f + k*N+s;
+          }
+        }
+      }
+    });
+    Kokkos::fence();
+
+    const auto h = Kokkos::create_mirror_view(q.view());
+    Kokkos::deep_copy(h,q.view());
+    for (int i=0; i<ncol; ++i) {
+      for (int f=0; f<nfields; ++f) {
+        for (int k=0; k<np; ++k) {
+          for (int s=0; s<N; ++s) {
+            REQUIRE (h(i,f,k)[s]==(k<q.npacks() ? val(i,f,k*N+s) : Real(0)));
+          }
+        }
+      }
+    }
+
+    // Copy a field to/from a separate (ncol,npacks) view
+    typename KokkosTypes<DefaultDevice>::template view_2d<PackT> sep("sep",ncol,q.npacks());
+    Kokkos::deep_copy(sep,q.field(2));
+    const auto hs = Kokkos::create_mirror_view(sep);
+    Kokkos::deep_copy(hs,sep);
+    for (int i=0; i<ncol; ++i) {
+      for (int k=0; k<q.npacks(); ++k) {
+        for (int s=0; s<N; ++s) {
+          REQUIRE (hs(i,k)[s]==val(i,2,k*N+s));
+        }
+      }
+    }
+    Kokkos::deep_copy(q.field(1),sep);
+    Kokkos::deep_copy(h,q.view());
+    for (int i=0; i<ncol; ++i) {
+      for (int k=0; k<q.npacks(); ++k) {
+        for (int s=0; s<N; ++s) {
+          REQUIRE (h(i,1,k)[s]==val(i,2,k*N+s));
+          REQUIRE (h(i,0,k)[s]==val(i,0,k*N+s));
+          REQUIRE (h(i,3,k)[s]==val(i,3,k*N+s));
+        }
+      }
+    }
+  }
+}
+
+TEST_CASE("pack_fields") {
+  test_pack_fields<1>();
+  test_pack_fields<4>();
+  test_pack_fields<8>();
+}
+
+} // namespace
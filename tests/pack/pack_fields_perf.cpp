@@ -0,0 +1,153 @@
+#include "ekat_pack.hpp"
+#include "ekat_pack_fields.hpp"
+#include "ekat_kokkos_session.hpp"
+#include "ekat_kokkos_types.hpp"
+#include "ekat_test_utils.hpp"
+#include "ekat_test_config.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+/*
+ * Multi-field column update, comparing NF=20 fields stored in separate
+ * (ncol, npacks) views with the same fields stored in a PackFields container
+ * (see ekat_pack_fields.hpp). For each column i and pack k, the kernel computes
+ *
+ *   s = sum_f w_f*q_f(i,k),   q_f(i,k) += dt*w_f*s,   f = 0,...,NF-1
+ *
+ * i.e., it touches all the fields at each level, as a typical tracer update
+ * does. Timings are in ns per (column, field, pack), for pack sizes 4, 8 and 16.
+ *
+ * Usage: pack_fields_perf [-n|--ncol N] [-l|--nlev L] [-r|--nrep R]
+ */
+
+namespace ekat {
+namespace test {
+namespace perf {
+
+constexpr int NF = 20;
+
+struct Input {
+  int ncol = 1024;
+  int nlev = 128;
+  int nrep = 100;
+
+  bool parse (int argc, char** argv) {
+    for (int i = 1; i < argc; ++i) {
+      if (argv_matches(argv[i], "-n", "--ncol")) {
+        if (i == argc-1) return false;
+        ncol = std::atoi(argv[++i]);
+      } else if (argv_matches(argv[i], "-l", "--nlev")) {
+        if (i == argc-1) return false;
+        nlev = std::atoi(argv[++i]);
+      } else if (argv_matches(argv[i], "-r", "--nrep")) {
+        if (i == argc-1) return false;
+        nrep = std::atoi(argv[++i]);
+      } else {
+        std::cout << "Unexpected arg: " << argv[i] << "\n";
+        return false;
+      }
+    }
+    return ncol>0 and nlev>0 and nrep>0;
+  }
+};
+
+template <typename Real, int N>
+void run (const Input& in) {
+  using PackT = Pack<Real,N>;
+  using clock = std::chrono::steady_clock;
+  using ExeSpace = typename DefaultDevice::execution_space;
+  using KT = KokkosTypes<DefaultDevice>;
+  using view_t = typename KT::template view_2d<PackT>;
+
+  const int ncol = in.ncol;
+  const int np = PackInfo<N>::num_packs(in.nlev);
+
+  Kokkos::Array<view_t,NF> qs;
+  Kokkos::Array<Real,NF> w;
+  for (int f = 0; f < NF; ++f) {
+    qs[f] = view_t("q"+std::to_string(f),ncol,np);
+    w[f] = Real(1)/(f+2);
+  }
+  PackFields<Real,N> qf("qf",ncol,NF,in.nlev);
+
+  const auto init = KOKKOS_LAMBDA (const int i, const int f, const int k) {
+    PackT p;
+    for (int s = 0; s < N; ++s) p[s] = 0.5 + ((7*(i+f) + 3*(k*N+s)) % 101) / 101.0;
+    return p;
+  };
+  Kokkos::parallel_for(Kokkos::RangePolicy<ExeSpace>(0,ncol), KOKKOS_LAMBDA (const int i) {
+    for (int f = 0; f < NF; ++f) {
+      for (int k = 0; k < np; ++k) {
+        qs[f](i,k) = qf(i,f,k) = init(i,f,k);
+      }
+    }
+  });
+  Kokkos::fence();
+
+  // Small enough that the fields stay bounded over many reps
+  const Real dt = 1e-6;
+
+  printf("pack_fields_perf: pack size %d, sizeof(Real) %d, ncol %d, nfields %d, npacks %d, nrep %d\n",
+         N, int(sizeof(Real)), ncol, NF, np, in.nrep);
+  printf("  %-10s %12s   (ns/(col*field*pack))\n", "layout", "time");
+
+  // Time kernel over all columns, and return ns/(col*field*pack)
+  const auto time_op = [&] (const char* name, const auto& f, const auto& get) {
+    Kokkos::parallel_for(Kokkos::RangePolicy<ExeSpace>(0,ncol), f);
+    Kokkos::fence();
+    const auto t0 = clock::now();
+    for (int r = 0; r < in.nrep; ++r)
+      Kokkos::parallel_for(Kokkos::RangePolicy<ExeSpace>(0,ncol), f);
+    Kokkos::fence();
+    const auto t1 = clock::now();
+    const double ns = std::chrono::duration<double,std::nano>(t1-t0).count();
+
+    // Accumulate outputs, so the compiler cannot optimize away the loop
+    Real chk = 0;
+    Kokkos::parallel_reduce(Kokkos::RangePolicy<ExeSpace>(0,ncol), KOKKOS_LAMBDA (const int i, Real& sum) {
+      for (int f = 0; f < NF; ++f) sum += get(i,f)[0];
+    }, chk);
+    printf("  %-10s %12.4f  (chk %g)\n", name, ns/(double(in.nrep)*ncol*NF*np), double(chk));
+  };
+
+  time_op("separate", KOKKOS_LAMBDA (const int i) {
+    for (int k = 0; k < np; ++k) {
+      PackT s = 0;
+      for (int f = 0; f < NF; ++f) s += w[f]*qs[f](i,k);
+      for (int f = 0; f < NF; ++f) qs[f](i,k) += dt*w[f]*s;
+    }
+  }, KOKKOS_LAMBDA (const int i, const int f) { return qs[f](i,0); });
+
+  time_op("packfields", KOKKOS_LAMBDA (const int i) {
+    for (int k = 0; k < np; ++k) {
+      PackT s = 0;
+      for (int f = 0; f < NF; ++f) s += w[f]*qf(i,f,k);
+      for (int f = 0; f < NF; ++f) qf(i,f,k) += dt*w[f]*s;
+    }
+  }, KOKKOS_LAMBDA (const int i, const int f) { return qf(i,f,0); });
+}
+
+} // namespace perf
+} // namespace test
+} // namespace ekat
+
+int main (int argc, char** argv) {
+  ekat::test::perf::Input in;
+  if (not in.parse(argc,argv)) {
+    std::cout << "Usage: " << argv[0] << " [-n|--ncol N] [-l|--nlev L] [-r|--nrep R]\n";
+    return 1;
+  }
+
+  ekat::initialize_kokkos_session(false); {
+    using namespace ekat::test::perf;
+    run<Real,4>(in);
+    run<Real,8>(in);
+    run<Real,16>(in);
+  } ekat::finalize_kokkos_session();
+
+  return 0;
+}
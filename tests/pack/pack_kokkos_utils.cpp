@@ -7,6 +7,8 @@
 
 #include "ekat_test_config.h"
 
+#include <cstdint>
+#include <numeric>
 #include <vector>
 
 namespace {
@@ -136,6 +138,119 @@ TEST_CASE("index", "ekat::pack") {
   }
 }
 
+// Check index (gather) and scatter with contiguous, strided, reversed and
+// repeated indices, on views with different layouts
+template<int pack_size, typename View>
+void do_gather_scatter_test(const View& data)
+{
+  using IdxPack = ekat::Pack<int, pack_size>;
+  using ValPack = ekat::Pack<typename View::non_const_value_type, pack_size>;
+
+  const int n = data.extent(0);
+  REQUIRE (n >= 3*pack_size);
+
+  int nerr = 0;
+  Kokkos::parallel_reduce(
+    1, KOKKOS_LAMBDA (const int /* unused */, int& nerr) {
+      for (int i = 0; i < n; ++i) data(i) = i;
+
+      IdxPack idx[4];
+      idx[0] = ekat::range<IdxPack>(1);           // contiguous
+      for (int i = 0; i < pack_size; ++i) {
+        idx[1][i] = 3*i;                          // strided
+        idx[2][i] = n-1-i;                        // reversed
+        idx[3][i] = i/2;                          // repeated
+      }
+
+      // index/index_and_shift return the same as looping over the slots
+      for (int k = 0; k < 4; ++k) {
+        const auto v = ekat::index(data, idx[k]);
+        for (int i = 0; i < pack_size; ++i)
+          if (v[i] != data(idx[k][i])) ++nerr;
+      }
+      ValPack v0, v1;
+      ekat::index_and_shift<1>(data, idx[1], v0, v1);
+      for (int i = 0; i < pack_size; ++i)
+        if (v0[i] != data(idx[1][i]) or v1[i] != data(idx[1][i]+1)) ++nerr;
+
+      // scatter writes the slots (or only the active ones) at the indices,
+      // and nothing else
+      const auto m = ekat::range<IdxPack>(0) < pack_size/2;
+      for (int k = 0; k < 3; ++k) {
+        for (int masked = 0; masked < 2; ++masked) {
+          for (int i = 0; i < n; ++i) data(i) = -1;
+          const auto v = ekat::range<ValPack>(100);
+          if (masked) {
+            ekat::scatter(data, idx[k], v, m);
+          } else {
+            ekat::scatter(data, idx[k], v);
+          }
+          int nset = 0;
+          for (int i = 0; i < pack_size; ++i) {
+            const bool active = not masked or m[i];
+            if (data(idx[k][i]) != (active ? v[i] : -1)) ++nerr;
+            nset += active;
+          }
+          for (int i = 0; i < n; ++i) nset -= data(i) != -1;
+          if (nset != 0) ++nerr;
+        }
+      }
+    },
+    nerr);
+  REQUIRE(nerr == 0);
+}
+
+TEST_CASE("gather_scatter", "ekat::pack") {
+  {
+    Kokkos::View<double*> data("data", 64);
+    do_gather_scatter_test<16>(data);
+    do_gather_scatter_test<1>(data);
+  }
+
+  {
+    Kokkos::View<int*, Kokkos::LayoutLeft> data("data", 64);
+    do_gather_scatter_test<8>(data);
+  }
+
+  {
+    // Every other entry of a buffer
+    Kokkos::View<double*, Kokkos::LayoutStride> data("data", Kokkos::LayoutStride(48, 2));
+    do_gather_scatter_test<4>(data);
+  }
+
+  {
+    // Rank 2 views, with both layouts
+    Kokkos::View<double**, Kokkos::LayoutRight> r("r", 7, 9);
+    Kokkos::View<double**, Kokkos::LayoutLeft>  l("l", 7, 9);
+    using IdxPack = ekat::Pack<int, 8>;
+    using ValPack = ekat::Pack<double, 8>;
+
+    int nerr = 0;
+    Kokkos::parallel_reduce(
+      1, KOKKOS_LAMBDA (const int /* unused */, int& nerr) {
+        IdxPack i0, i1;
+        for (int i = 0; i < IdxPack::n; ++i) {
+          i0[i] = (i*5) % 7;
+          i1[i] = 2;
+        }
+        ekat::scatter(r, i0, i1, ekat::range<ValPack>(10));
+        ekat::scatter(l, i0, i1, ekat::range<ValPack>(10), i0 > 2);
+        const auto vr = ekat::index(r, i0, i1);
+        const auto vl = ekat::index(l, i0, i1);
+        for (int i = 0; i < IdxPack::n; ++i) {
+          if (vr[i] != r(i0[i],i1[i]) or vl[i] != l(i0[i],i1[i])) ++nerr;
+          if (vl[i] != (i0[i] > 2 ? vr[i] : 0)) ++nerr;
+        }
+        // Rows of r are contiguous
+        const auto row = ekat::index(r, IdxPack(3), ekat::range<IdxPack>(1));
+        for (int i = 0; i < IdxPack::n; ++i)
+          if (row[i] != r(3,i+1)) ++nerr;
+      },
+      nerr);
+    REQUIRE(nerr == 0);
+  }
+}
+
 TEST_CASE("scalarize", "ekat::pack") {
   using ekat::Pack;
   using ekat::scalarize;
@@ -275,6 +390,143 @@ TEST_CASE("repack", "ekat::pack") {
   }
 }
 
+TEST_CASE("aligned_views", "ekat::pack") {
+  using namespace ekat;
+  using KT = KokkosTypes<DefaultDevice>;
+
+  const auto is_aligned = [](const void* p) {
+    return reinterpret_cast<std::uintptr_t>(p) % view_alignment == 0;
+  };
+
+  // padded_extent must return the smallest extent that holds n scalars, and spans
+  // a multiple of view_alignment bytes
+  const auto check_extent = [](const int e, const int n, const int pack_size, const int entry_bytes) {
+    const int pack_bytes = pack_size*sizeof(Real);
+    const int chunk = std::lcm(pack_bytes,view_alignment) / entry_bytes;
+    REQUIRE (e*entry_bytes % view_alignment == 0);
+    REQUIRE (e*entry_bytes >= n*static_cast<int>(sizeof(Real)));
+    REQUIRE ((e==0 or (e-chunk)*entry_bytes < n*static_cast<int>(sizeof(Real))));
+  };
+  for (int n : {0, 1, 7, 50, 64, 65, 1000}) {
+    check_extent(padded_extent<Pack<Real,4>>(n), n, 4, sizeof(Pack<Real,4>));
+    check_extent(padded_extent<Pack<Real,16>>(n), n, 16, sizeof(Pack<Real,16>));
+    check_extent(padded_extent<Real>(n), n, 1, sizeof(Real));
+    check_extent(padded_extent<Real,16>(n), n, 16, sizeof(Real));
+    REQUIRE (padded_extent<Real,16>(n) % 16 == 0);
+  }
+
+  const int ncol = 3, nlev = 50;
+
+  // Pack views: all rows must be aligned, and scalarize/repack must keep the alignment trait
+  {
+    using PackT = Pack<Real,4>;
+    const auto v = allocate_aligned<PackT>("v",ncol,nlev);
+    static_assert (std::is_same<std::remove_const_t<decltype(v)>,KT::aligned_view_2d<PackT>>::value,
+                   "Error! Unexpected view type from allocate_aligned.\n");
+    static_assert (IsAlignedView<decltype(v)>::value, "Error! Aligned trait not set.\n");
+    static_assert (not IsAlignedView<KT::view_2d<PackT>>::value, "Error! Unexpected aligned trait.\n");
+
+    REQUIRE (v.extent_int(0)==ncol);
+    REQUIRE (v.extent_int(1)==padded_extent<PackT>(nlev));
+    REQUIRE (aligned_data(v)==v.data());
+    for (int i=0; i<ncol; ++i) {
+      REQUIRE (is_aligned(v.data() + i*v.stride(0)));
+    }
+
+    const auto vs = scalarize(v);
+    static_assert (IsAlignedView<decltype(vs)>::value, "Error! scalarize dropped the aligned trait.\n");
+    REQUIRE (vs.extent_int(1)==v.extent_int(1)*PackT::n);
+
+    const auto v2 = repack<2>(v);
+    static_assert (IsAlignedView<decltype(v2)>::value, "Error! repack dropped the aligned trait.\n");
+    REQUIRE (v2.data()==reinterpret_cast<const Pack<Real,2>*>(v.data()));
+  }
+
+  // Scalar views, padded to the pack size, so they can be repacked
+  {
+    const auto w = allocate_aligned<Real,DefaultDevice,16>("w",ncol,nlev);
+    static_assert (IsAlignedView<decltype(w)>::value, "Error! Aligned trait not set.\n");
+    REQUIRE (w.extent_int(1) % 16 == 0);
+    REQUIRE (w.extent_int(1) >= nlev);
+    for (int i=0; i<ncol; ++i) {
+      REQUIRE (is_aligned(w.data() + i*w.stride(0)));
+    }
+    const auto wp = repack<16>(w);
+    REQUIRE (wp.extent_int(1)==w.extent_int(1)/16);
+  }
+
+  // Rank 1 and 3
+  {
+    const auto v1 = allocate_aligned<Pack<Real,8>>("v1",nlev);
+    REQUIRE (v1.extent_int(0)==padded_extent<Pack<Real,8>>(nlev));
+    REQUIRE (is_aligned(v1.data()));
+
+    const auto v3 = allocate_aligned<Pack<Real,8>>("v3",ncol,2,nlev);
+    REQUIRE (v3.extent_int(2)==padded_extent<Pack<Real,8>>(nlev));
+    for (int i=0; i<ncol; ++i) {
+      for (int j=0; j<2; ++j) {
+        REQUIRE (is_aligned(v3.data() + i*v3.stride(0) + j*v3.stride(1)));
+      }
+    }
+  }
+}
+
+TEST_CASE("convert_copy", "ekat::pack") {
+  using namespace ekat;
+  using KT = KokkosTypes<DefaultDevice>;
+  constexpr int N = 8;
+  using fpack_t = Pack<float,N>;
+  using dpack_t = Pack<double,N>;
+
+  const int ncol = 3, npack = 5;
+  KT::view_2d<fpack_t> f("f",ncol,npack), f2("f2",ncol,npack);
+  KT::view_2d<dpack_t> d("d",ncol,npack);
+
+  const auto fh = Kokkos::create_mirror_view(f);
+  for (int i=0; i<ncol; ++i) {
+    for (int k=0; k<npack; ++k) {
+      for (int s=0; s<N; ++s) {
+        fh(i,k)[s] = 1.0f/(i*npack*N + k*N + s + 1);
+      }
+    }
+  }
+  Kokkos::deep_copy(f,fh);
+
+  // float -> double is exact, and so is the round trip
+  convert_copy(d,f);
+  convert_copy(f2,d);
+  const auto dh = Kokkos::create_mirror_view(d);
+  const auto f2h = Kokkos::create_mirror_view(f2);
+  Kokkos::deep_copy(dh,d);
+  Kokkos::deep_copy(f2h,f2);
+  for (int i=0; i<ncol; ++i) {
+    for (int k=0; k<npack; ++k) {
+      for (int s=0; s<N; ++s) {
+        REQUIRE (dh(i,k)[s]==static_cast<double>(fh(i,k)[s]));
+        REQUIRE (f2h(i,k)[s]==fh(i,k)[s]);
+      }
+    }
+  }
+
+  // Scalar views too
+  const auto fs = scalarize(f);
+  KT::view_2d<double> ds("ds",ncol,npack*N);
+  convert_copy(ds,fs);
+  const auto dsh = Kokkos::create_mirror_view(ds);
+  Kokkos::deep_copy(dsh,ds);
+  for (int i=0; i<ncol; ++i) {
+    for (int k=0; k<npack; ++k) {
+      for (int s=0; s<N; ++s) {
+        REQUIRE (dsh(i,k*N+s)==static_cast<double>(fh(i,k)[s]));
+      }
+    }
+  }
+
+  // Mismatching extents are an error
+  KT::view_2d<dpack_t> bad("bad",ncol,npack+1);
+  REQUIRE_THROWS (convert_copy(bad,f));
+}
+
 TEST_CASE("kokkos_packs", "ekat::pack") {
   using namespace ekat;
 
@@ -0,0 +1,147 @@
+#include "ekat_pack.hpp"
+#include "ekat_pack_math.hpp"
+#include "ekat_test_utils.hpp"
+#include "ekat_test_config.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+/*
+ * Throughput benchmark for the transcendental functions in ekat_pack_math.hpp.
+ *
+ * Each function is applied to every pack of an array of packs, for each
+ * accuracy level (Exact=libm, Accurate and Fast vector kernels, see
+ * ekat_pack_vmath.hpp) and for a few pack sizes, and the time per
+ * slot (i.e., per scalar evaluation) is reported.
+ *
+ * Usage: pack_math_perf [-n|--nslots N] [-r|--nrep R]
+ */
+
+namespace ekat {
+namespace test {
+namespace perf {
+
+using vmath::Accuracy;
+
+struct Input {
+  int nslots = 1 << 14;
+  int nrep = 100;
+
+  bool parse (int argc, char** argv) {
+    for (int i = 1; i < argc; ++i) {
+      if (argv_matches(argv[i], "-n", "--nslots")) {
+        if (i == argc-1) return false;
+        nslots = std::atoi(argv[++i]);
+      } else if (argv_matches(argv[i], "-r", "--nrep")) {
+        if (i == argc-1) return false;
+        nrep = std::atoi(argv[++i]);
+      } else {
+        std::cout << "Unexpected arg: " << argv[i] << "\n";
+        return false;
+      }
+    }
+    return nslots>0 and nrep>0;
+  }
+};
+
+template <typename Real, int N>
+void run (const Input& in) {
+  using PackT = Pack<Real,N>;
+  using clock = std::chrono::steady_clock;
+
+  const int np = (in.nslots + N - 1) / N;
+  std::vector<PackT> x(np), y(np), z(np);
+  for (int i = 0; i < np; ++i) {
+    for (int j = 0; j < N; ++j) {
+      // Values in (0.1,4.1), so that all fcns are well defined, and
+      // erf/tanh/expm1 are not all in the same branch of their kernels
+      x[i][j] = 0.1 + ((7*(i*N+j) + 3) % 1009) / 1009.0 * 4;
+      y[i][j] = 0.5 + ((5*(i*N+j) + 11) % 997) / 997.0;
+    }
+  }
+
+  printf("pack_math_perf: pack size %d, sizeof(Real) %d, nslots %d, nrep %d\n",
+         N, int(sizeof(Real)), np*N, in.nrep);
+  printf("  %-10s %12s %12s %12s   (ns/slot)\n", "fcn", "exact", "accurate", "fast");
+
+  // Time f over all packs, and return ns/slot
+  const auto time_op = [&] (const auto& f) {
+    for (int i = 0; i < np; ++i) f(i);
+    const auto t0 = clock::now();
+    for (int r = 0; r < in.nrep; ++r)
+      for (int i = 0; i < np; ++i) f(i);
+    const auto t1 = clock::now();
+    const double ns = std::chrono::duration<double,std::nano>(t1-t0).count();
+    return ns/(double(in.nrep)*np*N);
+  };
+
+  // Accumulate outputs, so the compiler cannot optimize away the loop
+  Real chk = 0;
+  const auto checksum = [&] () {
+    for (int i = 0; i < np; ++i) chk += z[i][0];
+  };
+
+#define time_fcn(name, expr)                                             \
+  {                                                                      \
+    double t[3];                                                         \
+    {                                                                    \
+      constexpr Accuracy A = Accuracy::Exact;                            \
+      t[0] = time_op([&](int i) { z[i] = expr; });                       \
+      checksum();                                                        \
+    }                                                                    \
+    {                                                                    \
+      constexpr Accuracy A = Accuracy::Accurate;                         \
+      t[1] = time_op([&](int i) { z[i] = expr; });                       \
+      checksum();                                                        \
+    }                                                                    \
+    {                                                                    \
+      constexpr Accuracy A = Accuracy::Fast;                             \
+      t[2] = time_op([&](int i) { z[i] = expr; });                       \
+      checksum();                                                        \
+    }                                                                    \
+    printf("  %-10s %12.4f %12.4f %12.4f\n", name, t[0], t[1], t[2]);    \
+  }
+
+  time_fcn("exp",      ekat::exp<A>(x[i]));
+  time_fcn("expm1",    ekat::expm1<A>(x[i]));
+  time_fcn("log",      ekat::log<A>(x[i]));
+  time_fcn("log10",    ekat::log10<A>(x[i]));
+  time_fcn("cbrt",     ekat::cbrt<A>(x[i]));
+  time_fcn("tanh",     ekat::tanh<A>(x[i]));
+  time_fcn("erf",      ekat::erf<A>(x[i]));
+  time_fcn("tgamma",   ekat::tgamma<A>(x[i]));
+  time_fcn("pow(p,s)", ekat::pow<A>(x[i],Real(0.75)));
+  time_fcn("pow(p,p)", ekat::pow<A>(x[i],y[i]));
+
+#undef time_fcn
+
+  printf("  (chk %g)\n", double(chk));
+}
+
+} // namespace perf
+} // namespace test
+} // namespace ekat
+
+int main (int argc, char** argv) {
+  ekat::test::perf::Input in;
+  if (not in.parse(argc,argv)) {
+    std::cout << "Usage: " << argv[0] << " [-n|--nslots N] [-r|--nrep R]\n";
+    return 1;
+  }
+
+  using namespace ekat::test::perf;
+  run<Real,1>(in);
+  run<Real,4>(in);
+  run<Real,8>(in);
+  run<Real,16>(in);
+  if (EKAT_TEST_PACK_SIZE!=1 and EKAT_TEST_PACK_SIZE!=4 and
+      EKAT_TEST_PACK_SIZE!=8 and EKAT_TEST_PACK_SIZE!=16) {
+    run<Real,EKAT_TEST_PACK_SIZE>(in);
+  }
+
+  return 0;
+}
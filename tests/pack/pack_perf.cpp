@@ -0,0 +1,167 @@
+#include "ekat_pack.hpp"
+#include "ekat_pack_where.hpp"
+#include "ekat_test_utils.hpp"
+#include "ekat_test_config.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+/*
+ * Throughput benchmark for the operators in ekat_pack.hpp, ekat_pack_where.hpp and ekat_pack_math.hpp.
+ *
+ * Each operator is applied to every pack of a few arrays of packs, and the
+ * time per pack is reported. Build this exec with and without the explicit-SIMD
+ * backend (see EKAT_PACK_SIMD_BACKEND) and bit-packed masks (see EKAT_PACK_MASK_BITS)
+ * to compare them (the pack_perf_stdsimd exec is the former, when the compiler
+ * supports it).
+ *
+ * Usage: pack_perf [-n|--npacks N] [-r|--nrep R]
+ */
+
+namespace ekat {
+namespace test {
+namespace perf {
+
+struct Input {
+  int npacks = 4096;
+  int nrep = 1000;
+
+  bool parse (int argc, char** argv) {
+    for (int i = 1; i < argc; ++i) {
+      if (argv_matches(argv[i], "-n", "--npacks")) {
+        if (i == argc-1) return false;
+        npacks = std::atoi(argv[++i]);
+      } else if (argv_matches(argv[i], "-r", "--nrep")) {
+        if (i == argc-1) return false;
+        nrep = std::atoi(argv[++i]);
+      } else {
+        std::cout << "Unexpected arg: " << argv[i] << "\n";
+        return false;
+      }
+    }
+    return npacks>0 and nrep>0;
+  }
+};
+
+template <typename Real, int N>
+void run (const Input& in) {
+  using PackT = Pack<Real,N>;
+  using MaskT = Mask<N>;
+  using clock = std::chrono::steady_clock;
+
+  const int np = in.npacks;
+  std::vector<PackT> x(np), y(np), z(np);
+  std::vector<MaskT> m(np);
+  std::vector<Real>  s(np);
+  for (int i = 0; i < np; ++i) {
+    for (int j = 0; j < N; ++j) {
+      // Positive values in (0.5,1.5), so that all math fcns are well defined
+      x[i][j] = 0.5 + ((7*i + 3*j) % 101) / 101.0;
+      y[i][j] = 0.5 + ((5*i + 11*j) % 97) / 97.0;
+    }
+    m[i] = x[i] < y[i];
+  }
+  const Real c = 0.75;
+
+  const bool simd = impl::PackSimd<Real,N>::enabled;
+  printf("pack_perf: backend %s, mask %s, pack size %d, sizeof(Real) %d, npacks %d, nrep %d\n",
+         simd ? "stdsimd" : "array", MaskT::is_bitmask ? "bits" : "array",
+         N, int(sizeof(Real)), np, in.nrep);
+
+  // Time f over all packs, and report ns/pack
+  const auto time_op = [&] (const char* name, const auto& f) {
+    for (int i = 0; i < np; ++i) f(i);
+    const auto t0 = clock::now();
+    for (int r = 0; r < in.nrep; ++r)
+      for (int i = 0; i < np; ++i) f(i);
+    const auto t1 = clock::now();
+    const double ns = std::chrono::duration<double,std::nano>(t1-t0).count();
+
+    // Accumulate outputs, so the compiler cannot optimize away the loop
+    Real chk = 0;
+    for (int i = 0; i < np; ++i) chk += z[i][0] + s[i] + m[i][0];
+    printf("  %-16s %10.4f ns/pack  (chk %g)\n", name, ns/(double(in.nrep)*np), double(chk));
+  };
+
+  // ekat_pack.hpp
+  time_op("p+p",         [&](int i) { z[i] = x[i] + y[i]; });
+  time_op("p-p",         [&](int i) { z[i] = x[i] - y[i]; });
+  time_op("p*p",         [&](int i) { z[i] = x[i] * y[i]; });
+  time_op("p/p",         [&](int i) { z[i] = x[i] / y[i]; });
+  time_op("p*s",         [&](int i) { z[i] = x[i] * c; });
+  time_op("s/p",         [&](int i) { z[i] = c / y[i]; });
+  time_op("-p",          [&](int i) { z[i] = -x[i]; });
+  time_op("p+=p",        [&](int i) { z[i] += x[i]; });
+  time_op("p*=s",        [&](int i) { z[i] *= c; });
+  time_op("p/=p",        [&](int i) { z[i] /= y[i]; });
+  time_op("min(p,p)",    [&](int i) { z[i] = min(x[i],y[i]); });
+  time_op("max(p,s)",    [&](int i) { z[i] = max(x[i],c); });
+  time_op("shift_right", [&](int i) { z[i] = shift_right(x[i],y[i]); });
+  time_op("shift_left",  [&](int i) { z[i] = shift_left(x[i],y[i]); });
+  time_op("p->float->p", [&](int i) { z[i] = PackT(Pack<float,N>(x[i])); });
+  time_op("p<p",         [&](int i) { m[i] = x[i] < y[i]; });
+  time_op("p>=s",        [&](int i) { m[i] = x[i] >= c; });
+  time_op("m&&m",        [&](int i) { m[i] = m[i] && (x[i] < c); });
+  time_op("!m",          [&](int i) { m[i] = !m[i]; });
+  time_op("m.any",       [&](int i) { s[i] = m[i].any(); });
+  time_op("m.all",       [&](int i) { s[i] = m[i].all(); });
+  time_op("m.count",     [&](int i) { s[i] = m[i].count(); });
+  time_op("isnan",       [&](int i) { m[i] = isnan(x[i]); });
+  time_op("set(m,s)",    [&](int i) { z[i].set(m[i],c); });
+  time_op("set(m,p,p)",  [&](int i) { z[i].set(m[i],x[i],y[i]); });
+  time_op("update",      [&](int i) { z[i].update(x[i],c,Real(0.5)); });
+  time_op("update(m)",   [&](int i) { z[i].update(m[i],x[i],c,Real(0.5)); });
+  time_op("add(m,p,p)",  [&](int i) { z[i].add(m[i],x[i],y[i],c); });
+  time_op("fma(p,p,p)",  [&](int i) { z[i] = fma(x[i],y[i],z[i]); });
+  time_op("horner(p,5)", [&](int i) { z[i] = horner(x[i],Real(1),Real(0.5),Real(0.25),Real(0.125),Real(0.0625)); });
+
+  // ekat_pack_where.hpp
+  time_op("where+=p",    [&](int i) { where(m[i],z[i]) += x[i]; });
+  time_op("where*=s",    [&](int i) { where(m[i],z[i]) *= c; });
+  time_op("where/=p",    [&](int i) { where(m[i],z[i]) /= y[i]; });
+
+  // ekat_pack_math.hpp
+  time_op("abs",         [&](int i) { z[i] = abs(x[i]); });
+  time_op("exp",         [&](int i) { z[i] = exp(x[i]); });
+  time_op("expm1",       [&](int i) { z[i] = expm1(x[i]); });
+  time_op("log",         [&](int i) { z[i] = log(x[i]); });
+  time_op("log10",       [&](int i) { z[i] = log10(x[i]); });
+  time_op("tgamma",      [&](int i) { z[i] = tgamma(x[i]); });
+  time_op("sqrt",        [&](int i) { z[i] = sqrt(x[i]); });
+  time_op("cbrt",        [&](int i) { z[i] = cbrt(x[i]); });
+  time_op("tanh",        [&](int i) { z[i] = tanh(x[i]); });
+  time_op("erf",         [&](int i) { z[i] = erf(x[i]); });
+  time_op("pow(p,s)",    [&](int i) { z[i] = pow(x[i],c); });
+  time_op("pow(p,p)",    [&](int i) { z[i] = pow(x[i],y[i]); });
+  time_op("square",      [&](int i) { z[i] = square(x[i]); });
+  time_op("cube",        [&](int i) { z[i] = cube(x[i]); });
+  time_op("min(p)",      [&](int i) { s[i] = reduce_min<false>(x[i]); });
+  time_op("min(p)(s)",   [&](int i) { s[i] = reduce_min<true>(x[i]); });
+  time_op("max(p)",      [&](int i) { s[i] = reduce_max<false>(x[i]); });
+  time_op("max(m,s,p)",  [&](int i) { s[i] = max(m[i],c,x[i]); });
+  time_op("reduce_sum",  [&](int i) { s[i] = reduce_sum<false>(x[i]); });
+  time_op("reduce_sum(s)",[&](int i) { s[i] = reduce_sum<true>(x[i]); });
+  time_op("reduce_sum(m)",[&](int i) { s[i] = reduce_sum<false>(m[i],x[i]); });
+  time_op("reduce_prod", [&](int i) { s[i] = reduce_prod<false>(x[i]); });
+  time_op("reduce_sum(f)",[&](int i) { s[i] = reduce_sum<Real,false>(Pack<float,N>(x[i])); });
+}
+
+} // namespace perf
+} // namespace test
+} // namespace ekat
+
+int main (int argc, char** argv) {
+  ekat::test::perf::Input in;
+  if (not in.parse(argc,argv)) {
+    std::cout << "Usage: " << argv[0] << " [-n|--npacks N] [-r|--nrep R]\n";
+    return 1;
+  }
+
+  ekat::test::perf::run<Real,EKAT_TEST_PACK_SIZE>(in);
+
+  return 0;
+}
@@ -0,0 +1,108 @@
+#include <catch2/catch.hpp>
+
+#include "ekat_pack_tuner.hpp"
+#include "ekat_pack.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <map>
+#include <thread>
+
+namespace {
+
+// A kernel that is (by far) fastest for pack size Best, and records how
+// many times each pack size ran
+template<int Best>
+struct SleepyKernel {
+  std::map<int,int>& count;
+
+  template<int N>
+  void operator() (std::integral_constant<int,N>) const {
+    ++count[N];
+    if (N!=Best) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+  }
+};
+
+TEST_CASE("pack_size_tuner", "ekat::pack") {
+  using namespace ekat;
+
+  std::map<int,int> count;
+  const std::vector<long long> shape = {128,72};
+
+  SECTION ("in_memory") {
+    PackSizeTuner tuner;
+    tuner.set_num_reps(2);
+    REQUIRE (not tuner.has_decision("k",shape));
+
+    // First call times all candidates (1 warmup + 2 timed runs each)...
+    REQUIRE (tuner.run("k",shape,SleepyKernel<4>{count})==4);
+    for (int n : {1,2,4,8,16}) {
+      REQUIRE (count[n]==3);
+    }
+    REQUIRE (tuner.has_decision("k",shape));
+    REQUIRE (tuner.get_decision("k",shape).pack_size==4);
+    REQUIRE (not tuner.get_decision("k",shape).from_cache);
+
+    // ... while later calls only run the winner
+    count.clear();
+    REQUIRE (tuner.run("k",shape,SleepyKernel<4>{count})==4);
+    REQUIRE (count.size()==1);
+    REQUIRE (count[4]==1);
+
+    // A different shape or name is a different decision
+    REQUIRE (tuner.run("k",{256,72},SleepyKernel<8>{count})==8);
+    REQUIRE (tuner.run("k2",shape,SleepyKernel<2>{count})==2);
+    REQUIRE (tuner.decisions().size()==3);
+
+    // Custom set of candidates. If the previous decision is not one of
+    // them, the kernel is tuned again
+    count.clear();
+    REQUIRE (tuner.run("k",shape,SleepyKernel<8>{count},std::integer_sequence<int,1,8>{})==8);
+    REQUIRE (count.size()==2);
+
+    // The pack size is a compile-time constant in the kernel
+    const int n = tuner.run("k3",shape,[&](auto ps) {
+      constexpr int N = decltype(ps)::value;
+      Pack<double,N> p(1);
+      count[N] = static_cast<int>(reduce_sum(p));
+    });
+    REQUIRE (count[n]==n);
+  }
+
+  SECTION ("cache_file") {
+    const std::string cache = "pack_tuner_test.cache";
+    std::remove(cache.c_str());
+    {
+      PackSizeTuner tuner(cache);
+      tuner.set_num_reps(1);
+      REQUIRE (tuner.run("k",shape,SleepyKernel<16>{count})==16);
+    }
+
+    // A new tuner (e.g., in a later run) reads the decision, and does not time anything
+    count.clear();
+    PackSizeTuner tuner(cache);
+    REQUIRE (tuner.has_decision("k",shape));
+    REQUIRE (tuner.get_decision("k",shape).from_cache);
+    REQUIRE (tuner.run("k",shape,SleepyKernel<16>{count})==16);
+    REQUIRE (count.size()==1);
+    REQUIRE (count[16]==1);
+
+    // clear only forgets in-memory decisions
+    tuner.clear();
+    REQUIRE (not tuner.has_decision("k",shape));
+    REQUIRE (PackSizeTuner(cache).has_decision("k",shape));
+
+    std::remove(cache.c_str());
+  }
+
+  SECTION ("keys") {
+    // Keys must be single tokens, for the cache file
+    const auto key = PackSizeTuner::make_key("my kernel",{1,2,3});
+    REQUIRE (key.find(' ')==std::string::npos);
+    REQUIRE (key.find("|1,2,3")!=std::string::npos);
+  }
+}
+
+} // anonymous namespace
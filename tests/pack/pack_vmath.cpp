@@ -0,0 +1,273 @@
+#include "catch2/catch.hpp"
+
+#include "ekat_pack.hpp"
+#include "ekat_pack_math.hpp"
+#include "ekat_test_config.h"
+
+#include <cfloat>
+#include <cmath>
+#include <limits>
+#include <random>
+
+namespace {
+
+using ekat::vmath::Accuracy;
+using LD = long double;
+
+// Max error (in ulps) we allow for each accuracy level. The measured max errors
+// of the double kernels are ~1.3 ulps (Accurate) and ~2.6 ulps (Fast).
+// The float kernels are the double ones, rounded to float.
+template<Accuracy A, typename T>
+double max_ulps () {
+  // If long double is the same as double, the reference itself can be
+  // off by up to ~1 ulp (or more, for some libm's tanh).
+  constexpr double ref_err = std::is_same<T,float>::value or LDBL_MANT_DIG>53 ? 0 : 2;
+  if (std::is_same<T,float>::value) {
+    return 1;
+  }
+  return (A==Accuracy::Accurate ? 1.5 : 3) + ref_err;
+}
+
+// Error of x wrt ref, in ulps of T
+template<typename T>
+double ulp_err (const T x, const LD ref) {
+  if (std::isnan(ref)) {
+    return std::isnan(x) ? 0 : std::numeric_limits<double>::infinity();
+  }
+  if (std::isinf(static_cast<T>(ref))) {
+    return x==static_cast<T>(ref) ? 0 : std::numeric_limits<double>::infinity();
+  }
+  int e;
+  std::frexp(static_cast<T>(ref),&e);
+  const int p = std::numeric_limits<T>::digits;
+  const int emin = std::numeric_limits<T>::min_exponent;
+  const LD ulp = std::ldexp(LD(1),std::max(e,emin)-p);
+  return static_cast<double>(std::fabs(static_cast<LD>(x)-ref)/ulp);
+}
+
+// Check fcn f vs ref over n random points in [lo,hi] (log-uniform if log_scale)
+template<Accuracy A, typename T, typename F, typename R>
+void check_accuracy (const char* name, const F& f, const R& ref,
+                     const double lo, const double hi, const bool log_scale) {
+  std::mt19937_64 engine(1234);
+  std::uniform_real_distribution<double> u(0,1);
+  double max_err = 0, x_max = 0;
+  for (int i = 0; i < 20000; ++i) {
+    double x;
+    if (log_scale) {
+      // Sample magnitude log-uniformly in [lo,hi] (lo>0), and flip sign if needed
+      x = std::exp(std::log(lo) + u(engine)*(std::log(hi)-std::log(lo)));
+    } else {
+      x = lo + (hi-lo)*u(engine);
+    }
+    const T xt = static_cast<T>(x);
+    const double err = ulp_err<T>(f(xt),ref(static_cast<LD>(xt)));
+    if (err>max_err) {
+      max_err = err;
+      x_max = xt;
+    }
+  }
+  INFO ("fcn: " << name << ", sizeof(T): " << sizeof(T)
+        << ", accuracy: " << (A==Accuracy::Accurate ? "accurate" : "fast")
+        << ", range: [" << lo << "," << hi << "]"
+        << ", max err: " << max_err << " ulps at x=" << x_max);
+  REQUIRE (max_err <= max_ulps<A,T>());
+}
+
+template<Accuracy A, typename T>
+void run_accuracy () {
+  namespace vm = ekat::vmath;
+
+#define check_unary(fn, lo, hi, log_scale)                              \
+  check_accuracy<A,T>(#fn, [](const T x) { return vm::fn<A>(x); },       \
+                      [](const LD x) { return std::fn(x); }, lo, hi, log_scale);
+
+  constexpr bool is_dp = std::is_same<T,double>::value;
+  const double tiny = is_dp ? 1e-300 : 1e-37;
+  const double huge = is_dp ? 1e300 : 1e37;
+  const double exp_max = is_dp ? 709.7 : 88.7;
+  const double exp_min = is_dp ? -745 : -103;
+
+  check_unary(exp,   exp_min, exp_max, false);
+  check_unary(exp,   -1, 1, false);
+  check_unary(expm1, -40, exp_max, false);
+  check_unary(expm1, -1, 1, false);
+  check_unary(expm1, tiny, 1, true);
+  check_unary(log,   tiny, huge, true);
+  check_unary(log,   0.5, 2, false);
+  check_unary(log10, tiny, huge, true);
+  check_unary(log10, 0.5, 2, false);
+  check_unary(cbrt,  tiny, huge, true);
+  check_unary(cbrt,  -10, 10, false);
+  check_unary(tanh,  -20, 20, false);
+  check_unary(tanh,  tiny, 1, true);
+  check_unary(erf,   -7, 7, false);
+  check_unary(erf,   tiny, 1, true);
+#undef check_unary
+
+  check_accuracy<A,T>("pow(x,1.7)",
+                      [](const T x) { return vm::pow<A>(x,T(1.7)); },
+                      [](const LD x) { return std::pow(x,static_cast<LD>(T(1.7))); },
+                      is_dp ? 1e-100 : 1e-10, is_dp ? 1e100 : 1e10, true);
+  check_accuracy<A,T>("pow(1.37,y)",
+                      [](const T y) { return vm::pow<A>(T(1.37),y); },
+                      [](const LD y) { return std::pow(static_cast<LD>(T(1.37)),y); },
+                      is_dp ? -2000 : -250, is_dp ? 2000 : 250, false);
+  check_accuracy<A,T>("pow(x,3e5)",
+                      [](const T x) { return vm::pow<A>(x,T(3e5)); },
+                      [](const LD x) { return std::pow(x,static_cast<LD>(T(3e5))); },
+                      0.999, 1.001, false);
+}
+
+template<Accuracy A, typename T>
+void run_special_values () {
+  namespace vm = ekat::vmath;
+  using lim = std::numeric_limits<T>;
+  const T inf = lim::infinity();
+  const T nan = lim::quiet_NaN();
+  const T zero = 0;
+
+  // Results must match exactly if they are NaN, inf or zero (including the
+  // sign), and be within the usual tolerance otherwise (e.g., denormals)
+  const auto same = [](const T a, const LD ref) {
+    const T b = static_cast<T>(ref);
+    if (std::isnan(b) or std::isinf(b) or b==0) {
+      return (std::isnan(a) and std::isnan(b)) or
+             (a==b and std::signbit(a)==std::signbit(b));
+    }
+    return ulp_err<T>(a,ref) <= max_ulps<A,T>();
+  };
+
+  // Unary fcns: +-NaN, +-inf, +-0, overflow/underflow, denormals
+  const T special[] = {nan, -nan, inf, -inf, zero, -zero, T(1000), T(-1000),
+                       lim::denorm_min(), -lim::denorm_min(), lim::min(),
+                       lim::max(), -lim::max(), T(1), T(-1)};
+  for (const T x : special) {
+    const LD xl = x;
+    INFO ("x: " << x);
+    REQUIRE (same(vm::exp<A>(x),  std::exp(xl)));
+    REQUIRE (same(vm::expm1<A>(x),std::expm1(xl)));
+    REQUIRE (same(vm::log<A>(x),  std::log(xl)));
+    REQUIRE (same(vm::log10<A>(x),std::log10(xl)));
+    REQUIRE (same(vm::cbrt<A>(x), std::cbrt(xl)));
+    REQUIRE (same(vm::tanh<A>(x), std::tanh(xl)));
+    REQUIRE (same(vm::erf<A>(x),  std::erf(xl)));
+  }
+
+  // The same values in the slots of packs, so that NaN and +-inf also go
+  // through the vectorized kernels, next to finite values
+  using PackT = ekat::Pack<T,EKAT_TEST_PACK_SIZE>;
+  constexpr int nspecial = sizeof(special)/sizeof(T);
+  for (int k = 0; k < nspecial; k += PackT::n) {
+    PackT x;
+    for (int i = 0; i < PackT::n; ++i) {
+      x[i] = special[(k+i) % nspecial];
+    }
+    const PackT e = ekat::exp<A>(x), em1 = ekat::expm1<A>(x), l = ekat::log<A>(x),
+      c = ekat::cbrt<A>(x), th = ekat::tanh<A>(x), p = ekat::pow<A>(x,T(1.5));
+    for (int i = 0; i < PackT::n; ++i) {
+      const LD xl = x[i];
+      INFO ("x: " << x[i]);
+      REQUIRE (same(e[i],   std::exp(xl)));
+      REQUIRE (same(em1[i], std::expm1(xl)));
+      REQUIRE (same(l[i],   std::log(xl)));
+      REQUIRE (same(c[i],   std::cbrt(xl)));
+      REQUIRE (same(th[i],  std::tanh(xl)));
+      REQUIRE (same(p[i],   std::pow(xl,LD(1.5))));
+    }
+  }
+
+  // pow: all the special cases listed in the C standard
+  const T vals[] = {nan, inf, -inf, zero, -zero, T(1), T(-1), T(2), T(-2),
+                    T(0.5), T(-0.5), T(3), T(-3), T(1.5), T(-1.5)};
+  for (const T x : vals) {
+    for (const T y : vals) {
+      INFO ("x: " << x << ", y: " << y);
+      REQUIRE (same(vm::pow<A>(x,y),std::pow(LD(x),LD(y))));
+    }
+  }
+}
+
+template<Accuracy A>
+void run_packs () {
+  using PackT = ekat::Pack<Real,EKAT_TEST_PACK_SIZE>;
+  namespace vm = ekat::vmath;
+
+  // Use volatile inputs, so that the compiler cannot constant-fold the libm
+  // calls (which it does with correct rounding, unlike libm itself)
+  volatile Real x0 = 0.25, y0 = -1.5, c0 = 0.75;
+  PackT x, y;
+  for (int i = 0; i < PackT::n; ++i) {
+    x[i] = x0 + Real(0.7)*i;
+    y[i] = y0 + Real(0.3)*i;
+  }
+  const Real c = c0;
+
+  // The pack fcns must give the same result as the scalar fcn on each slot.
+  // Except for Exact, the compiler may contract a*b+c to fma differently in
+  // the vectorized pack loop and in the scalar code, so allow 1 ulp.
+  const auto same = [](const Real a, const Real b) {
+    return A==Accuracy::Exact ? a==b : ulp_err<Real>(a,b)<=1;
+  };
+#define check_pack_unary(fn)                                  \
+  {                                                           \
+    const PackT z = ekat::fn<A>(x);                           \
+    for (int i = 0; i < PackT::n; ++i) {                      \
+      REQUIRE (same(z[i],vm::fn<A>(x[i])));                   \
+    }                                                         \
+  }
+  check_pack_unary(exp);
+  check_pack_unary(expm1);
+  check_pack_unary(log);
+  check_pack_unary(log10);
+  check_pack_unary(tgamma);
+  check_pack_unary(cbrt);
+  check_pack_unary(tanh);
+  check_pack_unary(erf);
+#undef check_pack_unary
+
+  const PackT ps = ekat::pow<A>(x,c);
+  const PackT sp = ekat::pow<A>(c,y);
+  const PackT pp = ekat::pow<A>(x,y);
+  for (int i = 0; i < PackT::n; ++i) {
+    REQUIRE (same(ps[i],vm::pow<A>(x[i],c)));
+    REQUIRE (same(sp[i],vm::pow<A>(c,y[i])));
+    REQUIRE (same(pp[i],vm::pow<A>(x[i],y[i])));
+  }
+}
+
+TEST_CASE("vmath_accuracy", "ekat::pack") {
+  run_accuracy<Accuracy::Accurate,double>();
+  run_accuracy<Accuracy::Fast,double>();
+  run_accuracy<Accuracy::Accurate,float>();
+  run_accuracy<Accuracy::Fast,float>();
+}
+
+TEST_CASE("vmath_special_values", "ekat::pack") {
+  run_special_values<Accuracy::Accurate,double>();
+  run_special_values<Accuracy::Fast,double>();
+  run_special_values<Accuracy::Accurate,float>();
+  run_special_values<Accuracy::Fast,float>();
+}
+
+TEST_CASE("vmath_packs", "ekat::pack") {
+  run_packs<Accuracy::Exact>();
+  run_packs<Accuracy::Accurate>();
+  run_packs<Accuracy::Fast>();
+
+  // Exact (the default, unless configured otherwise) must be BFB with libm
+  using PackT = ekat::Pack<Real,EKAT_TEST_PACK_SIZE>;
+  volatile Real x0 = 0.25;
+  PackT x;
+  for (int i = 0; i < PackT::n; ++i) {
+    x[i] = x0 + Real(0.7)*i;
+  }
+  const PackT e = ekat::exp<Accuracy::Exact>(x);
+  const PackT p = ekat::pow<Accuracy::Exact>(x,x);
+  for (int i = 0; i < PackT::n; ++i) {
+    REQUIRE (e[i]==std::exp(x[i]));
+    REQUIRE (p[i]==std::pow(x[i],x[i]));
+  }
+}
+
+} // anonymous namespace
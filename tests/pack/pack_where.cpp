@@ -3,6 +3,8 @@
 #include "ekat_pack.hpp"
 #include "ekat_pack_where.hpp"
 
+#include <cmath>
+
 template<typename T, int N>
 void run_tests ()
 {
@@ -147,6 +149,24 @@ void run_tests ()
   prod *= p_at_even;
   REQUIRE (sum==sum_at_even);
   REQUIRE (prod==prod_at_even);
+
+  // Inactive slots must be left exactly untouched, regardless of the rhs there
+  if constexpr (std::is_floating_point<T>::value) {
+    PT z (T(-0.0)), d (T(0));
+    for (int i=0; i<half; ++i) {
+      d[i] = 2;
+    }
+    auto z_masked = where(m,z);
+    z_masked += d;
+    z_masked -= d;
+    z_masked /= d; // d=0 in the inactive slots
+    for (int i=0; i<half; ++i) {
+      REQUIRE (z[i]==0);
+    }
+    for (int i=half; i<N; ++i) {
+      REQUIRE ((z[i]==0 and std::signbit(z[i])));
+    }
+  }
 }
 
 TEST_CASE("where") {